@@ -471,9 +471,10 @@ int App::processConverter(const CommandLineParser::ConverterTask& task)
     case CommandLineParser::ConvertType::ExportScoreMeta:
         ret = converter()->exportScoreMeta(task.inputFile, task.outputFile, stylePath, forceMode);
         break;
-    case CommandLineParser::ConvertType::ExportScoreParts:
-        ret = converter()->exportScoreParts(task.inputFile, task.outputFile, stylePath, forceMode);
-        break;
+    case CommandLineParser::ConvertType::ExportScoreParts: {
+        bool parallelParts = task.params[CommandLineParser::ParamKey::ParallelParts].toBool();
+        ret = converter()->exportScoreParts(task.inputFile, task.outputFile, stylePath, forceMode, parallelParts);
+    } break;
     case CommandLineParser::ConvertType::ExportScorePartsPdf:
         ret = converter()->exportScorePartsPdfs(task.inputFile, task.outputFile, stylePath, forceMode);
         break;
@@ -95,6 +95,7 @@ void CommandLineParser::init()
     m_parser.addOption(QCommandLineOption("highlight-config", "Set highlight to svg, generated from a given score", "highlight-config"));
     m_parser.addOption(QCommandLineOption("score-meta", "Export score metadata to JSON document and print it to stdout"));
     m_parser.addOption(QCommandLineOption("score-parts", "Generate parts data for the given score and save them to separate mscz files"));
+    m_parser.addOption(QCommandLineOption("parallel-parts", "Use with '--score-parts', pack the parts into mscz files concurrently"));
     m_parser.addOption(QCommandLineOption("score-parts-pdf",
                                           "Generate parts data for the given score and export the data to a single JSON file, print it to stdout"));
     m_parser.addOption(QCommandLineOption("score-transpose",
@@ -315,6 +316,10 @@ void CommandLineParser::parse(int argc, char** argv)
         m_runMode = IApplication::RunMode::ConsoleApp;
         m_converterTask.type = ConvertType::ExportScoreParts;
         m_converterTask.inputFile = scorefiles[0];
+
+        if (m_parser.isSet("parallel-parts")) {
+            m_converterTask.params[CommandLineParser::ParamKey::ParallelParts] = true;
+        }
     }
 
     if (m_parser.isSet("score-parts-pdf")) {
@@ -45,7 +45,7 @@ public:
     virtual Ret exportScoreMeta(const io::path_t& in, const io::path_t& out,
                                 const io::path_t& stylePath = io::path_t(), bool forceMode = false) = 0;
     virtual Ret exportScoreParts(const io::path_t& in, const io::path_t& out,
-                                 const io::path_t& stylePath = io::path_t(), bool forceMode = false) = 0;
+                                 const io::path_t& stylePath = io::path_t(), bool forceMode = false, bool parallelParts = false) = 0;
     virtual Ret exportScorePartsPdfs(const io::path_t& in, const io::path_t& out,
                                      const io::path_t& stylePath = io::path_t(), bool forceMode = false) = 0;
     virtual Ret exportScoreTranspose(const io::path_t& in, const io::path_t& out, const std::string& optionsJson,
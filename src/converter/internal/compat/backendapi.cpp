@@ -31,6 +31,7 @@
 #include <QRandomGenerator>
 
 #include "io/buffer.h"
+#include "concurrency/taskscheduler.h"
 
 #include "engraving/compat/scoreaccess.h"
 #include "engraving/infrastructure/mscwriter.h"
@@ -122,7 +123,8 @@ Ret BackendApi::exportScoreMeta(const io::path_t& in, const io::path_t& out, con
     return result ? make_ret(Ret::Code::Ok) : make_ret(Ret::Code::InternalError);
 }
 
-Ret BackendApi::exportScoreParts(const io::path_t& in, const io::path_t& out, const io::path_t& stylePath, bool forceMode)
+Ret BackendApi::exportScoreParts(const io::path_t& in, const io::path_t& out, const io::path_t& stylePath, bool forceMode,
+                                 bool parallelParts)
 {
     TRACEFUNC
 
@@ -134,7 +136,7 @@ Ret BackendApi::exportScoreParts(const io::path_t& in, const io::path_t& out, co
     QFile outputFile;
     openOutputFile(outputFile, out);
 
-    Ret ret = doExportScoreParts(prj.val->masterNotation(), outputFile);
+    Ret ret = doExportScoreParts(prj.val->masterNotation(), outputFile, parallelParts);
 
     outputFile.close();
 
@@ -527,7 +529,7 @@ mu::RetVal<QByteArray> BackendApi::processWriter(const std::string& writerName,
     return result;
 }
 
-Ret BackendApi::doExportScoreParts(const IMasterNotationPtr masterNotation, QIODevice& destinationDevice)
+Ret BackendApi::doExportScoreParts(const IMasterNotationPtr masterNotation, QIODevice& destinationDevice, bool parallelParts)
 {
     QJsonArray partsObjList;
     QJsonArray partsMetaList;
@@ -535,8 +537,32 @@ Ret BackendApi::doExportScoreParts(const IMasterNotationPtr masterNotation, QIOD
 
     ExcerptNotationList excerpts = allExcerpts(masterNotation);
 
-    for (IExcerptNotationPtr excerpt : excerpts) {
-        mu::engraving::Score* part = excerpt->notation()->elements()->msScore();
+    auto partFileName = [](const mu::engraving::Score* part) {
+        return io::escapeFileName(part->name().toStdString()).toStdString() + ".mscz";
+    };
+
+    //! NOTE Reading the parts (including their layout and thumbnails) touches data shared
+    //! with the master score, so it is done here one by one; packing the read data into
+    //! mscz files (compression, base64) is independent per part and, if asked, runs on the worker pool.
+    //! Every part is packed exactly as in the serial path, so the output is identical
+    std::vector<std::future<RetVal<QByteArray> > > partsBin;
+
+    if (parallelParts) {
+        partsBin.reserve(excerpts.size());
+
+        for (IExcerptNotationPtr excerpt : excerpts) {
+            mu::engraving::Score* part = excerpt->notation()->elements()->msScore();
+            std::string fileName = partFileName(part);
+            std::shared_ptr<MscSaver::PartData> partData = std::make_shared<MscSaver::PartData>(MscSaver().preparePart(part));
+
+            partsBin.push_back(TaskScheduler::instance()->submit([partData, fileName]() {
+                return scorePartJson(*partData, fileName);
+            }));
+        }
+    }
+
+    for (size_t i = 0; i < excerpts.size(); ++i) {
+        mu::engraving::Score* part = excerpts[i]->notation()->elements()->msScore();
         std::map<String, String> partMetaTags = part->metaTags();
 
         QJsonValue partTitle(part->name());
@@ -550,8 +576,8 @@ Ret BackendApi::doExportScoreParts(const IMasterNotationPtr masterNotation, QIOD
         QJsonValue partMetaObj = QJsonObject::fromVariantMap(meta);
         partsMetaList << partMetaObj;
 
-        std::string fileName = io::escapeFileName(part->name().toStdString()).toStdString() + ".mscz";
-        QJsonValue partObj(QString::fromLatin1(scorePartJson(part, fileName).val));
+        RetVal<QByteArray> partBin = parallelParts ? partsBin[i].get() : scorePartJson(part, partFileName(part));
+        QJsonValue partObj(QString::fromLatin1(partBin.val));
         partsObjList << partObj;
     }
 
@@ -632,6 +658,11 @@ Ret BackendApi::doExportScoreTranspose(const INotationPtr notation, BackendJsonW
 }
 
 RetVal<QByteArray> BackendApi::scorePartJson(mu::engraving::Score* score, const std::string& fileName)
+{
+    return scorePartJson(MscSaver().preparePart(score), fileName);
+}
+
+RetVal<QByteArray> BackendApi::scorePartJson(const MscSaver::PartData& partData, const std::string& fileName)
 {
     ByteArray scoreData;
     Buffer buf(&scoreData);
@@ -644,7 +675,7 @@ RetVal<QByteArray> BackendApi::scorePartJson(mu::engraving::Score* score, const
     MscWriter mscWriter(params);
     mscWriter.open();
 
-    bool ok = MscSaver().exportPart(score, mscWriter);
+    bool ok = MscSaver::writePart(partData, mscWriter);
     if (!ok) {
         LOGW() << "Error save mscz file";
     }
@@ -30,6 +30,7 @@
 #include "io/ifilesystem.h"
 #include "project/iprojectcreator.h"
 #include "project/inotationwritersregister.h"
+#include "engraving/rw/mscsaver.h"
 
 namespace mu::engraving {
 class Score;
@@ -47,7 +48,8 @@ public:
     static Ret exportScoreMedia(const io::path_t& in, const io::path_t& out, const io::path_t& highlightConfigPath,
                                 const io::path_t& stylePath = "", bool forceMode = false);
     static Ret exportScoreMeta(const io::path_t& in, const io::path_t& out, const io::path_t& stylePath, bool forceMode = false);
-    static Ret exportScoreParts(const io::path_t& in, const io::path_t& out, const io::path_t& stylePath, bool forceMode = false);
+    static Ret exportScoreParts(const io::path_t& in, const io::path_t& out, const io::path_t& stylePath, bool forceMode = false,
+                                bool parallelParts = false);
     static Ret exportScorePartsPdfs(const io::path_t& in, const io::path_t& out, const io::path_t& stylePath, bool forceMode = false);
     static Ret exportScoreTranspose(const io::path_t& in, const io::path_t& out, const std::string& optionsJson,
                                     const io::path_t& stylePath, bool forceMode = false);
@@ -81,12 +83,13 @@ private:
     static mu::RetVal<QByteArray> processWriter(const std::string& writerName, const notation::INotationPtrList notations,
                                                 const project::INotationWriter::Options& options);
 
-    static Ret doExportScoreParts(const notation::IMasterNotationPtr notation, QIODevice& destinationDevice);
+    static Ret doExportScoreParts(const notation::IMasterNotationPtr notation, QIODevice& destinationDevice, bool parallelParts = false);
     static Ret doExportScorePartsPdfs(const notation::IMasterNotationPtr notation, QIODevice& destinationDevice,
                                       const std::string& scoreFileName);
     static Ret doExportScoreTranspose(const notation::INotationPtr notation, BackendJsonWriter& jsonWriter, bool addSeparator = false);
 
     static RetVal<QByteArray> scorePartJson(mu::engraving::Score* score, const std::string& fileName);
+    static RetVal<QByteArray> scorePartJson(const engraving::MscSaver::PartData& partData, const std::string& fileName);
 
     static RetVal<notation::TransposeOptions> parseTransposeOptions(const std::string& optionsJson);
     static Ret applyTranspose(const notation::INotationPtr notation, const std::string& optionsJson);
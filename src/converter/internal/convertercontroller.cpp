@@ -311,11 +311,11 @@ mu::Ret ConverterController::exportScoreMeta(const mu::io::path_t& in, const mu:
 }
 
 mu::Ret ConverterController::exportScoreParts(const mu::io::path_t& in, const mu::io::path_t& out, const io::path_t& stylePath,
-                                              bool forceMode)
+                                              bool forceMode, bool parallelParts)
 {
     TRACEFUNC;
 
-    return BackendApi::exportScoreParts(in, out, stylePath, forceMode);
+    return BackendApi::exportScoreParts(in, out, stylePath, forceMode, parallelParts);
 }
 
 mu::Ret ConverterController::exportScorePartsPdfs(const mu::io::path_t& in, const mu::io::path_t& out, const io::path_t& stylePath,
@@ -57,7 +57,7 @@ public:
     Ret exportScoreMeta(const io::path_t& in, const io::path_t& out, const io::path_t& stylePath = io::path_t(),
                         bool forceMode = false) override;
     Ret exportScoreParts(const io::path_t& in, const io::path_t& out, const io::path_t& stylePath = io::path_t(),
-                         bool forceMode = false) override;
+                         bool forceMode = false, bool parallelParts = false) override;
     Ret exportScorePartsPdfs(const io::path_t& in, const io::path_t& out,
                              const io::path_t& stylePath = io::path_t(), bool forceMode = false) override;
     Ret exportScoreTranspose(const io::path_t& in, const io::path_t& out, const std::string& optionsJson,
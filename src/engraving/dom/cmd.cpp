@@ -278,6 +278,18 @@ void Score::startCmd()
 
     MScore::setError(MsError::MS_NO_ERROR);
 
+    //! NOTE The deferred excerpts are linked to the elements of the master score as they were read,
+    //! so they must be read before anything is changed
+    if (masterScore()->hasDeferredExcerpts()) {
+        masterScore()->loadDeferredExcerpts();
+    }
+
+    //! NOTE A command may use the position of any measure (e.g. a palette drop on a range),
+    //! so a progressive layout has to reach the end of the score first
+    if (!isLayoutComplete()) {
+        layoutNextPages(0);
+    }
+
     cmdState().reset();
 
     // Start collecting low-level undo operations for a
@@ -329,6 +329,8 @@ set(DOM_SRC
     ${CMAKE_CURRENT_LIST_DIR}/textbase.h
     ${CMAKE_CURRENT_LIST_DIR}/textedit.cpp
     ${CMAKE_CURRENT_LIST_DIR}/textedit.h
+    ${CMAKE_CURRENT_LIST_DIR}/textmetricscache.cpp
+    ${CMAKE_CURRENT_LIST_DIR}/textmetricscache.h
     ${CMAKE_CURRENT_LIST_DIR}/textline.cpp
     ${CMAKE_CURRENT_LIST_DIR}/textline.h
     ${CMAKE_CURRENT_LIST_DIR}/textlinebase.cpp
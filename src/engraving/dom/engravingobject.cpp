@@ -706,28 +706,33 @@ bool EngravingObject::isSLineSegment() const
 
 bool EngravingObject::isTextBase() const
 {
-    return type() == ElementType::TEXT
-           || type() == ElementType::LYRICS
-           || type() == ElementType::DYNAMIC
-           || type() == ElementType::EXPRESSION
-           || type() == ElementType::FINGERING
-           || type() == ElementType::HARMONY
-           || type() == ElementType::MARKER
-           || type() == ElementType::JUMP
-           || type() == ElementType::STAFF_TEXT
-           || type() == ElementType::SYSTEM_TEXT
-           || type() == ElementType::TRIPLET_FEEL
-           || type() == ElementType::PLAYTECH_ANNOTATION
-           || type() == ElementType::CAPO
-           || type() == ElementType::REHEARSAL_MARK
-           || type() == ElementType::INSTRUMENT_CHANGE
-           || type() == ElementType::FIGURED_BASS
-           || type() == ElementType::TEMPO_TEXT
-           || type() == ElementType::INSTRUMENT_NAME
-           || type() == ElementType::MEASURE_NUMBER
-           || type() == ElementType::MMREST_RANGE
-           || type() == ElementType::STICKING
-           || type() == ElementType::HARP_DIAGRAM
+    return isTextBaseType(type());
+}
+
+bool EngravingObject::isTextBaseType(ElementType type)
+{
+    return type == ElementType::TEXT
+           || type == ElementType::LYRICS
+           || type == ElementType::DYNAMIC
+           || type == ElementType::EXPRESSION
+           || type == ElementType::FINGERING
+           || type == ElementType::HARMONY
+           || type == ElementType::MARKER
+           || type == ElementType::JUMP
+           || type == ElementType::STAFF_TEXT
+           || type == ElementType::SYSTEM_TEXT
+           || type == ElementType::TRIPLET_FEEL
+           || type == ElementType::PLAYTECH_ANNOTATION
+           || type == ElementType::CAPO
+           || type == ElementType::REHEARSAL_MARK
+           || type == ElementType::INSTRUMENT_CHANGE
+           || type == ElementType::FIGURED_BASS
+           || type == ElementType::TEMPO_TEXT
+           || type == ElementType::INSTRUMENT_NAME
+           || type == ElementType::MEASURE_NUMBER
+           || type == ElementType::MMREST_RANGE
+           || type == ElementType::STICKING
+           || type == ElementType::HARP_DIAGRAM
     ;
 }
 
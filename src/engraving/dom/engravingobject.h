@@ -443,6 +443,7 @@ public:
     bool isVBoxBase() const { return isVBox() || isTBox() || isFBox(); }
     bool isMeasureBase() const { return isMeasure() || isBox(); }
     bool isTextBase() const;
+    static bool isTextBaseType(ElementType type);
     bool isTextLineBaseSegment() const
     {
         return isHairpinSegment()
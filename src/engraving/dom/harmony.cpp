@@ -26,7 +26,6 @@
 #include "translation.h"
 #include "types/translatablestring.h"
 
-#include "draw/fontmetrics.h"
 #include "draw/types/brush.h"
 #include "draw/types/pen.h"
 
@@ -41,6 +40,7 @@
 #include "score.h"
 #include "segment.h"
 #include "staff.h"
+#include "textmetricscache.h"
 #include "utils.h"
 
 #include "log.h"
@@ -1300,7 +1300,7 @@ TextSegment::TextSegment(const String& s, const mu::draw::Font& f, double x, dou
 
 double TextSegment::width() const
 {
-    return mu::draw::FontMetrics::width(m_font, text);
+    return TextMetricsCache::textMetrics(m_font, text).width;
 }
 
 //---------------------------------------------------------
@@ -1309,7 +1309,7 @@ double TextSegment::width() const
 
 RectF TextSegment::boundingRect() const
 {
-    return mu::draw::FontMetrics::boundingRect(m_font, text);
+    return TextMetricsCache::textMetrics(m_font, text).boundingRect;
 }
 
 //---------------------------------------------------------
@@ -1318,7 +1318,7 @@ RectF TextSegment::boundingRect() const
 
 RectF TextSegment::tightBoundingRect() const
 {
-    return mu::draw::FontMetrics::tightBoundingRect(m_font, text);
+    return TextMetricsCache::textMetrics(m_font, text).tightBoundingRect;
 }
 
 //---------------------------------------------------------
@@ -107,6 +107,10 @@ MasterScore::~MasterScore()
     delete _tempomap;
     delete _undoStack;
     DeleteAll(_excerpts);
+
+    for (auto& deferred : _deferredExcerpts) {
+        delete deferred.first;
+    }
 }
 
 //---------------------------------------------------------
@@ -229,6 +233,84 @@ void MasterScore::addExcerpt(Excerpt* ex, size_t index)
     setExcerptsChanged(true);
 }
 
+//---------------------------------------------------------
+//   addDeferredExcerpt
+//---------------------------------------------------------
+
+void MasterScore::addDeferredExcerpt(Excerpt* ex, const ExcerptLoader& loader)
+{
+    _deferredExcerpts.push_back({ ex, loader });
+}
+
+//---------------------------------------------------------
+//   deferredExcerptNames
+//---------------------------------------------------------
+
+std::vector<String> MasterScore::deferredExcerptNames() const
+{
+    std::vector<String> names;
+    names.reserve(_deferredExcerpts.size());
+
+    for (const auto& deferred : _deferredExcerpts) {
+        names.push_back(deferred.first->name());
+    }
+
+    return names;
+}
+
+//---------------------------------------------------------
+//   loadDeferredExcerpts
+//    read the deferred excerpts and add them in their original order,
+//    the excerpts changed state is kept as is
+//    an excerpt that could not be read is deleted,
+//    its error is returned now and on every later call
+//---------------------------------------------------------
+
+Ret MasterScore::loadDeferredExcerpts()
+{
+    if (_deferredExcerpts.empty()) {
+        return _deferredExcerptsRet;
+    }
+
+    TRACEFUNC;
+
+    auto deferredExcerpts = std::move(_deferredExcerpts);
+    _deferredExcerpts.clear();
+
+    const bool excerptsChanged = this->excerptsChanged();
+
+    for (auto& deferred : deferredExcerpts) {
+        Excerpt* ex = deferred.first;
+        const String name = ex->name();
+
+        Ret ret = deferred.second(ex);
+        if (!ret) {
+            LOGE() << "failed to read excerpt: " << name << ", err: " << ret.toString();
+
+            // also deletes the part score, which unlinks what was already read from the master score
+            delete ex;
+
+            if (_deferredExcerptsRet) {
+                _deferredExcerptsRet = ret;
+            }
+            continue;
+        }
+
+        addExcerpt(ex);
+
+        // same as the setup of the scores of a loaded project
+        Score* partScore = ex->excerptScore();
+        partScore->setPlaylistDirty();
+        partScore->addLayoutFlags(LayoutFlag::FIX_PITCH_VELO);
+        partScore->setLayoutAll();
+    }
+
+    rebuildExcerptsMidiMapping();
+    setExcerptsChanged(excerptsChanged);
+
+    return _deferredExcerptsRet;
+}
+
 //---------------------------------------------------------
 //   removeExcerpt
 //---------------------------------------------------------
@@ -22,6 +22,8 @@
 #ifndef MU_ENGRAVING_MASTERSCORE_H
 #define MU_ENGRAVING_MASTERSCORE_H
 
+#include <functional>
+
 #include "infrastructure/ifileinfoprovider.h"
 
 #include "instrument.h"
@@ -82,6 +84,8 @@ class MasterScore : public Score
     bool _expandRepeats = true;
     bool _playlistDirty = true;
     std::vector<Excerpt*> _excerpts;
+    std::vector<std::pair<Excerpt*, std::function<Ret(Excerpt*)> > > _deferredExcerpts;
+    Ret _deferredExcerptsRet = make_ok();
     std::vector<PartChannelSettingsLink> _playbackSettingsLinks;
     Score* _playbackScore = nullptr;
     async::Channel<ScoreChangesRange> m_changesRangeChannel;
@@ -157,6 +161,15 @@ public:
 
     std::vector<Excerpt*>& excerpts() { return _excerpts; }
     const std::vector<Excerpt*>& excerpts() const { return _excerpts; }
+
+    //! NOTE Excerpts of a loaded score that are not read yet, see MscLoader.
+    //! They are read and added to excerpts() by loadDeferredExcerpts(), at the latest before the first command.
+    //! An excerpt that can't be read is dropped, and the error is kept, so that saving doesn't lose the part silently
+    using ExcerptLoader = std::function<Ret (Excerpt*)>;
+    bool hasDeferredExcerpts() const { return !_deferredExcerpts.empty(); }
+    std::vector<String> deferredExcerptNames() const;
+    void addDeferredExcerpt(Excerpt*, const ExcerptLoader& loader);
+    Ret loadDeferredExcerpts();
     //   QQueue<MidiInputEvent>* midiInputQueue() override { return &_midiInputQueue; }
     std::list<MidiInputEvent>& activeMidiPitches() override { return _activeMidiPitches; }
 
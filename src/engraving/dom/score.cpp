@@ -147,6 +147,7 @@ Score::Score()
     m_masterScore = 0;
 
     m_engravingFont = engravingFonts()->fontByName("Leland");
+    m_layoutOptions.isParallelLayout = configuration()->isParallelLayoutEnabled();
 
     m_fileDivision = Constants::DIVISION;
     m_style = DefaultStyle::defaultStyle();
@@ -1313,6 +1314,7 @@ void Score::spatiumChanged(double oldValue, double newValue)
     }
     m_layoutOptions.noteHeadWidth = m_engravingFont->width(SymId::noteheadBlack, newValue / SPATIUM20);
     createPaddingTable();
+    m_layoutCache.reset();
 }
 
 //---------------------------------------------------------
@@ -1345,6 +1347,7 @@ void Score::styleChanged()
         }
     }
     createPaddingTable();
+    m_layoutCache.reset();
     setLayoutAll();
 }
 
@@ -5539,8 +5542,16 @@ void Score::doLayoutRange(const Fraction& st, const Fraction& et)
 {
     TRACEFUNC;
 
-    m_engravingFont = engravingFonts()->fontByName(style().value(Sid::MusicalSymbolFont).value<String>().toStdString());
-    m_layoutOptions.noteHeadWidth = m_engravingFont->width(SymId::noteheadBlack, style().spatium() / SPATIUM20);
+    // the font lookup and the notehead width are only redone when the font or the spatium change
+    const String fontName = style().styleSt(Sid::MusicalSymbolFont);
+    const double spatium = style().spatium();
+    if (!m_engravingFont || fontName != m_layoutCache.engravingFontName || spatium != m_layoutCache.spatium) {
+        m_engravingFont = engravingFonts()->fontByName(fontName.toStdString());
+        m_layoutOptions.noteHeadWidth = m_engravingFont->width(SymId::noteheadBlack, spatium / SPATIUM20);
+        m_layoutCache.engravingFontName = fontName;
+        m_layoutCache.spatium = spatium;
+        m_layoutCache.segmentDistances.clear();
+    }
 
     if (this->cmdState().layoutFlags & LayoutFlag::REBUILD_MIDI_MAPPING) {
         if (this->isMaster()) {
@@ -5565,6 +5576,52 @@ void Score::doLayoutRange(const Fraction& st, const Fraction& et)
     }
 }
 
+//---------------------------------------------------------
+//   layoutNextPages
+//    Continues a layout that stopped after
+//    LayoutOptions::maxPages pages: lays out at most
+//    maxPages more pages (all of them if 0).
+//    Returns true if there are pages left.
+//---------------------------------------------------------
+
+bool Score::layoutNextPages(size_t maxPages)
+{
+    if (isLayoutComplete()) {
+        return false;
+    }
+
+    // continue after the last system on a page
+    Fraction stick(0, 1);
+    for (auto it = m_pages.rbegin(); it != m_pages.rend(); ++it) {
+        if (!(*it)->systems().empty()) {
+            stick = (*it)->systems().back()->endTick();
+            break;
+        }
+    }
+
+    size_t oldMaxPages = m_layoutOptions.maxPages;
+    m_layoutOptions.maxPages = maxPages;
+    doLayoutRange(stick, Fraction(-1, 1));
+    m_layoutOptions.maxPages = oldMaxPages;
+
+    return !isLayoutComplete();
+}
+
+//---------------------------------------------------------
+//   isLayoutComplete
+//    false if the page view layout stopped before the end
+//    of the score (see layoutNextPages)
+//---------------------------------------------------------
+
+bool Score::isLayoutComplete() const
+{
+    if (!isLayoutMode(LayoutMode::PAGE) && !isLayoutMode(LayoutMode::FLOAT)) {
+        return true;
+    }
+
+    return !m_progressiveLayoutPending;
+}
+
 void Score::createPaddingTable()
 {
     m_paddingTable.createTable(style());
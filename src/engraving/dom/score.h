@@ -42,6 +42,7 @@
 #include "types/constants.h"
 
 #include "rendering/iscorerenderer.h"
+#include "rendering/layoutcache.h"
 #include "rendering/layoutoptions.h"
 #include "rendering/paddingtable.h"
 
@@ -769,6 +770,12 @@ public:
     void doLayout();
     void doLayoutRange(const Fraction& st, const Fraction& et);
 
+    // progressive layout of the page view
+    void setMaxLayoutPages(size_t n) { m_layoutOptions.maxPages = n; }
+    bool layoutNextPages(size_t maxPages);
+    bool isLayoutComplete() const;
+    void setProgressiveLayoutPending(bool v) { m_progressiveLayoutPending = v; }
+
     SynthesizerState& synthesizerState() { return m_synthesizerState; }
     void setSynthesizerState(const SynthesizerState& s);
 
@@ -807,6 +814,9 @@ public:
     void setShowVBox(bool v) { m_layoutOptions.isShowVBox = v; }
     double noteHeadWidth() const { return m_layoutOptions.noteHeadWidth; }
     void setNoteHeadWidth(double n) { m_layoutOptions.noteHeadWidth = n; }
+    void setParallelLayout(bool v) { m_layoutOptions.isParallelLayout = v; }
+
+    LayoutCache& layoutCache() { return m_layoutCache; }
 
     // temporary methods
     bool isLayoutMode(LayoutMode lm) const { return m_layoutOptions.isMode(lm); }
@@ -867,7 +877,11 @@ public:
     void insertTime(const Fraction& tickPos, const Fraction& tickLen);
 
     std::shared_ptr<IEngravingFont> engravingFont() const { return m_engravingFont; }
-    void setEngravingFont(std::shared_ptr<IEngravingFont> f) { m_engravingFont = f; }
+    void setEngravingFont(std::shared_ptr<IEngravingFont> f)
+    {
+        m_engravingFont = f;
+        m_layoutCache.engravingFontName.clear();
+    }
 
     std::list<staff_idx_t> uniqueStaves() const;
 
@@ -1080,6 +1094,9 @@ private:
 
     RootItem* m_rootItem = nullptr;
     LayoutOptions m_layoutOptions;
+    LayoutCache m_layoutCache;
+    // the page view layout stopped after LayoutOptions::maxPages pages, before the end of the score
+    bool m_progressiveLayoutPending = false;
 
     mu::async::Channel<EngravingItem*> m_elementDestroyed;
 
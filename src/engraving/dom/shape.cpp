@@ -22,6 +22,16 @@
 
 #include "shape.h"
 
+#if defined(__SSE2__) || defined(_M_AMD64) || defined(_M_X64)
+#include <emmintrin.h>
+#define SHAPE_SIMD_SSE2
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define SHAPE_SIMD_NEON
+#endif
+
+#include "hashutils.h"
+
 #include "draw/painter.h"
 
 #include "engravingitem.h"
@@ -91,6 +101,31 @@ Shape Shape::translated(const PointF& pt) const
     return s;
 }
 
+//-------------------------------------------------------------------
+//   contentHash
+//    Hash of everything the distance computations depend on:
+//    the rectangles, the kind of items they belong to and the spacing factors.
+//-------------------------------------------------------------------
+
+size_t Shape::contentHash() const
+{
+    std::hash<double> doubleHash;
+    size_t seed = size();
+    hashCombine(seed, doubleHash(_spatium));
+    hashCombine(seed, doubleHash(_squeezeFactor));
+    for (const ShapeElement& r : *this) {
+        hashCombine(seed, doubleHash(r.x()));
+        hashCombine(seed, doubleHash(r.y()));
+        hashCombine(seed, doubleHash(r.width()));
+        hashCombine(seed, doubleHash(r.height()));
+        if (r.toItem) {
+            hashCombine(seed, static_cast<size_t>(r.toItem->type()));
+            hashCombine(seed, r.toItem->track());
+        }
+    }
+    return seed;
+}
+
 //-------------------------------------------------------------------
 //   minHorizontalDistance
 //    a is located right of this shape.
@@ -118,18 +153,21 @@ double Shape::minHorizontalDistance(const Shape& a) const
             double ay1 = r1.top();
             double ay2 = r1.bottom();
             bool intersection = mu::engraving::intersects(ay1, ay2, by1, by2, verticalClearance);
-            double padding = 0;
             KerningType kerningType = KerningType::NON_KERNING;
             if (item1 && item2) {
-                padding = EngravingItem::renderer()->computePadding(item1, item2);
-                padding *= _squeezeFactor;
-                padding = std::max(padding, absoluteMinPadding);
                 kerningType = EngravingItem::renderer()->computeKerning(item1, item2);
             }
             if ((intersection && kerningType != KerningType::ALLOW_COLLISION)
                 || (r1.width() == 0 || r2.width() == 0)  // Temporary hack: shapes of zero-width are assumed to collide with everyghin
                 || (!item1 && item2 && item2->isLyrics())  // Temporary hack: avoids collision with melisma line
                 || kerningType == KerningType::NON_KERNING) {
+                // the padding is only needed for the pairs that count, so it's computed only for them
+                double padding = 0;
+                if (item1 && item2) {
+                    padding = EngravingItem::renderer()->computePadding(item1, item2);
+                    padding *= _squeezeFactor;
+                    padding = std::max(padding, absoluteMinPadding);
+                }
                 dist = std::max(dist, r1.right() - r2.left() + padding);
             }
             if (kerningType == KerningType::KERNING_UNTIL_ORIGIN) { //prepared for future user option, for now always false
@@ -141,6 +179,113 @@ double Shape::minHorizontalDistance(const Shape& a) const
     return dist;
 }
 
+//-------------------------------------------------------------------
+//   VerticalPack
+//    The rectangles of a shape that can take part in a vertical
+//    distance computation (non-zero height and width), unpacked
+//    into separate arrays, so that one rectangle can be compared
+//    against all of them with vector instructions.
+//-------------------------------------------------------------------
+
+struct VerticalPack {
+    std::vector<double> left;
+    std::vector<double> right;
+    std::vector<double> top;
+
+    void pack(const Shape& shape)
+    {
+        left.clear();
+        right.clear();
+        top.clear();
+        for (const RectF& r : shape) {
+            // intersects() is false for zero-width rectangles, they can never count
+            if (r.height() <= 0.0 || r.left() == r.right()) {
+                continue;
+            }
+            left.push_back(r.left());
+            right.push_back(r.right());
+            top.push_back(r.top());
+        }
+    }
+
+    size_t size() const { return top.size(); }
+};
+
+//-------------------------------------------------------------------
+//   maxOverlapDistance
+//    Returns the maximum of dist and (bottom - top[i]) over all packed
+//    rectangles horizontally intersecting the span [x1, x2].
+//    The vector paths compute the same differences and the maximum is
+//    exact, so they give the same result as the scalar one.
+//-------------------------------------------------------------------
+
+static double maxOverlapDistance(const VerticalPack& pack, double x1, double x2, double bottom, double dist)
+{
+    const size_t n = pack.size();
+    const double* left = pack.left.data();
+    const double* right = pack.right.data();
+    const double* top = pack.top.data();
+    size_t i = 0;
+
+#if defined(SHAPE_SIMD_SSE2)
+    __m128d vdist = _mm_set1_pd(dist);
+    const __m128d vx1 = _mm_set1_pd(x1);
+    const __m128d vx2 = _mm_set1_pd(x2);
+    const __m128d vbottom = _mm_set1_pd(bottom);
+    for (; i + 2 <= n; i += 2) {
+        __m128d mask = _mm_and_pd(_mm_cmpgt_pd(vx2, _mm_loadu_pd(left + i)), _mm_cmplt_pd(vx1, _mm_loadu_pd(right + i)));
+        __m128d d = _mm_sub_pd(vbottom, _mm_loadu_pd(top + i));
+        vdist = _mm_max_pd(vdist, _mm_or_pd(_mm_and_pd(mask, d), _mm_andnot_pd(mask, vdist)));
+    }
+    double lanes[2];
+    _mm_storeu_pd(lanes, vdist);
+    dist = std::max(lanes[0], lanes[1]);
+#elif defined(SHAPE_SIMD_NEON)
+    float64x2_t vdist = vdupq_n_f64(dist);
+    const float64x2_t vx1 = vdupq_n_f64(x1);
+    const float64x2_t vx2 = vdupq_n_f64(x2);
+    const float64x2_t vbottom = vdupq_n_f64(bottom);
+    for (; i + 2 <= n; i += 2) {
+        uint64x2_t mask = vandq_u64(vcgtq_f64(vx2, vld1q_f64(left + i)), vcltq_f64(vx1, vld1q_f64(right + i)));
+        float64x2_t d = vsubq_f64(vbottom, vld1q_f64(top + i));
+        vdist = vmaxq_f64(vdist, vbslq_f64(mask, d, vdist));
+    }
+    dist = std::max(vgetq_lane_f64(vdist, 0), vgetq_lane_f64(vdist, 1));
+#endif
+
+    for (; i < n; ++i) {
+        if (x2 > left[i] && x1 < right[i]) {
+            dist = std::max(dist, bottom - top[i]);
+        }
+    }
+
+    return dist;
+}
+
+//-------------------------------------------------------------------
+//   maxOverlapDistance
+//    Maximum of (r1.bottom() - r2.top()) over all pairs of
+//    horizontally intersecting rectangles (r1 from a, r2 from b).
+//-------------------------------------------------------------------
+
+static double maxOverlapDistance(const Shape& a, const Shape& b, double dist)
+{
+    thread_local VerticalPack pack;
+    pack.pack(b);
+    if (pack.size() == 0) {
+        return dist;
+    }
+
+    for (const RectF& r1 : a) {
+        if (r1.height() <= 0.0 || r1.left() == r1.right()) {
+            continue;
+        }
+        dist = maxOverlapDistance(pack, r1.left(), r1.right(), r1.bottom(), dist);
+    }
+
+    return dist;
+}
+
 //-------------------------------------------------------------------
 //   minVerticalDistance
 //    a is located below this shape.
@@ -153,25 +298,7 @@ double Shape::minVerticalDistance(const Shape& a) const
         return 0.0;
     }
 
-    double dist = -1000000.0; // min real
-    for (const RectF& r2 : a) {
-        if (r2.height() <= 0.0) {
-            continue;
-        }
-        double bx1 = r2.left();
-        double bx2 = r2.right();
-        for (const RectF& r1 : *this) {
-            if (r1.height() <= 0.0) {
-                continue;
-            }
-            double ax1 = r1.left();
-            double ax2 = r1.right();
-            if (mu::engraving::intersects(ax1, ax2, bx1, bx2, 0.0)) {
-                dist = std::max(dist, r1.bottom() - r2.top());
-            }
-        }
-    }
-    return dist;
+    return maxOverlapDistance(*this, a, -1000000.0); // min real
 }
 
 //-------------------------------------------------------------------
@@ -188,25 +315,8 @@ double Shape::verticalClearance(const Shape& a) const
         return 0.0;
     }
 
-    double dist = 1000000.0; // max real
-    for (const RectF& r2 : a) {
-        if (r2.height() <= 0.0) {
-            continue;
-        }
-        double bx1 = r2.left();
-        double bx2 = r2.right();
-        for (const RectF& r1 : *this) {
-            if (r1.height() <= 0.0) {
-                continue;
-            }
-            double ax1 = r1.left();
-            double ax2 = r1.right();
-            if (mu::engraving::intersects(ax1, ax2, bx1, bx2, 0.0)) {
-                dist = std::min(dist, r2.top() - r1.bottom());
-            }
-        }
-    }
-    return dist;
+    // min(r2.top() - r1.bottom()) == -max(r1.bottom() - r2.top())
+    return -maxOverlapDistance(*this, a, -1000000.0); // max real
 }
 
 //----------------------------------------------------------------
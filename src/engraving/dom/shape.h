@@ -109,6 +109,8 @@ public:
 
     void setSqueezeFactor(double v) { _squeezeFactor = v; }
 
+    size_t contentHash() const;
+
     void paint(mu::draw::Painter& painter) const;
 #ifndef NDEBUG
     void dump(const char*) const;
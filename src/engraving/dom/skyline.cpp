@@ -22,6 +22,8 @@
 
 #include "skyline.h"
 
+#include <algorithm>
+
 #include "arpeggio.h"
 #include "beam.h"
 #include "chord.h"
@@ -184,6 +186,11 @@ void SkylineLine::add(double x, double y, double w)
         }
     }
 
+    if (batch) {
+        pending.emplace_back(x, y, w);
+        return;
+    }
+
     DP("===add  %f %f %f\n", x, y, w);
 
     SegIter i = find(x);
@@ -257,6 +264,57 @@ void SkylineLine::add(double x, double y, double w)
     }
 }
 
+//---------------------------------------------------------
+//   beginBatch
+//    Rectangles added until endBatch() are only collected
+//    and merged into the line at once. The line must not
+//    be read in between.
+//---------------------------------------------------------
+
+void SkylineLine::beginBatch()
+{
+    batch = true;
+}
+
+//---------------------------------------------------------
+//   endBatch
+//    Adding a rectangle splits the segments it overlaps and
+//    shifts all segments to its right, so adding them in
+//    arbitrary order is quadratic. Sorted by x, every
+//    rectangle only touches the tail of the line.
+//---------------------------------------------------------
+
+void SkylineLine::endBatch()
+{
+    batch = false;
+    if (pending.empty()) {
+        return;
+    }
+
+    auto byX = [](const SkylineSegment& a, const SkylineSegment& b) { return a.x < b.x; };
+    if (!std::is_sorted(pending.begin(), pending.end(), byX)) {
+        std::stable_sort(pending.begin(), pending.end(), byX);
+    }
+
+    std::vector<SkylineSegment> rects;
+    rects.swap(pending);
+    for (const SkylineSegment& r : rects) {
+        add(r.x, r.y, r.w);
+    }
+}
+
+void Skyline::beginBatch()
+{
+    _north.beginBatch();
+    _south.beginBatch();
+}
+
+void Skyline::endBatch()
+{
+    _north.endBatch();
+    _south.endBatch();
+}
+
 //---------------------------------------------------------
 //   clear
 //---------------------------------------------------------
@@ -56,6 +56,8 @@ class SkylineLine
 {
     const bool north;
     std::vector<SkylineSegment> seg;
+    bool batch = false;
+    std::vector<SkylineSegment> pending;        // rectangles added in batch mode
     typedef std::vector<SkylineSegment>::iterator SegIter;
     typedef std::vector<SkylineSegment>::const_iterator SegConstIter;
 
@@ -72,7 +74,10 @@ public:
     void add(double x, double y, double w);
     void add(const RectF& r) { add(ShapeElement(r)); }
 
-    void clear() { seg.clear(); }
+    void beginBatch();
+    void endBatch();
+
+    void clear() { seg.clear(); pending.clear(); }
     void paint(mu::draw::Painter& painter) const;
     void dump() const;
     double minDistance(const SkylineLine&) const;
@@ -105,6 +110,9 @@ public:
     void add(const ShapeElement& r);
     void add(const RectF& r) { add(ShapeElement(r)); }
 
+    void beginBatch();
+    void endBatch();
+
     double minDistance(const Skyline&) const;
 
     SkylineLine& north() { return _north; }
@@ -48,6 +48,7 @@
 #include "page.h"
 #include "score.h"
 #include "textedit.h"
+#include "textmetricscache.h"
 #include "undo.h"
 
 #include "log.h"
@@ -886,29 +887,7 @@ mu::draw::Font TextFragment::font(const TextBase* t) const
         // check if all symbols are available
         font.setFamily(family, fontType);
         font.setNoFontMerging(true);
-        mu::draw::FontMetrics fm(font);
-
-        bool fail = false;
-        for (size_t i = 0; i < text.size(); ++i) {
-            const Char& c = text.at(i);
-            if (c.isHighSurrogate()) {
-                if (i + 1 == text.size()) {
-                    ASSERT_X("bad string");
-                }
-                const Char& c2 = text.at(i + 1);
-                ++i;
-                char32_t v = Char::surrogateToUcs4(c, c2);
-                if (!fm.inFontUcs4(v)) {
-                    fail = true;
-                    break;
-                }
-            } else {
-                if (!fm.inFont(c)) {
-                    fail = true;
-                    break;
-                }
-            }
-        }
+        bool fail = !TextMetricsCache::inFont(font, text);
         if (fail) {
             if (fontType == draw::Font::Type::MusicSymbol) {
                 family = String::fromUtf8(FALLBACK_SYMBOL_FONT);
@@ -986,16 +965,16 @@ void TextBlock::layout(const TextBase* t)
     }
 
     if (_fragments.empty()) {
-        mu::draw::FontMetrics fm = t->fontMetrics();
-        _bbox.setRect(0.0, -fm.ascent(), 1.0, fm.descent());
-        _lineSpacing = fm.lineSpacing();
+        FontMetricsData fm = TextMetricsCache::fontMetrics(t->font());
+        _bbox.setRect(0.0, -fm.ascent, 1.0, fm.descent);
+        _lineSpacing = fm.lineSpacing;
     } else if (_fragments.size() == 1 && _fragments.front().text.isEmpty()) {
         auto fi = _fragments.begin();
         TextFragment& f = *fi;
         f.pos.setX(x);
-        mu::draw::FontMetrics fm(f.font(t));
+        FontMetricsData fm = TextMetricsCache::fontMetrics(f.font(t));
         if (f.format.valign() != VerticalAlignment::AlignNormal) {
-            double voffset = fm.xHeight() / subScriptSize;   // use original height
+            double voffset = fm.xHeight / subScriptSize;   // use original height
             if (f.format.valign() == VerticalAlignment::AlignSubScript) {
                 voffset *= subScriptOffset;
             } else {
@@ -1007,17 +986,19 @@ void TextBlock::layout(const TextBase* t)
             f.pos.setY(0.0);
         }
 
-        RectF temp(0.0, -fm.ascent(), 1.0, fm.descent());
+        RectF temp(0.0, -fm.ascent, 1.0, fm.descent);
         _bbox |= temp;
-        _lineSpacing = std::max(_lineSpacing, fm.lineSpacing());
+        _lineSpacing = std::max(_lineSpacing, fm.lineSpacing);
     } else {
         const auto fiLast = --_fragments.end();
         for (auto fi = _fragments.begin(); fi != _fragments.end(); ++fi) {
             TextFragment& f = *fi;
             f.pos.setX(x);
-            mu::draw::FontMetrics fm(f.font(t));
+            mu::draw::Font font = f.font(t);
+            FontMetricsData fm = TextMetricsCache::fontMetrics(font);
+            TextMetricsData tm = TextMetricsCache::textMetrics(font, f.text);
             if (f.format.valign() != VerticalAlignment::AlignNormal) {
-                double voffset = fm.xHeight() / subScriptSize;           // use original height
+                double voffset = fm.xHeight / subScriptSize;           // use original height
                 if (f.format.valign() == VerticalAlignment::AlignSubScript) {
                     voffset *= subScriptOffset;
                 } else {
@@ -1031,12 +1012,11 @@ void TextBlock::layout(const TextBase* t)
             // Optimization: don't calculate character position
             // for the next fragment if there is no next fragment
             if (fi != fiLast) {
-                const double w  = fm.width(f.text);
-                x += w;
+                x += tm.width;
             }
 
-            _bbox   |= fm.tightBoundingRect(f.text).translated(f.pos);
-            _lineSpacing = std::max(_lineSpacing, fm.lineSpacing());
+            _bbox   |= tm.tightBoundingRect.translated(f.pos);
+            _lineSpacing = std::max(_lineSpacing, fm.lineSpacing);
         }
     }
 
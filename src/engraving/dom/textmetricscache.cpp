@@ -0,0 +1,223 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2023 MuseScore BVBA and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "textmetricscache.h"
+
+#include <mutex>
+#include <unordered_map>
+
+#include "hashutils.h"
+
+#include "draw/fontmetrics.h"
+
+#include "log.h"
+
+using namespace mu;
+using namespace mu::draw;
+using namespace mu::engraving;
+
+// a cache that grows beyond this is dropped, it only happens with lots of distinct texts
+static constexpr size_t MAX_ENTRIES = 50000;
+
+namespace {
+struct FontKey {
+    Font font;
+
+    bool operator==(const FontKey& other) const
+    {
+        //! NOTE Font::operator== does not compare the type, but the font provider uses it
+        return font == other.font && font.type() == other.font.type();
+    }
+};
+
+struct TextKey {
+    Font font;
+    String text;
+
+    bool operator==(const TextKey& other) const
+    {
+        return text == other.text && font == other.font && font.type() == other.font.type();
+    }
+};
+
+static size_t fontHash(const Font& f)
+{
+    size_t h = f.family().hash();
+    hashCombine(h, std::hash<double> {}(f.pointSizeF()));
+    hashCombine(h, static_cast<size_t>(f.weight()));
+    hashCombine(h, static_cast<size_t>(f.type()));
+    hashCombine(h, static_cast<size_t>(f.hinting()));
+    hashCombine(h, (f.italic() ? 1 : 0) | (f.underline() ? 2 : 0) | (f.strike() ? 4 : 0) | (f.noFontMerging() ? 8 : 0));
+    return h;
+}
+
+struct FontKeyHash {
+    size_t operator()(const FontKey& k) const { return fontHash(k.font); }
+};
+
+struct TextKeyHash {
+    size_t operator()(const TextKey& k) const
+    {
+        size_t h = fontHash(k.font);
+        hashCombine(h, k.text.hash());
+        return h;
+    }
+};
+
+struct Cache {
+    std::mutex mutex;
+    std::unordered_map<FontKey, FontMetricsData, FontKeyHash> fonts;
+    std::unordered_map<TextKey, TextMetricsData, TextKeyHash> texts;
+    std::unordered_map<TextKey, bool, TextKeyHash> inFont;
+};
+}
+
+static Cache& cache()
+{
+    static Cache c;
+    return c;
+}
+
+template<typename Map>
+static void insert(Map& map, typename Map::key_type&& key, const typename Map::mapped_type& value)
+{
+    if (map.size() >= MAX_ENTRIES) {
+        map.clear();
+    }
+    map.emplace(std::move(key), value);
+}
+
+//---------------------------------------------------------
+//   fontMetrics
+//---------------------------------------------------------
+
+FontMetricsData TextMetricsCache::fontMetrics(const Font& font)
+{
+    Cache& c = cache();
+    FontKey key { font };
+    {
+        std::lock_guard<std::mutex> lock(c.mutex);
+        auto it = c.fonts.find(key);
+        if (it != c.fonts.end()) {
+            return it->second;
+        }
+    }
+
+    FontMetrics fm(font);
+    FontMetricsData data;
+    data.ascent = fm.ascent();
+    data.descent = fm.descent();
+    data.lineSpacing = fm.lineSpacing();
+    data.xHeight = fm.xHeight();
+
+    std::lock_guard<std::mutex> lock(c.mutex);
+    insert(c.fonts, std::move(key), data);
+    return data;
+}
+
+//---------------------------------------------------------
+//   textMetrics
+//---------------------------------------------------------
+
+TextMetricsData TextMetricsCache::textMetrics(const Font& font, const String& text)
+{
+    Cache& c = cache();
+    TextKey key { font, text };
+    {
+        std::lock_guard<std::mutex> lock(c.mutex);
+        auto it = c.texts.find(key);
+        if (it != c.texts.end()) {
+            return it->second;
+        }
+    }
+
+    FontMetrics fm(font);
+    TextMetricsData data;
+    data.width = fm.width(text);
+    data.boundingRect = fm.boundingRect(text);
+    data.tightBoundingRect = fm.tightBoundingRect(text);
+
+    std::lock_guard<std::mutex> lock(c.mutex);
+    insert(c.texts, std::move(key), data);
+    return data;
+}
+
+//---------------------------------------------------------
+//   inFont
+//---------------------------------------------------------
+
+bool TextMetricsCache::inFont(const Font& font, const String& text)
+{
+    Cache& c = cache();
+    TextKey key { font, text };
+    {
+        std::lock_guard<std::mutex> lock(c.mutex);
+        auto it = c.inFont.find(key);
+        if (it != c.inFont.end()) {
+            return it->second;
+        }
+    }
+
+    FontMetrics fm(font);
+    bool result = true;
+    for (size_t i = 0; i < text.size(); ++i) {
+        const Char& ch = text.at(i);
+        if (ch.isHighSurrogate()) {
+            if (i + 1 == text.size()) {
+                ASSERT_X("bad string");
+            }
+            const Char& ch2 = text.at(i + 1);
+            ++i;
+            if (!fm.inFontUcs4(Char::surrogateToUcs4(ch, ch2))) {
+                result = false;
+                break;
+            }
+        } else if (!fm.inFont(ch)) {
+            result = false;
+            break;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(c.mutex);
+    insert(c.inFont, std::move(key), result);
+    return result;
+}
+
+//---------------------------------------------------------
+//   clear
+//---------------------------------------------------------
+
+void TextMetricsCache::clear()
+{
+    Cache& c = cache();
+    std::lock_guard<std::mutex> lock(c.mutex);
+    c.fonts.clear();
+    c.texts.clear();
+    c.inFont.clear();
+}
+
+size_t TextMetricsCache::size()
+{
+    Cache& c = cache();
+    std::lock_guard<std::mutex> lock(c.mutex);
+    return c.fonts.size() + c.texts.size() + c.inFont.size();
+}
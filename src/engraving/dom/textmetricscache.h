@@ -0,0 +1,78 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2023 MuseScore BVBA and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef MU_ENGRAVING_TEXTMETRICSCACHE_H
+#define MU_ENGRAVING_TEXTMETRICSCACHE_H
+
+#include "draw/types/font.h"
+#include "draw/types/geometry.h"
+#include "types/string.h"
+
+namespace mu::engraving {
+//---------------------------------------------------------
+//   FontMetricsData
+//    metrics that depend only on the font
+//---------------------------------------------------------
+
+struct FontMetricsData {
+    double ascent = 0.0;
+    double descent = 0.0;
+    double lineSpacing = 0.0;
+    double xHeight = 0.0;
+};
+
+//---------------------------------------------------------
+//   TextMetricsData
+//    metrics of a string in a font
+//---------------------------------------------------------
+
+struct TextMetricsData {
+    double width = 0.0;
+    RectF boundingRect;
+    RectF tightBoundingRect;
+};
+
+//---------------------------------------------------------
+//   TextMetricsCache
+//    Font metrics of text fragments, shared by all scores.
+//    Text layout asks the font provider for the same
+//    strings in the same fonts on every relayout (lyrics,
+//    chord symbols, dynamics, the texts of linked parts),
+//    so the results are kept here.
+//---------------------------------------------------------
+
+class TextMetricsCache
+{
+public:
+    static FontMetricsData fontMetrics(const draw::Font& font);
+    static TextMetricsData textMetrics(const draw::Font& font, const String& text);
+
+    // true if all characters of the text are in the font itself, without font merging
+    static bool inFont(const draw::Font& font, const String& text);
+
+    //! NOTE Must be called when fonts are added or replaced
+    static void clear();
+    static size_t size();
+};
+}
+
+#endif // MU_ENGRAVING_TEXTMETRICSCACHE_H
@@ -140,13 +140,13 @@ MasterScore* EngravingProject::masterScore() const
     return m_masterScore;
 }
 
-Ret EngravingProject::loadMscz(const MscReader& msc, SettingsCompat& settingsCompat, bool ignoreVersionError)
+Ret EngravingProject::loadMscz(const MscReader& msc, SettingsCompat& settingsCompat, bool ignoreVersionError, bool deferExcerpts)
 {
     TRACEFUNC;
 
     MScore::setError(MsError::MS_NO_ERROR);
     MscLoader loader;
-    return loader.loadMscz(m_masterScore, msc, settingsCompat, ignoreVersionError);
+    return loader.loadMscz(m_masterScore, msc, settingsCompat, ignoreVersionError, deferExcerpts);
 }
 
 bool EngravingProject::writeMscz(MscWriter& writer, bool onlySelection, bool createThumbnail)
@@ -68,7 +68,7 @@ public:
     MasterScore* masterScore() const;
     Ret setupMasterScore(bool forceMode);
 
-    Ret loadMscz(const MscReader& msc, SettingsCompat& settingsCompat, bool ignoreVersionError);
+    Ret loadMscz(const MscReader& msc, SettingsCompat& settingsCompat, bool ignoreVersionError, bool deferExcerpts = false);
     bool writeMscz(MscWriter& writer, bool onlySelection, bool createThumbnail);
 
     bool isCorruptedUponLoading() const;
@@ -42,6 +42,12 @@ public:
 
     virtual io::path_t appDataPath() const = 0;
 
+    //! NOTE Directory of the binary forms of opened score files, empty if they are not cached
+    virtual io::path_t scoreCachePath() const = 0;
+
+    //! NOTE Whether the independent parts of the layout of a system (e.g. the skylines of its staves) are done on the worker pool
+    virtual bool isParallelLayoutEnabled() const = 0;
+
     virtual io::path_t defaultStyleFilePath() const = 0;
     virtual void setDefaultStyleFilePath(const io::path_t& path) = 0;
 
@@ -263,7 +263,10 @@ Ret MscReader::ZipFileReader::open(IODevice* device, const path_t& filePath)
             return make_ret(Err::FileNotFound, filePath);
         }
 
-        m_device = new File(filePath);
+        //! NOTE The entries are inflated straight from the mapped file, without reading it into memory first
+        File* file = new File(filePath);
+        file->setMemoryMapped(true);
+        m_device = file;
         m_selfDeviceOwner = true;
     }
 
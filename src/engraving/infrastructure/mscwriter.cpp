@@ -29,6 +29,7 @@
 #include "io/fileinfo.h"
 #include "io/dir.h"
 #include "serialization/xmlstreamwriter.h"
+#include "serialization/zipreader.h"
 #include "serialization/zipwriter.h"
 #include "serialization/textstream.h"
 
@@ -100,9 +101,14 @@ bool MscWriter::hasError() const
 MscWriter::IWriter* MscWriter::writer() const
 {
     if (!m_writer) {
+        if (m_params.deferred) {
+            m_writer = new DeferredWriter(&m_deferredFiles);
+            return m_writer;
+        }
+
         switch (m_params.mode) {
         case MscIoMode::Zip:
-            m_writer = new ZipFileWriter();
+            m_writer = new ZipFileWriter(m_params.previousFilePath, m_params.compressionLevel);
             break;
         case MscIoMode::Dir:
             m_writer = new DirWriter();
@@ -202,6 +208,38 @@ void MscWriter::writeViewSettingsJsonFile(const ByteArray& data, const io::path_
     addFileData(pathPrefix.toString() + u"viewsettings.json", data);
 }
 
+Ret MscWriter::writeDeferred()
+{
+    IF_ASSERT_FAILED(m_params.deferred && !isOpened()) {
+        return make_ret(Ret::Code::InternalError);
+    }
+
+    Params params = m_params;
+    params.deferred = false;
+
+    MscWriter target(params);
+    Ret ret = target.open();
+    if (!ret) {
+        return ret;
+    }
+
+    for (const auto& file : m_deferredFiles) {
+        if (!target.addFileData(file.first, file.second)) {
+            return make_ret(Ret::Code::UnknownError);
+        }
+    }
+
+    // META-INF/container.xml is already among the files
+    target.m_meta.isWritten = true;
+    target.close();
+
+    if (target.hasError()) {
+        return make_ret(Ret::Code::UnknownError);
+    }
+
+    return make_ok();
+}
+
 void MscWriter::writeMeta()
 {
     if (m_meta.isWritten) {
@@ -253,9 +291,15 @@ void MscWriter::Meta::addFile(const String& file)
 // Writers
 // =======================================================================
 
+MscWriter::ZipFileWriter::ZipFileWriter(const io::path_t& previousFilePath, int compressionLevel)
+    : m_previousFilePath(previousFilePath), m_compressionLevel(compressionLevel)
+{
+}
+
 MscWriter::ZipFileWriter::~ZipFileWriter()
 {
     delete m_zip;
+    delete m_previous;
     if (m_selfDeviceOwner) {
         delete m_device;
     }
@@ -277,6 +321,12 @@ Ret MscWriter::ZipFileWriter::open(io::IODevice* device, const path_t& filePath)
     }
 
     m_zip = new ZipWriter(m_device);
+    m_zip->setCompressionLevel(m_compressionLevel);
+    m_zip->setParallelCompression(true);
+
+    if (!m_previousFilePath.empty() && m_previousFilePath != filePath && FileInfo::exists(m_previousFilePath)) {
+        m_previous = new ZipReader(m_previousFilePath);
+    }
 
     return true;
 }
@@ -287,6 +337,10 @@ void MscWriter::ZipFileWriter::close()
         m_zip->close();
     }
 
+    if (m_previous) {
+        m_previous->close();
+    }
+
     if (m_device) {
         m_device->close();
     }
@@ -308,7 +362,12 @@ bool MscWriter::ZipFileWriter::addFileData(const String& fileName, const ByteArr
         return false;
     }
 
-    m_zip->addFile(fileName.toStdString(), data);
+    if (m_previous) {
+        std::string name = fileName.toStdString();
+        m_zip->addFile(name, data, m_previous->rawFileData(name));
+    } else {
+        m_zip->addFile(fileName.toStdString(), data);
+    }
     if (m_zip->hasError()) {
         LOGE() << "failed write files to zip";
         return false;
@@ -395,6 +454,43 @@ bool MscWriter::DirWriter::addFileData(const String& fileName, const ByteArray&
     return true;
 }
 
+MscWriter::DeferredWriter::DeferredWriter(std::vector<std::pair<String, ByteArray> >* files)
+    : m_files(files)
+{
+}
+
+Ret MscWriter::DeferredWriter::open(io::IODevice*, const io::path_t&)
+{
+    m_files->clear();
+    m_isOpened = true;
+    return true;
+}
+
+void MscWriter::DeferredWriter::close()
+{
+    m_isOpened = false;
+}
+
+bool MscWriter::DeferredWriter::isOpened() const
+{
+    return m_isOpened;
+}
+
+bool MscWriter::DeferredWriter::hasError() const
+{
+    return false;
+}
+
+bool MscWriter::DeferredWriter::addFileData(const String& fileName, const ByteArray& data)
+{
+    if (!m_isOpened) {
+        return false;
+    }
+
+    m_files->push_back({ fileName, data });
+    return true;
+}
+
 MscWriter::XmlFileWriter::~XmlFileWriter()
 {
     delete m_stream;
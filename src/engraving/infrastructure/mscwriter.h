@@ -29,6 +29,7 @@
 #include "mscio.h"
 
 namespace mu {
+class ZipReader;
 class ZipWriter;
 class TextStream;
 }
@@ -44,6 +45,16 @@ public:
         io::path_t filePath;
         String mainFileName;
         MscIoMode mode = MscIoMode::Zip;
+
+        //! NOTE If set, the files are only collected in memory and written by writeDeferred
+        bool deferred = false;
+
+        //! NOTE The previously saved container (zip only), its files that haven't changed
+        //! are copied as they are instead of being compressed again
+        io::path_t previousFilePath;
+
+        //! NOTE zlib compression level of the zip container, -1 is the zlib default
+        int compressionLevel = -1;
     };
 
     MscWriter() = default;
@@ -69,6 +80,10 @@ public:
     void writeAudioSettingsJsonFile(const ByteArray& data);
     void writeViewSettingsJsonFile(const ByteArray& data, const io::path_t& pathPrefix = "");
 
+    //! NOTE Writes the collected files to the container. Doesn't touch the score,
+    //! so it can be called on a background thread once the writer is closed
+    Ret writeDeferred();
+
 private:
 
     struct IWriter {
@@ -83,6 +98,7 @@ private:
 
     struct ZipFileWriter : public IWriter
     {
+        ZipFileWriter(const io::path_t& previousFilePath, int compressionLevel);
         ~ZipFileWriter() override;
         Ret open(io::IODevice* device, const io::path_t& filePath) override;
         void close() override;
@@ -94,6 +110,9 @@ private:
         io::IODevice* m_device = nullptr;
         bool m_selfDeviceOwner = false;
         ZipWriter* m_zip = nullptr;
+        io::path_t m_previousFilePath;
+        ZipReader* m_previous = nullptr;
+        int m_compressionLevel = -1;
     };
 
     struct DirWriter : public IWriter
@@ -122,6 +141,19 @@ private:
         TextStream* m_stream = nullptr;
     };
 
+    struct DeferredWriter : public IWriter
+    {
+        DeferredWriter(std::vector<std::pair<String, ByteArray> >* files);
+        Ret open(io::IODevice* device, const io::path_t& filePath) override;
+        void close() override;
+        bool isOpened() const override;
+        bool hasError() const override;
+        bool addFileData(const String& fileName, const ByteArray& data) override;
+    private:
+        std::vector<std::pair<String, ByteArray> >* m_files = nullptr;
+        bool m_isOpened = false;
+    };
+
     struct Meta {
         std::vector<String> files;
         bool isWritten = false;
@@ -143,6 +175,7 @@ private:
     mutable IWriter* m_writer = nullptr;
     Meta m_meta;
     bool m_hadError = false;
+    mutable std::vector<std::pair<String, ByteArray> > m_deferredFiles;
 };
 }
 
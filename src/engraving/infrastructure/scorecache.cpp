@@ -0,0 +1,198 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2023 MuseScore BVBA and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "scorecache.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cinttypes>
+#include <cstdio>
+#include <mutex>
+#include <optional>
+#include <random>
+
+#include "concurrency/taskscheduler.h"
+#include "serialization/xmlstreamreader.h"
+
+#include "log.h"
+
+using namespace mu;
+using namespace mu::io;
+using namespace mu::engraving;
+
+//! NOTE Small files are parsed about as fast as their binary forms are read
+static constexpr size_t MIN_CACHED_SIZE = 32 * 1024;
+static constexpr size_t MAX_ENTRIES = 256;
+
+//! NOTE Over the limit, the oldest entries are removed at once down to this count
+static constexpr size_t TRIMMED_ENTRIES = MAX_ENTRIES * 3 / 4;
+
+//! NOTE The entries of the cache directory, counted when the first entry of the session is written.
+//! Then the written entries are added, so the directory is listed again only to trim it
+static std::mutex s_entriesCountMutex;
+static std::optional<size_t> s_entriesCount;
+
+static const char* ENTRY_SUFFIX = ".mxb";
+
+// FNV-1a
+static uint64_t dataHash(const ByteArray& data)
+{
+    uint64_t hash = 14695981039346656037ull;
+    const uint8_t* d = data.constData();
+    for (size_t i = 0; i < data.size(); ++i) {
+        hash ^= d[i];
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+static path_t entryPathFor(const path_t& cachePath, const ByteArray& xml)
+{
+    char name[64];
+    std::snprintf(name, sizeof(name), "/%016" PRIx64 "_%zu", dataHash(xml), xml.size());
+    return cachePath + name + ENTRY_SUFFIX;
+}
+
+//! NOTE Unique per write: another instance, or another score with the same data, may be writing the same entry
+static path_t tempPathFor(const path_t& entryPath)
+{
+    static const uint64_t instanceId = (static_cast<uint64_t>(std::random_device()()) << 32) | std::random_device()();
+    static std::atomic<uint64_t> writeNo = 0;
+
+    char suffix[64];
+    std::snprintf(suffix, sizeof(suffix), ".%016" PRIx64 "_%" PRIu64 ".tmp", instanceId, writeNo++);
+    return entryPath + suffix;
+}
+
+//! NOTE The whole entry is read through once, so that a damaged one is never given to the score reader,
+//! which can't go back to the XML once it has read a part of the score
+static bool isReadable(const ByteArray& binary)
+{
+    XmlStreamReader reader(binary);
+    while (reader.readNext() != XmlStreamReader::Invalid) {
+        if (reader.isEndDocument()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+ByteArray ScoreCache::resolve(const ByteArray& xml)
+{
+    if (xml.size() < MIN_CACHED_SIZE || XmlStreamReader::isBinary(xml) || !configuration() || !fileSystem()) {
+        return xml;
+    }
+
+    const path_t cachePath = configuration()->scoreCachePath();
+    if (cachePath.empty()) {
+        return xml;
+    }
+
+    TRACEFUNC;
+
+    const path_t entryPath = entryPathFor(cachePath, xml);
+    if (fileSystem()->exists(entryPath)) {
+        RetVal<ByteArray> entry = fileSystem()->mapFile(entryPath);
+        if (entry.ret && XmlStreamReader::isBinary(entry.val) && isReadable(entry.val)) {
+            return entry.val;
+        }
+
+        // the XML is read instead, and the entry written again
+        LOGW() << "damaged cache entry: " << entryPath;
+        entry.val = ByteArray();
+        fileSystem()->remove(entryPath);
+    }
+
+    TaskScheduler::instance()->push([cachePath, entryPath, xml]() {
+        write(cachePath, entryPath, xml);
+    });
+
+    return xml;
+}
+
+void ScoreCache::write(const path_t& cachePath, const path_t& entryPath, const ByteArray& xml)
+{
+    TRACEFUNC;
+
+    ByteArray binary = XmlStreamReader::toBinary(xml);
+    if (binary.empty()) {
+        return;
+    }
+
+    Ret ret = fileSystem()->makePath(cachePath);
+    if (!ret) {
+        LOGW() << "failed make path: " << cachePath << ", err: " << ret.toString();
+        return;
+    }
+
+    //! NOTE Written aside and moved, so that the entry is never read half written
+    const path_t tempPath = tempPathFor(entryPath);
+    ret = fileSystem()->writeFile(tempPath, binary);
+    if (ret) {
+        ret = fileSystem()->move(tempPath, entryPath, true);
+    }
+
+    if (!ret) {
+        LOGW() << "failed write cache entry: " << entryPath << ", err: " << ret.toString();
+        fileSystem()->remove(tempPath);
+        return;
+    }
+
+    removeOldEntries(cachePath);
+}
+
+void ScoreCache::removeOldEntries(const path_t& cachePath)
+{
+    std::lock_guard<std::mutex> lock(s_entriesCountMutex);
+
+    //! NOTE An overwritten entry is counted as a new one, the listing corrects the count
+    if (s_entriesCount && ++(*s_entriesCount) <= MAX_ENTRIES) {
+        return;
+    }
+
+    RetVal<paths_t> entries = fileSystem()->scanFiles(cachePath, { std::string("*") + ENTRY_SUFFIX }, ScanMode::FilesInCurrentDir);
+    if (!entries.ret) {
+        s_entriesCount.reset();
+        return;
+    }
+
+    if (entries.val.size() <= MAX_ENTRIES) {
+        s_entriesCount = entries.val.size();
+        return;
+    }
+
+    //! NOTE The ISO date strings are sorted as the times are
+    std::vector<std::pair<String, path_t> > byTime;
+    byTime.reserve(entries.val.size());
+    for (const path_t& entry : entries.val) {
+        byTime.push_back({ fileSystem()->lastModified(entry).toString(), entry });
+    }
+
+    std::sort(byTime.begin(), byTime.end(), [](const auto& a, const auto& b) {
+        return a.first < b.first;
+    });
+
+    for (size_t i = 0; i < byTime.size() - TRIMMED_ENTRIES; ++i) {
+        fileSystem()->remove(byTime.at(i).second);
+    }
+
+    s_entriesCount = TRIMMED_ENTRIES;
+}
@@ -0,0 +1,52 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2023 MuseScore BVBA and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef MU_ENGRAVING_SCORECACHE_H
+#define MU_ENGRAVING_SCORECACHE_H
+
+#include "types/bytearray.h"
+
+#include "modularity/ioc.h"
+#include "io/ifilesystem.h"
+#include "../iengravingconfiguration.h"
+
+namespace mu::engraving {
+//! NOTE Cache of the binary forms of score files (see XmlStreamReader::toBinary),
+//! so that an unchanged score is read again without parsing its XML.
+//! The entries are named after a hash and the size of the XML data.
+class ScoreCache
+{
+    INJECT_STATIC(IEngravingConfiguration, configuration)
+    INJECT_STATIC(io::IFileSystem, fileSystem)
+public:
+
+    //! NOTE Returns the binary form of the XML data if it is cached, otherwise the data itself,
+    //! then the binary form is written to the cache in the background.
+    //! A damaged entry is removed and written again
+    static ByteArray resolve(const ByteArray& xml);
+
+private:
+    static void write(const io::path_t& cachePath, const io::path_t& entryPath, const ByteArray& xml);
+    static void removeOldEntries(const io::path_t& cachePath);
+};
+}
+
+#endif // MU_ENGRAVING_SCORECACHE_H
@@ -44,6 +44,10 @@ static const Settings::Key PART_STYLE_FILE_PATH("engraving", "engraving/style/pa
 
 static const Settings::Key INVERT_SCORE_COLOR("engraving", "engraving/scoreColorInversion");
 
+static const Settings::Key SCORE_CACHE_ENABLED("engraving", "engraving/scoreCache/enabled");
+
+static const Settings::Key PARALLEL_LAYOUT_ENABLED("engraving", "engraving/layout/parallel");
+
 struct VoiceColor {
     Settings::Key key;
     Color color;
@@ -62,6 +66,10 @@ void EngravingConfiguration::init()
         "#C31989"
     };
 
+    settings()->setDefaultValue(SCORE_CACHE_ENABLED, Val(true));
+
+    settings()->setDefaultValue(PARALLEL_LAYOUT_ENABLED, Val(false));
+
     settings()->setDefaultValue(INVERT_SCORE_COLOR, Val(false));
     settings()->valueChanged(INVERT_SCORE_COLOR).onReceive(nullptr, [this](const Val&) {
         m_scoreInversionChanged.notify();
@@ -89,6 +97,20 @@ mu::io::path_t EngravingConfiguration::appDataPath() const
     return globalConfiguration()->appDataPath();
 }
 
+mu::io::path_t EngravingConfiguration::scoreCachePath() const
+{
+    if (!settings()->value(SCORE_CACHE_ENABLED).toBool()) {
+        return mu::io::path_t();
+    }
+
+    return globalConfiguration()->userAppDataPath() + "/score_cache";
+}
+
+bool EngravingConfiguration::isParallelLayoutEnabled() const
+{
+    return settings()->value(PARALLEL_LAYOUT_ENABLED).toBool();
+}
+
 mu::io::path_t EngravingConfiguration::defaultStyleFilePath() const
 {
     return settings()->value(DEFAULT_STYLE_FILE_PATH).toPath();
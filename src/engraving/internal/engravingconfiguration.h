@@ -47,6 +47,10 @@ public:
 
     io::path_t appDataPath() const override;
 
+    io::path_t scoreCachePath() const override;
+
+    bool isParallelLayoutEnabled() const override;
+
     io::path_t defaultStyleFilePath() const override;
     void setDefaultStyleFilePath(const io::path_t& path) override;
 
@@ -29,6 +29,7 @@
 
 #include "dom/mscore.h"
 #include "dom/shape.h"
+#include "dom/textmetricscache.h"
 
 #include "smufl.h"
 
@@ -99,6 +100,9 @@ void EngravingFont::ensureLoad()
         return;
     }
 
+    // the metrics of texts in this font may have been cached with a fallback font
+    TextMetricsCache::clear();
+
     m_font.setWeight(mu::draw::Font::Normal);
     m_font.setItalic(false);
     m_font.setFamily(String::fromStdString(m_family), Font::Type::MusicSymbol);
@@ -21,6 +21,9 @@
  */
 #include "horizontalspacing.h"
 
+#include "hashutils.h"
+
+#include "dom/beam.h"
 #include "dom/chord.h"
 #include "dom/engravingitem.h"
 #include "dom/glissando.h"
@@ -29,6 +32,8 @@
 #include "dom/score.h"
 #include "dom/stemslash.h"
 
+#include "rendering/paddingtable.h"
+
 using namespace mu::engraving;
 using namespace mu::engraving::rendering::dev;
 
@@ -54,6 +59,85 @@ double HorizontalSpacing::computePadding(const EngravingItem* item1, const Engra
     return padding;
 }
 
+//---------------------------------------------------------
+//   spacingHash
+//    Hash of what computePadding() and computeKerning() read
+//    from an item, besides its type, its track and its shape.
+//    The distances between segments are cached by it across
+//    layouts (see MeasureLayout::minHorizontalDistance), so
+//    it must follow the two functions.
+//---------------------------------------------------------
+
+static size_t beamHash(const Chord* chord)
+{
+    const Beam* beam = chord ? chord->beam() : nullptr;
+    if (!beam || beam->elements().empty()) {
+        return 0;
+    }
+
+    // the beam is identified by its first chord, not by its address
+    const ChordRest* first = beam->elements().front();
+    size_t seed = static_cast<size_t>(first->tick().ticks());
+    hashCombine(seed, first->track());
+    return seed;
+}
+
+size_t HorizontalSpacing::spacingHash(const EngravingItem* item)
+{
+    std::hash<double> doubleHash;
+    size_t seed = doubleHash(item->mag());
+
+    // kerning compares the heights of the items, the notes are padded if they intersect
+    PointF pos = item->pos();
+    for (const EngravingItem* p = item->parentItem(); p && !p->isSegment(); p = p->parentItem()) {
+        pos += p->pos();
+    }
+    hashCombine(seed, doubleHash(pos.x()));
+    hashCombine(seed, doubleHash(pos.y()));
+
+    const EngravingItem* parent = item->parentItem();
+    if (parent && parent->isNote()) {
+        hashCombine(seed, toNote(parent)->isTrillCueNote());
+    }
+
+    const Chord* chord = nullptr;
+    if (item->isNote()) {
+        const Note* note = toNote(item);
+        chord = note->chord();
+        hashCombine(seed, note->isGrace());
+        hashCombine(seed, doubleHash(note->headWidth()));
+        hashCombine(seed, note->tieBack() || !note->spannerBack().empty());
+        for (const LineAttachPoint& laPoint : note->lineAttachPoints()) {
+            const EngravingItem* line = laPoint.line();
+            hashCombine(seed, static_cast<size_t>(line->type()));
+            hashCombine(seed, static_cast<size_t>(line->tick().ticks()));
+            hashCombine(seed, line->track());
+            if (line->isGlissando()) {
+                hashCombine(seed, static_cast<size_t>(toGlissando(line)->glissandoType()));
+            }
+            hashCombine(seed, doubleHash(laPoint.pos().x()));
+        }
+    } else if (item->isRest()) {
+        const Rest* rest = toRest(item);
+        hashCombine(seed, static_cast<size_t>(rest->layoutData()->sym()));
+        hashCombine(seed, doubleHash(rest->layoutData()->bbox().left()));
+    } else if (item->isStemSlash()) {
+        chord = toStemSlash(item)->chord();
+    } else if (parent && parent->isChord()) {
+        chord = toChord(parent);
+    } else if (parent && parent->isNote()) {
+        chord = toNote(parent)->chord();
+    }
+
+    if (chord) {
+        hashCombine(seed, chord->allowKerningAbove());
+        hashCombine(seed, chord->allowKerningBelow());
+        hashCombine(seed, beamHash(chord));
+    }
+
+    return seed;
+}
+
 bool HorizontalSpacing::isSpecialNotePaddingType(ElementType type)
 {
     switch (type) {
@@ -144,24 +228,65 @@ void HorizontalSpacing::computeLedgerRestPadding(const Rest* rest2, double& padd
     }
 }
 
+//---------------------------------------------------------
+//   KerningTable
+//    The kerning type of most pairs of items only depends
+//    on their types, so it's computed once for all pairs of
+//    types. NOT_SET means that it depends on the items
+//    themselves (see computeItemKerningType).
+//---------------------------------------------------------
+
+struct HorizontalSpacing::KerningTable {
+    PaddingVector<PaddingVector<KerningType> > types;
+    PaddingVector<bool> sameVoiceLimited;
+};
+
+const HorizontalSpacing::KerningTable& HorizontalSpacing::kerningTable()
+{
+    static const KerningTable table = createKerningTable();
+    return table;
+}
+
+HorizontalSpacing::KerningTable HorizontalSpacing::createKerningTable()
+{
+    KerningTable table;
+    for (size_t i = 0; i < TOT_ELEMENT_TYPES; ++i) {
+        ElementType type1 = static_cast<ElementType>(i);
+        table.sameVoiceLimited[i] = isSameVoiceKerningLimited(type1);
+
+        for (size_t j = 0; j < TOT_ELEMENT_TYPES; ++j) {
+            ElementType type2 = static_cast<ElementType>(j);
+            if ((isNeverKernable(type1) || isNeverKernable(type2))
+                && !(isAlwaysKernable(type1) || isAlwaysKernable(type2))) {
+                table.types[i][j] = KerningType::NON_KERNING;
+            } else {
+                table.types[i][j] = computeKerningType(type1, type2);
+            }
+        }
+    }
+    return table;
+}
+
 KerningType HorizontalSpacing::computeKerning(const EngravingItem* item1, const EngravingItem* item2)
 {
-    if (isSameVoiceKerningLimited(item1) && isSameVoiceKerningLimited(item2) && item1->track() == item2->track()) {
+    const KerningTable& table = kerningTable();
+    ElementType type1 = item1->type();
+    ElementType type2 = item2->type();
+
+    if (table.sameVoiceLimited.at(type1) && table.sameVoiceLimited.at(type2) && item1->track() == item2->track()) {
         return KerningType::NON_KERNING;
     }
 
-    if ((isNeverKernable(item1) || isNeverKernable(item2))
-        && !(isAlwaysKernable(item1) || isAlwaysKernable(item2))) {
-        return KerningType::NON_KERNING;
+    KerningType kerningType = table.types.at(type1).at(type2);
+    if (kerningType != KerningType::NOT_SET) {
+        return kerningType;
     }
 
-    return doComputeKerningType(item1, item2);
+    return computeItemKerningType(item1, item2);
 }
 
-bool HorizontalSpacing::isSameVoiceKerningLimited(const EngravingItem* item)
+bool HorizontalSpacing::isSameVoiceKerningLimited(ElementType type)
 {
-    ElementType type = item->type();
-
     switch (type) {
     case ElementType::NOTE:
     case ElementType::REST:
@@ -174,10 +299,8 @@ bool HorizontalSpacing::isSameVoiceKerningLimited(const EngravingItem* item)
     }
 }
 
-bool HorizontalSpacing::isNeverKernable(const EngravingItem* item)
+bool HorizontalSpacing::isNeverKernable(ElementType type)
 {
-    ElementType type = item->type();
-
     switch (type) {
     case ElementType::CLEF:
     case ElementType::TIMESIG:
@@ -189,23 +312,33 @@ bool HorizontalSpacing::isNeverKernable(const EngravingItem* item)
     }
 }
 
-bool HorizontalSpacing::isAlwaysKernable(const EngravingItem* item)
+bool HorizontalSpacing::isAlwaysKernable(ElementType type)
 {
-    return item->isTextBase() || item->isChordLine();
+    return EngravingObject::isTextBaseType(type) || type == ElementType::CHORDLINE;
 }
 
-KerningType HorizontalSpacing::doComputeKerningType(const EngravingItem* item1, const EngravingItem* item2)
+KerningType HorizontalSpacing::computeKerningType(ElementType type1, ElementType type2)
 {
-    ElementType type1 = item1->type();
     switch (type1) {
     case ElementType::BAR_LINE:
         return KerningType::NON_KERNING;
     case ElementType::CHORDLINE:
-        return item2->isBarLine() ? KerningType::ALLOW_COLLISION : KerningType::KERNING;
+        return type2 == ElementType::BAR_LINE ? KerningType::ALLOW_COLLISION : KerningType::KERNING;
     case ElementType::HARMONY:
-        return item2->isHarmony() ? KerningType::NON_KERNING : KerningType::KERNING;
+        return type2 == ElementType::HARMONY ? KerningType::NON_KERNING : KerningType::KERNING;
     case ElementType::LYRICS:
-        return (item2->isLyrics() || item2->isBarLine()) ? KerningType::NON_KERNING : KerningType::KERNING;
+        return (type2 == ElementType::LYRICS || type2 == ElementType::BAR_LINE) ? KerningType::NON_KERNING : KerningType::KERNING;
+    case ElementType::NOTE:
+    case ElementType::STEM_SLASH:
+        return KerningType::NOT_SET;
+    default:
+        return KerningType::KERNING;
+    }
+}
+
+KerningType HorizontalSpacing::computeItemKerningType(const EngravingItem* item1, const EngravingItem* item2)
+{
+    switch (item1->type()) {
     case ElementType::NOTE:
         return computeNoteKerningType(toNote(item1), item2);
     case ElementType::STEM_SLASH:
@@ -39,17 +39,23 @@ class HorizontalSpacing
 public:
     static double computePadding(const EngravingItem* item1, const EngravingItem* item2);
     static KerningType computeKerning(const EngravingItem* item1, const EngravingItem* item2);
+    static size_t spacingHash(const EngravingItem* item);
 
 private:
     static bool isSpecialNotePaddingType(ElementType type);
     static void computeNotePadding(const Note* note, const EngravingItem* item2, double& padding, double scaling);
     static void computeLedgerRestPadding(const Rest* rest2, double& padding);
 
-    static bool isSameVoiceKerningLimited(const EngravingItem* item);
-    static bool isNeverKernable(const EngravingItem* item);
-    static bool isAlwaysKernable(const EngravingItem* item);
+    struct KerningTable;
+    static const KerningTable& kerningTable();
+    static KerningTable createKerningTable();
 
-    static KerningType doComputeKerningType(const EngravingItem* item1, const EngravingItem* item2);
+    static bool isSameVoiceKerningLimited(ElementType type);
+    static bool isNeverKernable(ElementType type);
+    static bool isAlwaysKernable(ElementType type);
+
+    static KerningType computeKerningType(ElementType type1, ElementType type2);
+    static KerningType computeItemKerningType(const EngravingItem* item1, const EngravingItem* item2);
     static KerningType computeNoteKerningType(const Note* note, const EngravingItem* item2);
     static KerningType computeStemSlashKerningType(const StemSlash* stemSlash, const EngravingItem* item2);
 };
@@ -373,6 +373,14 @@ const std::set<Spanner*>& DomAccessor::unmanagedSpanners() const
     return score()->unmanagedSpanners();
 }
 
+void DomAccessor::setProgressiveLayoutPending(bool v)
+{
+    IF_ASSERT_FAILED(score()) {
+        return;
+    }
+    score()->setProgressiveLayoutPending(v);
+}
+
 // =============================================================
 // LayoutContext
 // =============================================================
@@ -429,6 +437,15 @@ LayoutState& LayoutContext::mutState()
     return m_state;
 }
 
+LayoutCache& LayoutContext::mutCache()
+{
+    IF_ASSERT_FAILED(m_score) {
+        static LayoutCache dummy;
+        return dummy;
+    }
+    return m_score->layoutCache();
+}
+
 void LayoutContext::setLayout(const Fraction& tick1, const Fraction& tick2, staff_idx_t staff1, staff_idx_t staff2, const EngravingItem* e)
 {
     IF_ASSERT_FAILED(m_score) {
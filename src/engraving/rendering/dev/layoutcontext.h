@@ -32,6 +32,7 @@
 #include "iengravingfont.h"
 #include "dom/mscore.h"
 
+#include "../layoutcache.h"
 #include "../layoutoptions.h"
 
 namespace mu::engraving {
@@ -84,6 +85,8 @@ public:
 
     bool isShowVBox() const { return options().isShowVBox; }
     double noteHeadWidth() const { return options().noteHeadWidth; }
+    bool isParallelLayout() const { return options().isParallelLayout; }
+    size_t maxPages() const { return options().maxPages; }
     bool isShowInvisible() const;
     int pageNumberOffset() const;
     bool isVerticalSpreadEnabled() const;
@@ -177,6 +180,8 @@ public:
     void addUnmanagedSpanner(Spanner* s);
     const std::set<Spanner*>& unmanagedSpanners() const;
 
+    void setProgressiveLayoutPending(bool v);
+
 private:
     const Score* score() const;
     Score* score();
@@ -283,7 +288,7 @@ private:
     bool m_rangeDone = false;
 
     // cache
-    double m_totalBracketsWidth = -1.0;
+    double m_totalBracketsWidth = -1.0;     // see also LayoutCache
 };
 
 class LayoutContext : public IGetScoreInternal
@@ -309,6 +314,9 @@ public:
     const LayoutState& state() const;
     LayoutState& mutState();
 
+    // Cache, kept by the score between layouts
+    LayoutCache& mutCache();
+
     // Mark
     void setLayout(const Fraction& tick1, const Fraction& tick2, staff_idx_t staff1, staff_idx_t staff2, const EngravingItem* e);
     void addRefresh(const mu::RectF& r);
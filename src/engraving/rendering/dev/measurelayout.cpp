@@ -21,6 +21,8 @@
  */
 #include "measurelayout.h"
 
+#include "hashutils.h"
+
 #include "dom/ambitus.h"
 #include "dom/barline.h"
 #include "dom/beam.h"
@@ -50,6 +52,7 @@
 #include "layoutcontext.h"
 #include "beamlayout.h"
 #include "chordlayout.h"
+#include "horizontalspacing.h"
 #include "slurtielayout.h"
 
 #include "log.h"
@@ -2174,10 +2177,10 @@ void MeasureLayout::computeWidth(Measure* m, LayoutContext& ctx, Segment* s, dou
         if (ns) {
             if (isSystemHeader && (ns->isStartRepeatBarLineType() || ns->isChordRestType() || (ns->isClefType() && !ns->header()))) {
                 // this is the system header gap
-                w = s->minHorizontalDistance(ns, true);
+                w = minHorizontalDistance(s, ns, true, ctx);
                 isSystemHeader = false;
             } else {
-                w = s->minHorizontalDistance(ns, false);
+                w = minHorizontalDistance(s, ns, false, ctx);
                 if (s->isChordRestType()) {
                     Segment* ps = s->prevActive();
                     double durStretch = s->computeDurationStretch(ps, minTicks, maxTicks);
@@ -2214,7 +2217,7 @@ void MeasureLayout::computeWidth(Measure* m, LayoutContext& ctx, Segment* s, dou
             }
 
             // look back for collisions with previous segments
-            // this is time consuming (ca. +5%) and probably requires more optimization
+            // this is time consuming (ca. +5%), the distances are cached per layout (see minHorizontalCollidingDistance)
             if (s == fs) {     // don't let the second segment cross measure start (not covered by the loop below)
                 w = std::max(w, ns->minLeft(ls) - s->x());
             }
@@ -2229,7 +2232,7 @@ void MeasureLayout::computeWidth(Measure* m, LayoutContext& ctx, Segment* s, dou
                     continue;
                 }
 
-                double ww = ps->minHorizontalCollidingDistance(ns) - (s->x() - ps->x());
+                double ww = minHorizontalCollidingDistance(ps, ns, ctx) - (s->x() - ps->x());
                 if (ps == fs) {
                     ww = std::max(ww, ns->minLeft(ls) - s->x());
                 }
@@ -2291,6 +2294,99 @@ void MeasureLayout::computeWidth(Measure* m, LayoutContext& ctx, Segment* s, dou
     }
 }
 
+//---------------------------------------------------------
+//   minHorizontalDistance
+//   minHorizontalCollidingDistance
+//    While collecting a system, the width of the same measure
+//    is computed many times (each time the shortest note of the
+//    system changes, for justification, for narrow spacing...),
+//    but the distances between its segments only depend on their
+//    shapes and on the spacing of their items. So they are kept
+//    by the score across layouts (see LayoutCache), keyed by the
+//    positions of the segments and a hash of their shapes and of
+//    the padding and kerning inputs of their items, and recomputed
+//    only when one of them has changed. Style, spatium and font
+//    changes drop them.
+//---------------------------------------------------------
+
+// the entries of segments that were edited are not removed, so the cache is dropped when it has grown too much
+static constexpr size_t MAX_SEGMENT_DISTANCES = 128 * 1024;
+
+enum class SegmentDistanceKind {
+    Minimal = 0,
+    MinimalHeaderGap,
+    Colliding
+};
+
+static size_t segmentShapesHash(const Segment* s)
+{
+    size_t seed = 0;
+    for (const Shape& shape : s->shapes()) {
+        hashCombine(seed, shape.contentHash());
+        for (const ShapeElement& r : shape) {
+            if (r.toItem) {
+                hashCombine(seed, HorizontalSpacing::spacingHash(r.toItem));
+            }
+        }
+    }
+    return seed;
+}
+
+static LayoutCache::SegmentId segmentId(const Segment* s)
+{
+    if (!s) {
+        return { static_cast<int>(SegmentType::Invalid), Fraction(-1, 1), Fraction(-1, 1), false };
+    }
+    const Measure* m = s->measure();
+    return { static_cast<int>(s->segmentType()), s->tick(), m->tick(), m->isMMRest() };
+}
+
+static LayoutCache::SegmentDistanceKey segmentDistanceKey(const Segment* s, const Segment* ns, SegmentDistanceKind kind)
+{
+    size_t hash = segmentShapesHash(s);
+    if (ns) {
+        hashCombine(hash, segmentShapesHash(ns));
+    }
+    return { segmentId(s), segmentId(ns), static_cast<int>(kind), hash };
+}
+
+double MeasureLayout::minHorizontalDistance(const Segment* s, Segment* ns, bool systemHeaderGap, LayoutContext& ctx)
+{
+    SegmentDistanceKind kind = systemHeaderGap ? SegmentDistanceKind::MinimalHeaderGap : SegmentDistanceKind::Minimal;
+    LayoutCache::SegmentDistanceKey key = segmentDistanceKey(s, ns, kind);
+
+    std::map<LayoutCache::SegmentDistanceKey, double>& cache = ctx.mutCache().segmentDistances;
+    auto it = cache.find(key);
+    if (it != cache.end()) {
+        return it->second;
+    }
+
+    double distance = s->minHorizontalDistance(ns, systemHeaderGap);
+    if (cache.size() >= MAX_SEGMENT_DISTANCES) {
+        cache.clear();
+    }
+    cache.emplace(key, distance);
+    return distance;
+}
+
+double MeasureLayout::minHorizontalCollidingDistance(const Segment* s, Segment* ns, LayoutContext& ctx)
+{
+    LayoutCache::SegmentDistanceKey key = segmentDistanceKey(s, ns, SegmentDistanceKind::Colliding);
+
+    std::map<LayoutCache::SegmentDistanceKey, double>& cache = ctx.mutCache().segmentDistances;
+    auto it = cache.find(key);
+    if (it != cache.end()) {
+        return it->second;
+    }
+
+    double distance = s->minHorizontalCollidingDistance(ns);
+    if (cache.size() >= MAX_SEGMENT_DISTANCES) {
+        cache.clear();
+    }
+    cache.emplace(key, distance);
+    return distance;
+}
+
 double MeasureLayout::computeMinMeasureWidth(Measure* m, LayoutContext& ctx)
 {
     double minWidth = ctx.conf().styleMM(Sid::minMeasureWidth);
@@ -76,6 +76,9 @@ private:
 
     static double computeMinMeasureWidth(Measure* m, LayoutContext& ctx);
 
+    static double minHorizontalDistance(const Segment* s, Segment* ns, bool systemHeaderGap, LayoutContext& ctx);
+    static double minHorizontalCollidingDistance(const Segment* s, Segment* ns, LayoutContext& ctx);
+
     static void layoutPartialWidth(StaffLines* lines, LayoutContext& ctx, double w, double wPartial, bool alignLeft);
 };
 }
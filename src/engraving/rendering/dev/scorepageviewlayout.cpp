@@ -158,9 +158,12 @@ void ScorePageViewLayout::layoutPageView(Score* score, LayoutContext& ctx, const
 void ScorePageViewLayout::doLayout(LayoutContext& ctx)
 {
     const MeasureBase* lmb = nullptr;
+    const size_t maxPages = ctx.conf().maxPages();
+    size_t pages = 0;
     do {
         PageLayout::getNextPage(ctx);
         PageLayout::collectPage(ctx);
+        ++pages;
 
         if (ctx.state().page() && !ctx.state().page()->systems().empty()) {
             lmb = ctx.state().page()->systems().back()->measures().back();
@@ -177,10 +180,14 @@ void ScorePageViewLayout::doLayout(LayoutContext& ctx)
         //    c) this page ends with the same measure as the previous layout
         //    pageOldMeasure will be last measure from previous layout if range was completed on or before this page
         //    it will be nullptr if this page was never laid out or if we collected a system for next page
-    } while (ctx.state().curSystem() && !(ctx.state().rangeDone() && lmb == ctx.state().pageOldMeasure()));
+        // or
+        // 3) we have reached the page limit of a progressive layout (the rest is laid out by the next call)
+    } while (ctx.state().curSystem() && !(ctx.state().rangeDone() && lmb == ctx.state().pageOldMeasure())
+             && !(maxPages && pages >= maxPages));
     // && page->system(0)->measures().back()->tick() > endTick // FIXME: perhaps the first measure was meant? Or last system?
 
     if (!ctx.state().curSystem()) {
+        ctx.mutDom().setProgressiveLayoutPending(false);
         // The end of the score. The remaining systems are not needed...
         DeleteAll(ctx.mutState().systemList());
         ctx.mutState().systemList().clear();
@@ -191,6 +198,10 @@ void ScorePageViewLayout::doLayout(LayoutContext& ctx)
             delete p;
         }
     } else {
+        // a layout of a range that reached a point of stability leaves a pending rest as it is
+        if (maxPages && pages >= maxPages) {
+            ctx.mutDom().setProgressiveLayoutPending(true);
+        }
         Page* p = ctx.mutState().curSystem()->page();
         if (p && (p != ctx.state().page())) {
             p->invalidateBspTree();
@@ -22,6 +22,8 @@
 #include "systemlayout.h"
 
 #include "realfn.h"
+#include "hashutils.h"
+#include "concurrency/taskscheduler.h"
 
 #include "style/defaultstyle.h"
 
@@ -69,6 +71,9 @@
 using namespace mu::engraving;
 using namespace mu::engraving::rendering::dev;
 
+// below this number of staves it is cheaper to build the skylines on the calling thread
+static constexpr size_t PARALLEL_SKYLINES_MIN_STAVES = 8;
+
 //---------------------------------------------------------
 //   collectSystem
 //---------------------------------------------------------
@@ -693,6 +698,122 @@ void SystemLayout::hideEmptyStaves(System* system, LayoutContext& ctx, bool isFi
     }
 }
 
+//---------------------------------------------------------
+//   createSkyline
+//    builds the skyline of a staff of the system from its
+//    laid out elements; only writes to that skyline, so the
+//    skylines of different staves can be built concurrently
+//---------------------------------------------------------
+
+void SystemLayout::createSkyline(System* system, staff_idx_t staffIdx, LayoutContext& ctx)
+{
+    SysStaff* ss = system->staff(staffIdx);
+    Skyline& skyline = ss->skyline();
+    skyline.clear();
+    // nothing reads the skyline until all elements are added, so merge them in one pass
+    skyline.beginBatch();
+    for (MeasureBase* mb : system->measures()) {
+        if (!mb->isMeasure()) {
+            continue;
+        }
+        Measure* m = toMeasure(mb);
+        MeasureNumber* mno = m->noText(staffIdx);
+        MMRestRange* mmrr  = m->mmRangeText(staffIdx);
+        // no need to build skyline outside of range in continuous view
+        if (ctx.conf().isLinearMode() && (m->tick() < ctx.state().startTick() || m->tick() > ctx.state().endTick())) {
+            continue;
+        }
+        if (mno && mno->addToSkyline()) {
+            ss->skyline().add(mno->layoutData()->bbox().translated(m->pos() + mno->pos()));
+        }
+        if (mmrr && mmrr->addToSkyline()) {
+            ss->skyline().add(mmrr->layoutData()->bbox().translated(m->pos() + mmrr->pos()));
+        }
+        if (m->staffLines(staffIdx)->addToSkyline()) {
+            ss->skyline().add(m->staffLines(staffIdx)->layoutData()->bbox().translated(m->pos()));
+        }
+        for (Segment& s : m->segments()) {
+            if (!s.enabled()) {
+                continue;
+            }
+            PointF p(s.pos() + m->pos());
+            if (s.segmentType()
+                & (SegmentType::BarLine | SegmentType::EndBarLine | SegmentType::StartRepeatBarLine | SegmentType::BeginBarLine)) {
+                BarLine* bl = toBarLine(s.element(staffIdx * VOICES));
+                if (bl && bl->addToSkyline()) {
+                    RectF r = TLayout::layoutRect(bl, ctx);
+                    skyline.add(r.translated(bl->pos() + p));
+                }
+            } else if (s.segmentType() & SegmentType::TimeSig) {
+                TimeSig* ts = toTimeSig(s.element(staffIdx * VOICES));
+                if (ts && ts->addToSkyline()) {
+                    skyline.add(ts->shape().translate(ts->pos() + p));
+                }
+            } else {
+                track_idx_t strack = staffIdx * VOICES;
+                track_idx_t etrack = strack + VOICES;
+                for (EngravingItem* e : s.elist()) {
+                    if (!e) {
+                        continue;
+                    }
+                    track_idx_t effectiveTrack = e->vStaffIdx() * VOICES + e->voice();
+                    if (effectiveTrack < strack || effectiveTrack >= etrack) {
+                        continue;
+                    }
+
+                    // add element to skyline
+                    if (e->addToSkyline()) {
+                        skyline.add(e->shape().translated(e->pos() + p));
+                        // add grace notes to skyline
+                        if (e->isChord()) {
+                            GraceNotesGroup& graceBefore = toChord(e)->graceNotesBefore();
+                            GraceNotesGroup& graceAfter = toChord(e)->graceNotesAfter();
+                            if (!graceBefore.empty()) {
+                                skyline.add(graceBefore.shape().translated(graceBefore.pos() + p));
+                            }
+                            if (!graceAfter.empty()) {
+                                skyline.add(graceAfter.shape().translated(graceAfter.pos() + p));
+                            }
+                        }
+                        // If present, add ornament cue note to skyline
+                        if (e->isChord()) {
+                            Ornament* ornament = toChord(e)->findOrnament();
+                            if (ornament) {
+                                Chord* cue = ornament->cueNoteChord();
+                                if (cue && cue->upNote()->visible()) {
+                                    skyline.add(cue->shape().translate(cue->pos() + p));
+                                }
+                            }
+                        }
+                    }
+
+                    // add tremolo to skyline
+                    if (e->isChord() && toChord(e)->tremolo()) {
+                        Tremolo* t = toChord(e)->tremolo();
+                        Chord* c1 = t->chord1();
+                        Chord* c2 = t->chord2();
+                        if (!t->twoNotes() || (c1 && !c1->staffMove() && c2 && !c2->staffMove())) {
+                            if (t->chord() == e && t->addToSkyline()) {
+                                skyline.add(t->shape().translate(t->pos() + e->pos() + p));
+                            }
+                        }
+                    }
+
+                    // add beams to skline
+                    if (e->isChordRest()) {
+                        ChordRest* cr = toChordRest(e);
+                        if (BeamLayout::isTopBeam(cr)) {
+                            Beam* b = cr->beam();
+                            b->addSkyline(skyline);
+                        }
+                    }
+                }
+            }
+        }
+    }
+    skyline.endBatch();
+}
+
 void SystemLayout::layoutSystemElements(System* system, LayoutContext& ctx)
 {
     if (ctx.dom().nstaves() == 0) {
@@ -754,110 +875,28 @@ void SystemLayout::layoutSystemElements(System* system, LayoutContext& ctx)
 
     //-------------------------------------------------------------
     //    create skylines
+    //    every staff has its own skyline, so in parallel layout mode
+    //    they are built concurrently, a whole staff per task
+    //    (but not from a worker of the pool itself: waiting there
+    //    for nested tasks could starve the pool)
     //-------------------------------------------------------------
 
-    for (size_t staffIdx = 0; staffIdx < ctx.dom().nstaves(); ++staffIdx) {
-        SysStaff* ss = system->staff(staffIdx);
-        Skyline& skyline = ss->skyline();
-        skyline.clear();
-        for (MeasureBase* mb : system->measures()) {
-            if (!mb->isMeasure()) {
-                continue;
-            }
-            Measure* m = toMeasure(mb);
-            MeasureNumber* mno = m->noText(staffIdx);
-            MMRestRange* mmrr  = m->mmRangeText(staffIdx);
-            // no need to build skyline outside of range in continuous view
-            if (ctx.conf().isLinearMode() && (m->tick() < ctx.state().startTick() || m->tick() > ctx.state().endTick())) {
-                continue;
-            }
-            if (mno && mno->addToSkyline()) {
-                ss->skyline().add(mno->layoutData()->bbox().translated(m->pos() + mno->pos()));
-            }
-            if (mmrr && mmrr->addToSkyline()) {
-                ss->skyline().add(mmrr->layoutData()->bbox().translated(m->pos() + mmrr->pos()));
-            }
-            if (m->staffLines(staffIdx)->addToSkyline()) {
-                ss->skyline().add(m->staffLines(staffIdx)->layoutData()->bbox().translated(m->pos()));
-            }
-            for (Segment& s : m->segments()) {
-                if (!s.enabled()) {
-                    continue;
-                }
-                PointF p(s.pos() + m->pos());
-                if (s.segmentType()
-                    & (SegmentType::BarLine | SegmentType::EndBarLine | SegmentType::StartRepeatBarLine | SegmentType::BeginBarLine)) {
-                    BarLine* bl = toBarLine(s.element(staffIdx * VOICES));
-                    if (bl && bl->addToSkyline()) {
-                        RectF r = TLayout::layoutRect(bl, ctx);
-                        skyline.add(r.translated(bl->pos() + p));
-                    }
-                } else if (s.segmentType() & SegmentType::TimeSig) {
-                    TimeSig* ts = toTimeSig(s.element(staffIdx * VOICES));
-                    if (ts && ts->addToSkyline()) {
-                        skyline.add(ts->shape().translate(ts->pos() + p));
-                    }
-                } else {
-                    track_idx_t strack = staffIdx * VOICES;
-                    track_idx_t etrack = strack + VOICES;
-                    for (EngravingItem* e : s.elist()) {
-                        if (!e) {
-                            continue;
-                        }
-                        track_idx_t effectiveTrack = e->vStaffIdx() * VOICES + e->voice();
-                        if (effectiveTrack < strack || effectiveTrack >= etrack) {
-                            continue;
-                        }
-
-                        // add element to skyline
-                        if (e->addToSkyline()) {
-                            skyline.add(e->shape().translated(e->pos() + p));
-                            // add grace notes to skyline
-                            if (e->isChord()) {
-                                GraceNotesGroup& graceBefore = toChord(e)->graceNotesBefore();
-                                GraceNotesGroup& graceAfter = toChord(e)->graceNotesAfter();
-                                if (!graceBefore.empty()) {
-                                    skyline.add(graceBefore.shape().translated(graceBefore.pos() + p));
-                                }
-                                if (!graceAfter.empty()) {
-                                    skyline.add(graceAfter.shape().translated(graceAfter.pos() + p));
-                                }
-                            }
-                            // If present, add ornament cue note to skyline
-                            if (e->isChord()) {
-                                Ornament* ornament = toChord(e)->findOrnament();
-                                if (ornament) {
-                                    Chord* cue = ornament->cueNoteChord();
-                                    if (cue && cue->upNote()->visible()) {
-                                        skyline.add(cue->shape().translate(cue->pos() + p));
-                                    }
-                                }
-                            }
-                        }
-
-                        // add tremolo to skyline
-                        if (e->isChord() && toChord(e)->tremolo()) {
-                            Tremolo* t = toChord(e)->tremolo();
-                            Chord* c1 = t->chord1();
-                            Chord* c2 = t->chord2();
-                            if (!t->twoNotes() || (c1 && !c1->staffMove() && c2 && !c2->staffMove())) {
-                                if (t->chord() == e && t->addToSkyline()) {
-                                    skyline.add(t->shape().translate(t->pos() + e->pos() + p));
-                                }
-                            }
-                        }
-
-                        // add beams to skline
-                        if (e->isChordRest()) {
-                            ChordRest* cr = toChordRest(e);
-                            if (BeamLayout::isTopBeam(cr)) {
-                                Beam* b = cr->beam();
-                                b->addSkyline(skyline);
-                            }
-                        }
-                    }
-                }
-            }
+    const size_t nstaves = ctx.dom().nstaves();
+    if (ctx.conf().isParallelLayout() && nstaves >= PARALLEL_SKYLINES_MIN_STAVES
+        && !TaskScheduler::instance()->containsThread(std::this_thread::get_id())) {
+        std::vector<std::future<void> > futures;
+        futures.reserve(nstaves);
+        for (staff_idx_t staffIdx = 0; staffIdx < nstaves; ++staffIdx) {
+            futures.push_back(TaskScheduler::instance()->submit([system, staffIdx, &ctx]() {
+                createSkyline(system, staffIdx, ctx);
+            }));
+        }
+        for (std::future<void>& f : futures) {
+            f.get();
+        }
+    } else {
+        for (staff_idx_t staffIdx = 0; staffIdx < nstaves; ++staffIdx) {
+            createSkyline(system, staffIdx, ctx);
         }
     }
 
@@ -1800,6 +1839,34 @@ double SystemLayout::instrumentNamesWidth(System* system, LayoutContext& ctx, bo
     return namesWidth;
 }
 
+//---------------------------------------------------------
+//   bracketsKey
+//    Hash of everything the width of the brackets depends
+//    on, apart from the style
+//---------------------------------------------------------
+
+static size_t bracketsKey(const LayoutContext& ctx)
+{
+    size_t key = ctx.dom().nstaves();
+    auto combine = [&key](size_t v) { hashCombine(key, v); };
+    for (const Staff* staff : ctx.dom().staves()) {
+        combine(staff->show());
+        // the brackets are laid out with the spatium and the lines of the staves they span
+        combine(std::hash<double>()(staff->staffMag(Fraction(0, 1))));
+        const StaffType* staffType = staff->staffType(Fraction(0, 1));
+        combine(static_cast<size_t>(staffType->group()));
+        combine(static_cast<size_t>(staffType->lines()));
+        combine(std::hash<double>()(staffType->lineDistance().val()));
+        for (const BracketItem* bi : staff->brackets()) {
+            combine(static_cast<size_t>(bi->bracketType()));
+            combine(bi->bracketSpan());
+            combine(bi->column());
+            combine(bi->visible());
+        }
+    }
+    return key;
+}
+
 /// Calculates the total width of all brackets together that
 /// would be visible when all staves are visible.
 /// The logic in this method is closely related to the logic in
@@ -1810,6 +1877,14 @@ double SystemLayout::totalBracketOffset(LayoutContext& ctx)
         return ctx.state().totalBracketsWidth();
     }
 
+    // creating and laying out the brackets is expensive, reuse the width of the previous layout
+    LayoutCache& cache = ctx.mutCache();
+    const size_t key = bracketsKey(ctx);
+    if (cache.totalBracketsWidth >= 0 && cache.bracketsKey == key) {
+        ctx.mutState().setTotalBracketsWidth(cache.totalBracketsWidth);
+        return cache.totalBracketsWidth;
+    }
+
     size_t columns = 0;
     for (const Staff* staff : ctx.dom().staves()) {
         for (const BracketItem* bi : staff->brackets()) {
@@ -1869,6 +1944,8 @@ double SystemLayout::totalBracketOffset(LayoutContext& ctx)
         totalBracketsWidth = std::max(totalBracketsWidth, w);
     }
     ctx.mutState().setTotalBracketsWidth(totalBracketsWidth);
+    cache.bracketsKey = key;
+    cache.totalBracketsWidth = totalBracketsWidth;
 
     return totalBracketsWidth;
 }
@@ -62,6 +62,7 @@ public:
 private:
     static System* getNextSystem(LayoutContext& lc);
     static void processLines(System* system, LayoutContext& ctx, std::vector<Spanner*> lines, bool align);
+    static void createSkyline(System* system, staff_idx_t staffIdx, LayoutContext& ctx);
     static void layoutTies(Chord* ch, System* system, const Fraction& stick);
     static void doLayoutTies(System* system, std::vector<Segment*> sl, const Fraction& stick, const Fraction& etick);
     static void justifySystem(System* system, double curSysWidth, double targetSystemWidth);
@@ -0,0 +1,65 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2023 MuseScore BVBA and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef MU_ENGRAVING_LAYOUTCACHE_H
+#define MU_ENGRAVING_LAYOUTCACHE_H
+
+#include <cstddef>
+#include <map>
+#include <tuple>
+
+#include "types/fraction.h"
+#include "types/string.h"
+
+namespace mu::engraving {
+//---------------------------------------------------------
+//   LayoutCache
+//    Values derived from the score that the layout needs
+//    on every run, but that change rarely. Kept by the
+//    score between layouts; every value remembers the
+//    inputs it was computed from and is recomputed when
+//    they differ. reset() drops everything, it is called
+//    on style changes.
+//---------------------------------------------------------
+
+struct LayoutCache
+{
+    // engraving font and notehead width
+    String engravingFontName;
+    double spatium = 0.0;
+
+    // total width of the brackets in front of a system
+    size_t bracketsKey = 0;
+    double totalBracketsWidth = -1.0;
+
+    // horizontal distances between two segments, see MeasureLayout::minHorizontalDistance.
+    // Keyed by (segment, next segment, kind of distance, hash of the shapes and the spacing of their items).
+    // Segments are deleted and created again while laying out (e.g. headers, mmrests),
+    // so they are identified by their type, tick and measure rather than by their address
+    using SegmentId = std::tuple<int, Fraction, Fraction, bool>;
+    using SegmentDistanceKey = std::tuple<SegmentId, SegmentId, int, size_t>;
+    std::map<SegmentDistanceKey, double> segmentDistances;
+
+    void reset() { *this = LayoutCache(); }
+};
+}
+
+#endif // MU_ENGRAVING_LAYOUTCACHE_H
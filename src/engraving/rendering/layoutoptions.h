@@ -22,6 +22,8 @@
 #ifndef MU_ENGRAVING_LAYOUTOPTIONS_H
 #define MU_ENGRAVING_LAYOUTOPTIONS_H
 
+#include <cstddef>
+
 namespace mu::engraving {
 //---------------------------------------------------------
 //   LayoutMode
@@ -42,6 +44,13 @@ struct LayoutOptions
     bool isShowVBox = true;
     double noteHeadWidth = 0.0;
 
+    //! NOTE Lays out independent parts of systems (the skylines of their staves) on the worker pool
+    bool isParallelLayout = false;
+
+    //! NOTE If not zero, the page view layout stops after this number of pages,
+    //! the rest is laid out later by Score::layoutNextPages
+    size_t maxPages = 0;
+
     bool isMode(LayoutMode m) const { return mode == m; }
     bool isLinearMode() const { return mode == LayoutMode::LINE || mode == LayoutMode::HORIZONTAL_FIXED; }
 };
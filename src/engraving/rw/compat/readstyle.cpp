@@ -38,9 +38,9 @@ using namespace mu;
 using namespace mu::engraving::compat;
 using namespace mu::engraving;
 
-static int readStyleDefaultsVersion(MasterScore* score, const ByteArray& scoreData, const String& completeBaseName)
+static int readStyleDefaultsVersion(MasterScore* score, ByteArray scoreData, const String& completeBaseName)
 {
-    XmlReader e(scoreData);
+    XmlReader e(std::move(scoreData));
     e.setDocName(completeBaseName);
 
     while (!e.atEnd()) {
@@ -53,8 +53,8 @@ static int readStyleDefaultsVersion(MasterScore* score, const ByteArray& scoreDa
     return ReadStyleHook::styleDefaultByMscVersion(score->mscVersion());
 }
 
-ReadStyleHook::ReadStyleHook(Score* score, const ByteArray& scoreData, const String& completeBaseName)
-    : m_score(score), m_scoreData(scoreData), m_completeBaseName(completeBaseName)
+ReadStyleHook::ReadStyleHook(Score* score, std::function<ByteArray()> readScoreData, const String& completeBaseName)
+    : m_score(score), m_readScoreData(std::move(readScoreData)), m_completeBaseName(completeBaseName)
 {
 }
 
@@ -92,7 +92,7 @@ void ReadStyleHook::setupDefaultStyle()
 
     int defaultsVersion = -1;
     if (m_score->isMaster()) {
-        defaultsVersion = readStyleDefaultsVersion(m_score->masterScore(), m_scoreData, m_completeBaseName);
+        defaultsVersion = readStyleDefaultsVersion(m_score->masterScore(), m_readScoreData(), m_completeBaseName);
     } else {
         defaultsVersion = m_score->masterScore()->style().defaultStyleVersion();
     }
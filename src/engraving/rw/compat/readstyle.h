@@ -23,6 +23,8 @@
 #ifndef MU_ENGRAVING_READSTYLE_H
 #define MU_ENGRAVING_READSTYLE_H
 
+#include <functional>
+
 #include "types/bytearray.h"
 #include "types/string.h"
 
@@ -36,7 +38,7 @@ namespace mu::engraving::compat {
 class ReadStyleHook
 {
 public:
-    ReadStyleHook(Score* score, const ByteArray& scoreData, const String& completeBaseName);
+    ReadStyleHook(Score* score, std::function<ByteArray()> readScoreData, const String& completeBaseName);
 
     void setupDefaultStyle();
 
@@ -49,7 +51,7 @@ public:
 
 private:
     Score* m_score = nullptr;
-    const ByteArray& m_scoreData;
+    std::function<ByteArray()> m_readScoreData;
     const String& m_completeBaseName;
 };
 }
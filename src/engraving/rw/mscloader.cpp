@@ -23,12 +23,16 @@
 
 #include <memory>
 #include <map>
+#include <thread>
 
 #include "global/io/buffer.h"
+#include "global/concurrency/taskscheduler.h"
 #include "global/types/retval.h"
 
 #include "types/types.h"
 
+#include "../infrastructure/scorecache.h"
+
 #include "../dom/masterscore.h"
 #include "../dom/audio.h"
 #include "../dom/excerpt.h"
@@ -71,8 +75,115 @@ static RetVal<IReaderPtr> makeReader(int version, bool ignoreVersionError)
     return RetVal<IReaderPtr>::make_ok(RWRegister::reader(version));
 }
 
+//! NOTE The binary form of an unchanged score file is read instead of its XML, if it is cached.
+//! The data is passed over to the reader, which decodes the XML in place
+static ByteArray cachedScoreData(ByteArray scoreData)
+{
+    if (MScore::testMode) {
+        return scoreData;
+    }
+
+    return ScoreCache::resolve(scoreData);
+}
+
+struct ExcerptFiles {
+    ByteArray styleData;
+    ByteArray scoreData;
+};
+
+//! NOTE Reading the excerpt files is mostly decompression, which is independent per excerpt,
+//! so they are read on the worker pool. Parsing the excerpts links their elements
+//! to the master score, so it stays on the calling thread.
+//! A single .mscx file is scanned from its start for every embedded file, so it is read one by one
+static std::vector<ExcerptFiles> readExcerptFiles(const MscReader& mscReader, const std::vector<String>& names)
+{
+    auto readFiles = [&mscReader](const String& name) {
+        return ExcerptFiles { mscReader.readExcerptStyleFile(name), mscReader.readExcerptFile(name) };
+    };
+
+    TaskScheduler* scheduler = TaskScheduler::instance();
+    bool parallel = names.size() > 1
+                    && mscReader.params().mode != MscIoMode::XmlFile
+                    && !scheduler->containsThread(std::this_thread::get_id());
+
+    std::vector<ExcerptFiles> files;
+    files.reserve(names.size());
+
+    if (!parallel) {
+        for (const String& name : names) {
+            files.push_back(readFiles(name));
+        }
+        return files;
+    }
+
+    std::vector<std::future<ExcerptFiles> > futures;
+    futures.reserve(names.size());
+    for (const String& name : names) {
+        futures.push_back(scheduler->submit(readFiles, name));
+    }
+
+    for (std::future<ExcerptFiles>& future : futures) {
+        files.push_back(future.get());
+    }
+
+    return files;
+}
+
+struct DeferredExcerptsData {
+    ReadLinks links;
+    std::vector<ExcerptFiles> files;
+    bool ignoreVersionError = false;
+};
+
+//! NOTE Reads the style and the score of the excerpt named ex->name() into a new part score.
+//! The part is linked to the master score, but not added to it
+static Ret readExcerpt(Excerpt* ex, ExcerptFiles& files, const ReadLinks& masterLinks, bool ignoreVersionError)
+{
+    MasterScore* masterScore = ex->masterScore();
+    Score* partScore = masterScore->createScore();
+
+    //! NOTE The name may be read from the file too, the one of the file entry is applied afterwards
+    const String name = ex->name();
+    ex->setName(String());
+
+    compat::ReadStyleHook::setupDefaultStyle(partScore);
+
+    ex->setExcerptScore(partScore);
+
+    Buffer excerptStyleBuf(&files.styleData);
+    excerptStyleBuf.open(IODevice::ReadOnly);
+    partScore->style().read(&excerptStyleBuf);
+
+    XmlReader xml(cachedScoreData(std::move(files.scoreData)));
+    xml.setDocName(name);
+
+    ReadInOutData partReadInData;
+    partReadInData.links = masterLinks;
+
+    RetVal<IReaderPtr> reader = makeReader(masterScore->mscVersion(), ignoreVersionError);
+    if (!reader.ret) {
+        return reader.ret;
+    }
+
+    Err err = reader.val->readScore(partScore, xml, &partReadInData);
+    if (err == Err::NoError && xml.error() != XmlStreamReader::NoError) {
+        // the reader stops at an error outside of <Score> without reporting it
+        err = Err::FileBadFormat;
+    }
+
+    if (err != Err::NoError) {
+        return make_ret(err);
+    }
+
+    partScore->linkMeasures(masterScore);
+
+    ex->setName(name);
+
+    return make_ok();
+}
+
 mu::Ret MscLoader::loadMscz(MasterScore* masterScore, const MscReader& mscReader, SettingsCompat& settingsCompat,
-                            bool ignoreVersionError)
+                            bool ignoreVersionError, bool deferExcerpts)
 {
     TRACEFUNC;
 
@@ -120,12 +231,12 @@ mu::Ret MscLoader::loadMscz(MasterScore* masterScore, const MscReader& mscReader
 
     // Read score
     {
-        ByteArray scoreData = mscReader.readScoreFile();
         String docName = masterScore->fileInfo()->fileName().toString();
 
-        compat::ReadStyleHook styleHook(masterScore, scoreData, docName);
+        //! NOTE Only old scores read the defaults version of their style ahead, they read the file again
+        compat::ReadStyleHook styleHook(masterScore, [&mscReader]() { return mscReader.readScoreFile(); }, docName);
 
-        XmlReader xml(scoreData);
+        XmlReader xml(cachedScoreData(mscReader.readScoreFile()));
         xml.setDocName(docName);
 
         ret = readMasterScore(masterScore, xml, ignoreVersionError, &masterReadOutData, &styleHook);
@@ -134,44 +245,39 @@ mu::Ret MscLoader::loadMscz(MasterScore* masterScore, const MscReader& mscReader
     // Read excerpts
     if (ret && masterScore->mscVersion() >= 400) {
         std::vector<String> excerptNames = mscReader.excerptNames();
-        for (const String& excerptName : excerptNames) {
-            Score* partScore = masterScore->createScore();
-
-            compat::ReadStyleHook::setupDefaultStyle(partScore);
-
-            Excerpt* ex = new Excerpt(masterScore);
-            ex->setExcerptScore(partScore);
-
-            ByteArray excerptStyleData = mscReader.readExcerptStyleFile(excerptName);
-            Buffer excerptStyleBuf(&excerptStyleData);
-            excerptStyleBuf.open(IODevice::ReadOnly);
-            partScore->style().read(&excerptStyleBuf);
-
-            ByteArray excerptData = mscReader.readExcerptFile(excerptName);
-
-            XmlReader xml(excerptData);
-            xml.setDocName(excerptName);
-
-            ReadInOutData partReadInData;
-            partReadInData.links = masterReadOutData.links;
-
-            RetVal<IReaderPtr> reader = makeReader(masterScore->mscVersion(), ignoreVersionError);
-            if (!reader.ret) {
-                ret = reader.ret;
-                break;
-            }
-
-            Err err = reader.val->readScore(partScore, xml, &partReadInData);
-            ret =  make_ret(err);
-            if (!ret) {
-                break;
+        std::vector<ExcerptFiles> excerptFiles = readExcerptFiles(mscReader, excerptNames);
+
+        //! NOTE Excerpts of older versions are changed by the compatibility conversions below,
+        //! so they are read right away
+        if (deferExcerpts && masterScore->mscVersion() >= Constants::MSC_VERSION) {
+            auto data = std::make_shared<DeferredExcerptsData>();
+            data->links = masterReadOutData.links;
+            data->files = std::move(excerptFiles);
+            data->ignoreVersionError = ignoreVersionError;
+
+            for (size_t i = 0; i < excerptNames.size(); ++i) {
+                Excerpt* ex = new Excerpt(masterScore);
+                ex->setName(excerptNames.at(i));
+
+                masterScore->addDeferredExcerpt(ex, [data, i](Excerpt* excerpt) {
+                    Ret readRet = readExcerpt(excerpt, data->files.at(i), data->links, data->ignoreVersionError);
+                    data->files.at(i) = ExcerptFiles();
+                    return readRet;
+                });
             }
+        } else {
+            for (size_t i = 0; i < excerptNames.size(); ++i) {
+                Excerpt* ex = new Excerpt(masterScore);
+                ex->setName(excerptNames.at(i));
 
-            partScore->linkMeasures(masterScore);
-
-            ex->setName(excerptName);
+                ret = readExcerpt(ex, excerptFiles.at(i), masterReadOutData.links, ignoreVersionError);
+                if (!ret) {
+                    delete ex;
+                    break;
+                }
 
-            masterScore->addExcerpt(ex);
+                masterScore->addExcerpt(ex);
+            }
         }
     }
 
@@ -43,7 +43,10 @@ class MscLoader
 public:
     MscLoader() = default;
 
-    Ret loadMscz(MasterScore* score, const MscReader& mscReader, SettingsCompat& settingsCompat, bool ignoreVersionError);
+    //! NOTE With deferExcerpts the excerpts of a current version file are read on demand,
+    //! see MasterScore::loadDeferredExcerpts
+    Ret loadMscz(MasterScore* score, const MscReader& mscReader, SettingsCompat& settingsCompat, bool ignoreVersionError,
+                 bool deferExcerpts = false);
 
 private:
     friend class MasterScore;
@@ -45,6 +45,14 @@ bool MscSaver::writeMscz(MasterScore* score, MscWriter& mscWriter, bool onlySele
         return false;
     }
 
+    //! NOTE The deferred excerpts have to be written too.
+    //! If one of them couldn't be read, the saved file would miss that part, so nothing is saved
+    Ret ret = score->loadDeferredExcerpts();
+    if (!ret) {
+        LOGE() << "failed to read the deferred excerpts, err: " << ret.toString();
+        return false;
+    }
+
     // Write style of MasterScore
     {
         //! NOTE The style is writing to a separate file only for the master score.
@@ -148,39 +156,50 @@ bool MscSaver::writeMscz(MasterScore* score, MscWriter& mscWriter, bool onlySele
 
 bool MscSaver::exportPart(Score* partScore, MscWriter& mscWriter)
 {
-    // Write excerpt style as main
+    return writePart(preparePart(partScore), mscWriter);
+}
+
+MscSaver::PartData MscSaver::preparePart(Score* partScore)
+{
+    PartData partData;
+
+    // Excerpt style as main
     {
-        ByteArray excerptStyleData;
-        Buffer styleStyleBuf(&excerptStyleData);
+        Buffer styleStyleBuf(&partData.styleData);
         styleStyleBuf.open(IODevice::WriteOnly);
         partScore->style().write(&styleStyleBuf);
-
-        mscWriter.writeStyleFile(excerptStyleData);
     }
 
-    // Write excerpt as main score
+    // Excerpt as main score
     {
-        ByteArray excerptData;
-        Buffer excerptBuf(&excerptData);
+        Buffer excerptBuf(&partData.scoreData);
         excerptBuf.open(IODevice::WriteOnly);
 
         rw::RWRegister::writer()->writeScore(partScore, &excerptBuf, false);
-
-        mscWriter.writeScoreFile(excerptData);
     }
 
-    // Write thumbnail
+    // Thumbnail
     {
         if (!partScore->pages().empty()) {
             auto pixmap = partScore->createThumbnail();
 
-            ByteArray ba;
-            Buffer b(&ba);
+            Buffer b(&partData.thumbnailData);
             b.open(IODevice::WriteOnly);
             imageProvider()->saveAsPng(pixmap, &b);
-            mscWriter.writeThumbnailFile(ba);
         }
     }
 
+    return partData;
+}
+
+bool MscSaver::writePart(const PartData& partData, MscWriter& mscWriter)
+{
+    mscWriter.writeStyleFile(partData.styleData);
+    mscWriter.writeScoreFile(partData.scoreData);
+
+    if (!partData.thumbnailData.empty()) {
+        mscWriter.writeThumbnailFile(partData.thumbnailData);
+    }
+
     return true;
 }
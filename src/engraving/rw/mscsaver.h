@@ -39,6 +39,17 @@ public:
     bool writeMscz(MasterScore* score, MscWriter& mscWriter, bool onlySelection, bool doCreateThumbnail);
 
     bool exportPart(Score* partScore, MscWriter& mscWriter);
+
+    //! NOTE Exporting a part is split into preparing its data, which reads the score
+    //! and so must be done on the main thread, and writing it, which doesn't touch the score
+    struct PartData {
+        ByteArray styleData;
+        ByteArray scoreData;
+        ByteArray thumbnailData;
+    };
+
+    PartData preparePart(Score* partScore);
+    static bool writePart(const PartData& partData, MscWriter& mscWriter);
 };
 }
 
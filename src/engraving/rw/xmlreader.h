@@ -37,8 +37,8 @@ class XmlReader : public XmlStreamReader
 public:
 
     XmlReader() = default;
-    XmlReader(const mu::ByteArray& d)
-        : XmlStreamReader(d) {}
+    XmlReader(mu::ByteArray d)
+        : XmlStreamReader(std::move(d)) {}
     XmlReader(mu::io::IODevice* d)
         : XmlStreamReader(d) {}
 
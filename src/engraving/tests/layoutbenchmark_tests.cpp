@@ -0,0 +1,364 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2023 MuseScore BVBA and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+//! NOTE The layout benchmarks are disabled by default, because their results depend on the machine.
+//! Run them with:
+//!     engraving_tests --gtest_also_run_disabled_tests --gtest_filter=Engraving_LayoutBenchmarkTests.*
+//!
+//! Environment variables:
+//!     MU_LAYOUT_BENCHMARK_OUTPUT     - write the measured timings (ms) as json to this file
+//!     MU_LAYOUT_BENCHMARK_BASELINE   - compare with timings written by a previous run, fail on regressions
+//!     MU_LAYOUT_BENCHMARK_THRESHOLD  - allowed slowdown compared to the baseline, default 0.2 (20%)
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+
+#include "io/dir.h"
+#include "io/file.h"
+#include "serialization/json.h"
+
+#include "dom/chord.h"
+#include "dom/masterscore.h"
+#include "dom/measure.h"
+#include "dom/note.h"
+#include "dom/segment.h"
+#include "dom/undo.h"
+
+#include "rendering/dev/layoutcontext.h"
+#include "rendering/dev/passlayoutindependentitems.h"
+#include "rendering/dev/passresetlayoutdata.h"
+
+#include "utils/scorerw.h"
+
+#include "log.h"
+
+using namespace mu;
+using namespace mu::engraving;
+using namespace mu::engraving::rendering::dev;
+
+static const String VTEST_SCORES_DIR = String::fromUtf8(VTEST_SCORES_PATH);
+static const String SYNTHETIC_SOURCE_DIR(u"all_elements_data/");
+
+static constexpr int REPEATS = 3;
+static constexpr int SYNTHETIC_COPIES = 20;
+static constexpr double DEFAULT_THRESHOLD = 0.2;
+// timings below this are dominated by noise and not compared with the baseline
+static constexpr double MIN_COMPARABLE_MS = 5.0;
+// relayout after editing a single note must stay well below a full layout of a large score
+static constexpr double MAX_NOTE_EDIT_TO_FULL_RATIO = 0.5;
+
+class Engraving_LayoutBenchmarkTests : public ::testing::Test
+{
+public:
+    static void TearDownTestSuite()
+    {
+        writeResults();
+    }
+
+protected:
+    using Timings = std::vector<std::pair<std::string, double> >;
+
+    void report(const std::string& name, const Timings& timings);
+
+    static void writeResults();
+
+    static JsonObject s_results;
+};
+
+JsonObject Engraving_LayoutBenchmarkTests::s_results;
+
+//---------------------------------------------------------
+//   measureMs
+//    The best of several runs, in milliseconds; prepare()
+//    and cleanup() are called around each run and are not
+//    measured
+//---------------------------------------------------------
+
+static double measureMs(const std::function<void()>& func, const std::function<void()>& prepare = nullptr,
+                        const std::function<void()>& cleanup = nullptr)
+{
+    double best = -1.0;
+    for (int i = 0; i < REPEATS; ++i) {
+        if (prepare) {
+            prepare();
+        }
+        auto start = std::chrono::steady_clock::now();
+        func();
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        if (cleanup) {
+            cleanup();
+        }
+        if (best < 0.0 || ms < best) {
+            best = ms;
+        }
+    }
+    return best;
+}
+
+template<typename Pass>
+static void runPass(Score* score)
+{
+    score->cmdState().lock();
+    LayoutContext ctx(score);
+    ctx.mutState().setIsLayoutAll(true);
+    Pass pass;
+    pass.run(score, ctx);
+    score->cmdState().unlock();
+}
+
+//---------------------------------------------------------
+//   fullLayoutTimings
+//    Full layout and the passes it consists of. The passes
+//    are measured separately, the rest of the full layout
+//    is the layout of systems and pages.
+//---------------------------------------------------------
+
+static std::vector<std::pair<std::string, double> > fullLayoutTimings(Score* score)
+{
+    double full = measureMs([score]() { score->doLayout(); });
+    double reset = measureMs([score]() { runPass<PassResetLayoutData>(score); });
+    double independent = measureMs([score]() { runPass<PassLayoutIndependentItems>(score); });
+    score->doLayout();
+
+    return {
+        { "full", full },
+        { "resetLayoutData", reset },
+        { "layoutIndependentItems", independent },
+        { "systemsAndPages", std::max(0.0, full - reset - independent) },
+    };
+}
+
+static Note* firstNote(Measure* m)
+{
+    for (Segment* s = m->first(SegmentType::ChordRest); s; s = s->next(SegmentType::ChordRest)) {
+        for (EngravingItem* e : s->elist()) {
+            if (e && e->isChord()) {
+                return toChord(e)->upNote();
+            }
+        }
+    }
+    return nullptr;
+}
+
+//---------------------------------------------------------
+//   middleMeasure
+//    A measure with a note in the middle of the score, so
+//    that the edits cause a partial relayout
+//---------------------------------------------------------
+
+static Measure* middleMeasure(Score* score)
+{
+    std::vector<Measure*> measures;
+    for (Measure* m = score->firstMeasure(); m; m = m->nextMeasure()) {
+        if (firstNote(m)) {
+            measures.push_back(m);
+        }
+    }
+    return measures.empty() ? nullptr : measures.at(measures.size() / 2);
+}
+
+//---------------------------------------------------------
+//   readSyntheticScore
+//    The source score appended to itself several times
+//---------------------------------------------------------
+
+static MasterScore* readSyntheticScore(const String& fileName, int copies)
+{
+    MasterScore* score = ScoreRW::readScore(SYNTHETIC_SOURCE_DIR + fileName);
+    MasterScore* source = ScoreRW::readScore(SYNTHETIC_SOURCE_DIR + fileName);
+    if (!score || !source) {
+        delete score;
+        delete source;
+        return nullptr;
+    }
+
+    score->startCmd();
+    for (int i = 1; i < copies; ++i) {
+        score->appendScore(source, false, false);
+    }
+    score->endCmd();
+    score->doLayout();
+
+    delete source;
+    return score;
+}
+
+static double envThreshold()
+{
+    const char* value = std::getenv("MU_LAYOUT_BENCHMARK_THRESHOLD");
+    return value ? std::atof(value) : DEFAULT_THRESHOLD;
+}
+
+static JsonObject readBaseline()
+{
+    const char* path = std::getenv("MU_LAYOUT_BENCHMARK_BASELINE");
+    if (!path) {
+        return JsonObject();
+    }
+
+    ByteArray data;
+    Ret ret = io::File::readFile(io::path_t(path), data);
+    if (!ret) {
+        LOGE() << "failed read baseline: " << path << ", err: " << ret.toString();
+        return JsonObject();
+    }
+
+    std::string err;
+    JsonDocument doc = JsonDocument::fromJson(data, &err);
+    if (!err.empty()) {
+        LOGE() << "failed parse baseline: " << path << ", err: " << err;
+        return JsonObject();
+    }
+
+    return doc.rootObject();
+}
+
+//---------------------------------------------------------
+//   report
+//    Logs and stores the timings and fails if any of them
+//    is slower than the baseline by more than the threshold
+//---------------------------------------------------------
+
+void Engraving_LayoutBenchmarkTests::report(const std::string& name, const Timings& timings)
+{
+    static const JsonObject baseline = readBaseline();
+    static const double threshold = envThreshold();
+
+    JsonObject baseTimings;
+    if (baseline.contains(name)) {
+        baseTimings = baseline.value(name).toObject();
+    }
+
+    JsonObject result;
+    for (const auto& timing : timings) {
+        result.set(timing.first, timing.second);
+        LOGI() << name << " " << timing.first << ": " << timing.second << " ms";
+
+        if (!baseTimings.contains(timing.first)) {
+            continue;
+        }
+
+        double base = baseTimings.value(timing.first).toDouble();
+        if (base < MIN_COMPARABLE_MS) {
+            continue;
+        }
+
+        EXPECT_LE(timing.second, base * (1.0 + threshold))
+            << name << " " << timing.first << " regressed: " << timing.second << " ms, baseline: " << base << " ms";
+    }
+
+    s_results.set(name, result);
+}
+
+void Engraving_LayoutBenchmarkTests::writeResults()
+{
+    const char* path = std::getenv("MU_LAYOUT_BENCHMARK_OUTPUT");
+    if (!path || s_results.empty()) {
+        return;
+    }
+
+    Ret ret = io::File::writeFile(io::path_t(path), JsonDocument(s_results).toJson());
+    if (!ret) {
+        LOGE() << "failed write results: " << path << ", err: " << ret.toString();
+    }
+}
+
+/**
+ * @brief Engraving_LayoutBenchmarkTests_DISABLED_vtestScores
+ * @details Full layout of every score of the visual tests, split into the layout passes
+ */
+TEST_F(Engraving_LayoutBenchmarkTests, DISABLED_vtestScores)
+{
+    RetVal<io::paths_t> files = io::Dir::scanFiles(VTEST_SCORES_DIR, { "*.mscx", "*.mscz" },
+                                                   io::ScanMode::FilesInCurrentDir);
+    ASSERT_TRUE(files.ret);
+    ASSERT_FALSE(files.val.empty());
+
+    for (const io::path_t& file : files.val) {
+        MasterScore* score = ScoreRW::readScore(file.toString(), true);
+        if (!score) {
+            ADD_FAILURE() << "failed read: " << file.toStdString();
+            continue;
+        }
+
+        report("vtest/" + io::filename(file).toStdString(), fullLayoutTimings(score));
+
+        delete score;
+    }
+}
+
+/**
+ * @brief Engraving_LayoutBenchmarkTests_DISABLED_largeScores
+ * @details Full layout of large scores and the relayout after typical edits:
+ *          changing a single note, adding and removing a system break, transposing everything
+ */
+TEST_F(Engraving_LayoutBenchmarkTests, DISABLED_largeScores)
+{
+    for (const String& fileName : { String(u"moonlight.mscx"), String(u"layout_elements.mscx") }) {
+        MasterScore* score = readSyntheticScore(fileName, SYNTHETIC_COPIES);
+        ASSERT_TRUE(score);
+
+        Timings timings = fullLayoutTimings(score);
+        const double full = timings.front().second;
+
+        Measure* measure = middleMeasure(score);
+        ASSERT_TRUE(measure);
+
+        // every edit is undone after it is measured
+        EditData ed;
+        auto undo = [score, &ed]() { score->undoRedo(true, &ed); };
+        auto addBreak = [score, measure]() {
+            score->startCmd();
+            measure->undoSetLineBreak(true);
+            score->endCmd();
+        };
+
+        double noteEdit = measureMs([score, measure]() {
+            score->startCmd();
+            score->select(firstNote(measure));
+            score->upDown(true, UpDownMode::CHROMATIC);
+            score->endCmd();
+        }, nullptr, undo);
+        timings.push_back({ "noteEdit", noteEdit });
+
+        timings.push_back({ "addSystemBreak", measureMs(addBreak, nullptr, undo) });
+        timings.push_back({ "removeSystemBreak", measureMs(undo, addBreak) });
+
+        timings.push_back({ "transpose", measureMs([score]() {
+                score->startCmd();
+                score->cmdSelectAll();
+                score->transpose(TransposeMode::BY_INTERVAL, TransposeDirection::UP, Key::C, 4, true, true, true);
+                score->endCmd();
+            }, nullptr, undo) });
+
+        report("large/" + fileName.toStdString(), timings);
+
+        EXPECT_LE(noteEdit, full * MAX_NOTE_EDIT_TO_FULL_RATIO)
+            << fileName.toStdString() << ": relayout after a note edit " << noteEdit << " ms, full layout " << full << " ms";
+
+        delete score;
+    }
+}
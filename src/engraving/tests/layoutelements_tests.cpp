@@ -22,21 +22,31 @@
 
 #include <gtest/gtest.h>
 
+#include "dom/chord.h"
 #include "dom/masterscore.h"
 #include "dom/measure.h"
 #include "dom/page.h"
 #include "dom/rest.h"
 #include "dom/staff.h"
+#include "dom/skyline.h"
 #include "dom/system.h"
 #include "dom/tuplet.h"
 #include "dom/note.h"
 
+#include "compat/scoreaccess.h"
+#include "compat/mscxcompat.h"
+#include "infrastructure/localfileinfoprovider.h"
+
+#include "rendering/dev/layoutcontext.h"
+#include "rendering/dev/measurelayout.h"
+
 #include "utils/scorerw.h"
 
 #include "log.h"
 
 using namespace mu;
 using namespace mu::engraving;
+using namespace mu::engraving::rendering::dev;
 
 static const String ALL_ELEMENTS_DATA_DIR("all_elements_data/");
 
@@ -151,3 +161,225 @@ TEST_F(Engraving_LayoutElementsTests, tstLayoutCrossStaffArp)
 
     delete score;
 }
+
+/**
+ * @brief Engraving_LayoutElementsTests_tstProgressiveLayout
+ * @details A layout limited to the first page and continued later gives the same pages as a full layout
+ */
+TEST_F(Engraving_LayoutElementsTests, tstProgressiveLayout)
+{
+    MasterScore* score = ScoreRW::readScore(ALL_ELEMENTS_DATA_DIR + "moonlight.mscx");
+    EXPECT_TRUE(score);
+
+    const size_t pages = score->npages();
+    ASSERT_GT(pages, size_t(1));
+    EXPECT_TRUE(score->isLayoutComplete());
+
+    score->setMaxLayoutPages(1);
+    score->doLayout();
+    score->setMaxLayoutPages(0);
+    EXPECT_EQ(score->npages(), size_t(1));
+    EXPECT_FALSE(score->isLayoutComplete());
+
+    while (score->layoutNextPages(1)) {
+    }
+    EXPECT_TRUE(score->isLayoutComplete());
+    EXPECT_EQ(score->npages(), pages);
+
+    delete score;
+}
+
+/**
+ * @brief Engraving_LayoutElementsTests_tstProgressiveLayoutBeforeCmd
+ * @details A command started while the layout is limited to the first page can use every measure's system
+ */
+TEST_F(Engraving_LayoutElementsTests, tstProgressiveLayoutBeforeCmd)
+{
+    MasterScore* score = ScoreRW::readScore(ALL_ELEMENTS_DATA_DIR + "moonlight.mscx");
+    EXPECT_TRUE(score);
+
+    score->setMaxLayoutPages(1);
+    score->doLayout();
+    score->setMaxLayoutPages(0);
+    ASSERT_FALSE(score->isLayoutComplete());
+
+    score->startCmd();
+    EXPECT_TRUE(score->isLayoutComplete());
+
+    for (Measure* m = score->firstMeasureMM(); m; m = m->nextMeasureMM()) {
+        ASSERT_TRUE(m->system());
+        EXPECT_TRUE(m->system()->page());
+    }
+
+    score->endCmd();
+
+    delete score;
+}
+
+/**
+ * @brief Engraving_LayoutElementsTests_tstCmdOnScoreNotLaidOut
+ * @details A command started on a score that was never laid out, e.g. one that is still being built, doesn't lay it out
+ */
+TEST_F(Engraving_LayoutElementsTests, tstCmdOnScoreNotLaidOut)
+{
+    const io::path_t path = ScoreRW::rootPath() + u"/" + ALL_ELEMENTS_DATA_DIR + u"moonlight.mscx";
+    MasterScore* score = compat::ScoreAccess::createMasterScoreWithBaseStyle();
+    score->setFileInfoProvider(std::make_shared<LocalFileInfoProvider>(path));
+    ASSERT_TRUE(compat::loadMsczOrMscx(score, path.toString(), false));
+
+    EXPECT_TRUE(score->isLayoutComplete());
+
+    score->startCmd();
+    EXPECT_EQ(score->npages(), size_t(0));
+    EXPECT_FALSE(score->firstMeasure()->system());
+    score->endCmd(true);
+
+    delete score;
+}
+
+//---------------------------------------------------------
+//   systemsLayout
+//    the positions of all systems and staves and the
+//    segments of their skylines
+//---------------------------------------------------------
+
+static std::vector<double> systemsLayout(const Score* score)
+{
+    std::vector<double> result;
+    for (const System* system : score->systems()) {
+        result.push_back(system->y());
+        for (const SysStaff* ss : system->staves()) {
+            result.push_back(ss->y());
+            for (const SkylineLine* line : { &ss->skyline().north(), &ss->skyline().south() }) {
+                for (const SkylineSegment& s : *line) {
+                    result.insert(result.end(), { s.x, s.y, s.w });
+                }
+            }
+        }
+    }
+    return result;
+}
+
+/**
+ * @brief Engraving_LayoutElementsTests_tstParallelLayout
+ * @details The parallel layout of a score with many staves gives the same systems as the serial layout
+ */
+TEST_F(Engraving_LayoutElementsTests, tstParallelLayout)
+{
+    MasterScore* score = ScoreRW::readScore(u"midimapping_data/test1withDrums.mscx");
+    ASSERT_TRUE(score);
+    ASSERT_GE(score->nstaves(), size_t(8));
+    EXPECT_FALSE(score->layoutOptions().isParallelLayout);
+
+    score->doLayout();
+    const std::vector<double> serial = systemsLayout(score);
+    ASSERT_FALSE(serial.empty());
+
+    score->setParallelLayout(true);
+    score->doLayout();
+    EXPECT_EQ(systemsLayout(score), serial);
+
+    delete score;
+}
+
+/**
+ * @brief Engraving_LayoutElementsTests_tstSegmentDistancesCache
+ * @details The distances between segments cached by the score are found again for segments created anew,
+ *          and are not reused when the segments next to each other change
+ */
+TEST_F(Engraving_LayoutElementsTests, tstSegmentDistancesCache)
+{
+    MasterScore* score = ScoreRW::readScore(ALL_ELEMENTS_DATA_DIR + "moonlight.mscx");
+    ASSERT_TRUE(score);
+    ASSERT_GT(score->systems().size(), size_t(1));
+
+    Measure* m = score->systems().at(1)->firstMeasure();
+    ASSERT_TRUE(m);
+    ASSERT_TRUE(m->header());
+    const Fraction minTicks = m->shortestChordRest();
+    const Fraction maxTicks = m->maxTicks();
+
+    score->cmdState().lock();
+    {
+        LayoutContext ctx(score);
+        MeasureLayout::computeWidth(m, ctx, minTicks, maxTicks, 1);
+        const double width = m->width();
+        const size_t entries = score->layoutCache().segmentDistances.size();
+        EXPECT_GT(entries, size_t(0));
+
+        //! CHECK A header laid out again gives the same entries
+        MeasureLayout::removeSystemHeader(m);
+        MeasureLayout::addSystemHeader(m, false, ctx);
+        MeasureLayout::computeWidth(m, ctx, minTicks, maxTicks, 1);
+        EXPECT_DOUBLE_EQ(m->width(), width);
+        EXPECT_EQ(score->layoutCache().segmentDistances.size(), entries);
+
+        //! CHECK Without the key signature, the clef is next to other segments: the width is as without the cache
+        Segment* keySig = m->findFirstR(SegmentType::KeySig, Fraction(0, 1));
+        ASSERT_TRUE(keySig);
+        keySig->setEnabled(false);
+        MeasureLayout::computeWidth(m, ctx, minTicks, maxTicks, 1);
+        const double cachedWidth = m->width();
+
+        score->layoutCache().segmentDistances.clear();
+        MeasureLayout::computeWidth(m, ctx, minTicks, maxTicks, 1);
+        EXPECT_DOUBLE_EQ(cachedWidth, m->width());
+        EXPECT_GT(width, m->width());
+    }
+    score->cmdState().unlock();
+
+    delete score;
+}
+
+//---------------------------------------------------------
+//   measuresLayout
+//    the positions and widths of all measures
+//---------------------------------------------------------
+
+static std::vector<double> measuresLayout(const Score* score)
+{
+    std::vector<double> result;
+    for (const Measure* m = score->firstMeasureMM(); m; m = m->nextMeasureMM()) {
+        result.insert(result.end(), { m->x(), m->width() });
+    }
+    return result;
+}
+
+/**
+ * @brief Engraving_LayoutElementsTests_tstSegmentDistancesCacheAcrossLayouts
+ * @details The distances between segments are kept by the score from one layout to the next,
+ *          and a layout after an edit gives the same result as a layout without them
+ */
+TEST_F(Engraving_LayoutElementsTests, tstSegmentDistancesCacheAcrossLayouts)
+{
+    MasterScore* score = ScoreRW::readScore(ALL_ELEMENTS_DATA_DIR + "moonlight.mscx");
+    ASSERT_TRUE(score);
+    EXPECT_FALSE(score->layoutCache().segmentDistances.empty());
+
+    //! DO Make the first chord small, which changes its shape and the padding of its notes
+    Chord* chord = nullptr;
+    for (Segment* s = score->firstSegment(SegmentType::ChordRest); s && !chord; s = s->next1(SegmentType::ChordRest)) {
+        EngravingItem* e = s->element(0);
+        if (e && e->isChord()) {
+            chord = toChord(e);
+        }
+    }
+    ASSERT_TRUE(chord);
+    chord->setSmall(true);
+
+    //! CHECK The layout with the kept distances is the one without them
+    score->doLayout();
+    const std::vector<double> systems = systemsLayout(score);
+    const std::vector<double> measures = measuresLayout(score);
+
+    score->layoutCache().segmentDistances.clear();
+    score->doLayout();
+    EXPECT_EQ(systemsLayout(score), systems);
+    EXPECT_EQ(measuresLayout(score), measures);
+
+    //! CHECK A style change drops them
+    score->styleChanged();
+    EXPECT_TRUE(score->layoutCache().segmentDistances.empty());
+
+    delete score;
+}
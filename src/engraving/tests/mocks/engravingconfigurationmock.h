@@ -32,6 +32,10 @@ class EngravingConfigurationMock : public IEngravingConfiguration
 public:
     MOCK_METHOD(io::path_t, appDataPath, (), (const, override));
 
+    MOCK_METHOD(io::path_t, scoreCachePath, (), (const, override));
+
+    MOCK_METHOD(bool, isParallelLayoutEnabled, (), (const, override));
+
     MOCK_METHOD(io::path_t, defaultStyleFilePath, (), (const, override));
     MOCK_METHOD(void, setDefaultStyleFilePath, (const io::path_t&), (override));
 
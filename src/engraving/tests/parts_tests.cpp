@@ -22,6 +22,9 @@
 
 #include <gtest/gtest.h>
 
+#include <functional>
+#include <future>
+
 #include "dom/breath.h"
 #include "dom/chord.h"
 #include "dom/chordline.h"
@@ -39,10 +42,21 @@
 #include "dom/segment.h"
 #include "dom/spanner.h"
 
+#include "engraving/compat/scoreaccess.h"
+#include "engraving/infrastructure/localfileinfoprovider.h"
+#include "engraving/infrastructure/mscreader.h"
+#include "engraving/infrastructure/mscwriter.h"
+#include "engraving/rw/mscloader.h"
+#include "engraving/rw/mscsaver.h"
+
+#include "concurrency/taskscheduler.h"
+#include "io/buffer.h"
+
 #include "utils/scorerw.h"
 #include "utils/scorecomp.h"
 
 using namespace mu;
+using namespace mu::io;
 using namespace mu::engraving;
 
 static const String PARTS_DATA_DIR("parts_data/");
@@ -1289,3 +1303,293 @@ TEST_F(Engraving_PartsTests, staffStyles)
 }
 
 #endif
+
+//---------------------------------------------------------
+//   deferred excerpts
+//---------------------------------------------------------
+
+static const String DEFERRED_FILE_PATH(u"deferred.mscz");
+
+static ByteArray saveMscz(MasterScore* score, bool& ok)
+{
+    ByteArray msczData;
+    Buffer buf(&msczData);
+
+    MscWriter::Params params;
+    params.device = &buf;
+    params.filePath = DEFERRED_FILE_PATH;
+    params.mode = MscIoMode::Zip;
+
+    MscWriter writer(params);
+    writer.open();
+    ok = MscSaver().writeMscz(score, writer, false, false);
+    writer.close();
+
+    return msczData;
+}
+
+static MasterScore* loadMscz(ByteArray& msczData, bool deferExcerpts)
+{
+    MasterScore* score = compat::ScoreAccess::createMasterScoreWithBaseStyle();
+    score->setFileInfoProvider(std::make_shared<LocalFileInfoProvider>(DEFERRED_FILE_PATH));
+
+    Buffer buf(&msczData);
+    MscReader::Params params;
+    params.device = &buf;
+    params.filePath = DEFERRED_FILE_PATH;
+    params.mode = MscIoMode::Zip;
+
+    MscReader reader(params);
+    reader.open();
+
+    SettingsCompat settingsCompat;
+    Ret ret = MscLoader().loadMscz(score, reader, settingsCompat, false, deferExcerpts);
+    if (!ret) {
+        delete score;
+        return nullptr;
+    }
+
+    return score;
+}
+
+static std::vector<String> excerptNames(const MasterScore* score)
+{
+    std::vector<String> names;
+    for (const Excerpt* ex : score->excerpts()) {
+        names.push_back(ex->name());
+    }
+    return names;
+}
+
+TEST_F(Engraving_PartsTests, deferredExcerpts)
+{
+    //! GIVEN A current version file with parts
+    MasterScore* score = ScoreRW::readScore(PARTS_DATA_DIR + u"part-54346-parts.mscx");
+    ASSERT_TRUE(score);
+    ASSERT_FALSE(score->excerpts().empty());
+
+    bool ok = false;
+    ByteArray msczData = saveMscz(score, ok);
+    ASSERT_TRUE(ok);
+    delete score;
+
+    MasterScore* eagerScore = loadMscz(msczData, false);
+    ASSERT_TRUE(eagerScore);
+    EXPECT_FALSE(eagerScore->hasDeferredExcerpts());
+
+    //! DO Load it with deferred excerpts
+    MasterScore* deferredScore = loadMscz(msczData, true);
+    ASSERT_TRUE(deferredScore);
+
+    //! CHECK The excerpts are only read on demand, and then are the same as the eagerly read ones
+    EXPECT_TRUE(deferredScore->hasDeferredExcerpts());
+    EXPECT_TRUE(deferredScore->excerpts().empty());
+
+    EXPECT_TRUE(deferredScore->loadDeferredExcerpts());
+    EXPECT_FALSE(deferredScore->hasDeferredExcerpts());
+    EXPECT_FALSE(deferredScore->excerptsChanged());
+    EXPECT_EQ(excerptNames(deferredScore), excerptNames(eagerScore));
+
+    for (size_t i = 0; i < deferredScore->excerpts().size(); ++i) {
+        const Score* deferredPart = deferredScore->excerpts().at(i)->excerptScore();
+        const Score* eagerPart = eagerScore->excerpts().at(i)->excerptScore();
+
+        ASSERT_TRUE(deferredPart);
+        EXPECT_EQ(deferredPart->nstaves(), eagerPart->nstaves());
+        EXPECT_EQ(deferredPart->nmeasures(), eagerPart->nmeasures());
+    }
+
+    delete deferredScore;
+    delete eagerScore;
+}
+
+TEST_F(Engraving_PartsTests, deferredExcerptsSave)
+{
+    //! GIVEN A current version file with parts, loaded with deferred excerpts
+    MasterScore* score = ScoreRW::readScore(PARTS_DATA_DIR + u"part-54346-parts.mscx");
+    ASSERT_TRUE(score);
+
+    bool ok = false;
+    ByteArray msczData = saveMscz(score, ok);
+    ASSERT_TRUE(ok);
+    delete score;
+
+    MasterScore* deferredScore = loadMscz(msczData, true);
+    ASSERT_TRUE(deferredScore);
+    ASSERT_TRUE(deferredScore->hasDeferredExcerpts());
+
+    //! DO Save it without accessing the excerpts before
+    ByteArray resavedData = saveMscz(deferredScore, ok);
+    EXPECT_TRUE(ok);
+    delete deferredScore;
+
+    //! CHECK The parts are written as they were read
+    Buffer originBuf(&msczData);
+    MscReader::Params originParams;
+    originParams.device = &originBuf;
+    originParams.filePath = DEFERRED_FILE_PATH;
+    originParams.mode = MscIoMode::Zip;
+    MscReader originReader(originParams);
+    originReader.open();
+
+    Buffer resavedBuf(&resavedData);
+    MscReader::Params resavedParams;
+    resavedParams.device = &resavedBuf;
+    resavedParams.filePath = DEFERRED_FILE_PATH;
+    resavedParams.mode = MscIoMode::Zip;
+    MscReader resavedReader(resavedParams);
+    resavedReader.open();
+
+    std::vector<String> names = originReader.excerptNames();
+    EXPECT_FALSE(names.empty());
+    EXPECT_EQ(resavedReader.excerptNames(), names);
+
+    for (const String& name : names) {
+        EXPECT_EQ(resavedReader.readExcerptFile(name), originReader.readExcerptFile(name));
+        EXPECT_EQ(resavedReader.readExcerptStyleFile(name), originReader.readExcerptStyleFile(name));
+    }
+}
+
+TEST_F(Engraving_PartsTests, deferredExcerptsReadError)
+{
+    //! GIVEN A file with parts, where the first part is broken
+    MasterScore* score = ScoreRW::readScore(PARTS_DATA_DIR + u"part-54346-parts.mscx");
+    ASSERT_TRUE(score);
+
+    bool ok = false;
+    ByteArray msczData = saveMscz(score, ok);
+    ASSERT_TRUE(ok);
+    delete score;
+
+    ByteArray brokenData;
+    {
+        Buffer originBuf(&msczData);
+        MscReader::Params readerParams;
+        readerParams.device = &originBuf;
+        readerParams.filePath = DEFERRED_FILE_PATH;
+        readerParams.mode = MscIoMode::Zip;
+        MscReader reader(readerParams);
+        reader.open();
+
+        Buffer brokenBuf(&brokenData);
+        MscWriter::Params writerParams;
+        writerParams.device = &brokenBuf;
+        writerParams.filePath = DEFERRED_FILE_PATH;
+        writerParams.mode = MscIoMode::Zip;
+        MscWriter writer(writerParams);
+        writer.open();
+
+        writer.writeStyleFile(reader.readStyleFile());
+        writer.writeScoreFile(reader.readScoreFile());
+
+        std::vector<String> names = reader.excerptNames();
+        ASSERT_EQ(names.size(), 2);
+
+        writer.addExcerptStyleFile(names.at(0), reader.readExcerptStyleFile(names.at(0)));
+        writer.addExcerptFile(names.at(0), ByteArray("<museScore version=\"4.20\">\n<Score>\n<Staff id=\"1\">\n<Measure>\n"));
+
+        writer.addExcerptStyleFile(names.at(1), reader.readExcerptStyleFile(names.at(1)));
+        writer.addExcerptFile(names.at(1), reader.readExcerptFile(names.at(1)));
+
+        writer.close();
+    }
+
+    MasterScore* deferredScore = loadMscz(brokenData, true);
+    ASSERT_TRUE(deferredScore);
+
+    //! CHECK The broken part is dropped with an error, the other one is read
+    EXPECT_FALSE(deferredScore->loadDeferredExcerpts());
+    EXPECT_FALSE(deferredScore->hasDeferredExcerpts());
+    EXPECT_EQ(deferredScore->excerpts().size(), 1);
+
+    //! CHECK The error is kept, and saving doesn't write a file without the broken part
+    EXPECT_FALSE(deferredScore->loadDeferredExcerpts());
+
+    saveMscz(deferredScore, ok);
+    EXPECT_FALSE(ok);
+
+    delete deferredScore;
+}
+
+//---------------------------------------------------------
+//   exported parts
+//---------------------------------------------------------
+
+static ByteArray writePartMscz(const std::function<bool(MscWriter&)>& write)
+{
+    ByteArray msczData;
+    Buffer buf(&msczData);
+
+    MscWriter::Params params;
+    params.device = &buf;
+    params.filePath = "part.mscz";
+    params.mode = MscIoMode::Zip;
+
+    MscWriter writer(params);
+    writer.open();
+    EXPECT_TRUE(write(writer));
+    writer.close();
+
+    return msczData;
+}
+
+/**
+ * @brief Engraving_PartsTests_exportPartsConcurrently
+ * @details Parts prepared one by one and packed on the worker pool, as the parallel parts export does,
+ *          give the same files as parts exported one after another
+ */
+TEST_F(Engraving_PartsTests, exportPartsConcurrently)
+{
+    MasterScore* score = ScoreRW::readScore(PARTS_DATA_DIR + u"part-54346-parts.mscx");
+    ASSERT_TRUE(score);
+    ASSERT_FALSE(score->excerpts().empty());
+
+    std::vector<ByteArray> serial;
+    for (Excerpt* excerpt : score->excerpts()) {
+        serial.push_back(writePartMscz([excerpt](MscWriter& writer) {
+            return MscSaver().exportPart(excerpt->excerptScore(), writer);
+        }));
+    }
+
+    std::vector<std::future<ByteArray> > parallel;
+    for (Excerpt* excerpt : score->excerpts()) {
+        std::shared_ptr<MscSaver::PartData> partData
+            = std::make_shared<MscSaver::PartData>(MscSaver().preparePart(excerpt->excerptScore()));
+
+        parallel.push_back(TaskScheduler::instance()->submit([partData]() {
+            return writePartMscz([partData](MscWriter& writer) {
+                return MscSaver::writePart(*partData, writer);
+            });
+        }));
+    }
+
+    ASSERT_EQ(serial.size(), parallel.size());
+
+    for (size_t i = 0; i < serial.size(); ++i) {
+        ByteArray parallelData = parallel[i].get();
+
+        //! CHECK Same entries with the same contents; only the zip times may differ between two writes
+        EXPECT_EQ(serial[i].size(), parallelData.size());
+
+        Buffer serialBuf(&serial[i]);
+        MscReader::Params serialParams;
+        serialParams.device = &serialBuf;
+        serialParams.filePath = "part.mscz";
+        serialParams.mode = MscIoMode::Zip;
+        MscReader serialReader(serialParams);
+        ASSERT_TRUE(serialReader.open());
+
+        Buffer parallelBuf(&parallelData);
+        MscReader::Params parallelParams = serialParams;
+        parallelParams.device = &parallelBuf;
+        MscReader parallelReader(parallelParams);
+        ASSERT_TRUE(parallelReader.open());
+
+        EXPECT_FALSE(serialReader.readScoreFile().empty());
+        EXPECT_EQ(serialReader.readStyleFile(), parallelReader.readStyleFile());
+        EXPECT_EQ(serialReader.readScoreFile(), parallelReader.readScoreFile());
+        EXPECT_EQ(serialReader.readThumbnailFile(), parallelReader.readThumbnailFile());
+    }
+
+    delete score;
+}
@@ -0,0 +1,133 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2023 MuseScore BVBA and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+
+#include "dom/shape.h"
+
+using namespace mu;
+using namespace mu::engraving;
+
+class Engraving_ShapeTests : public ::testing::Test
+{
+};
+
+//---------------------------------------------------------
+//   scalarMinVerticalDistance
+//    The plain pairwise loop minVerticalDistance() is vectorized from
+//---------------------------------------------------------
+
+static double scalarMinVerticalDistance(const Shape& upper, const Shape& lower)
+{
+    if (upper.empty() || lower.empty()) {
+        return 0.0;
+    }
+
+    double dist = -1000000.0;
+    for (const RectF& r2 : lower) {
+        if (r2.height() <= 0.0) {
+            continue;
+        }
+        for (const RectF& r1 : upper) {
+            if (r1.height() <= 0.0) {
+                continue;
+            }
+            if (intersects(r1.left(), r1.right(), r2.left(), r2.right(), 0.0)) {
+                dist = std::max(dist, r1.bottom() - r2.top());
+            }
+        }
+    }
+    return dist;
+}
+
+//---------------------------------------------------------
+//   scalarVerticalClearance
+//---------------------------------------------------------
+
+static double scalarVerticalClearance(const Shape& upper, const Shape& lower)
+{
+    if (upper.empty() || lower.empty()) {
+        return 0.0;
+    }
+
+    double dist = 1000000.0;
+    for (const RectF& r2 : lower) {
+        if (r2.height() <= 0.0) {
+            continue;
+        }
+        for (const RectF& r1 : upper) {
+            if (r1.height() <= 0.0) {
+                continue;
+            }
+            if (intersects(r1.left(), r1.right(), r2.left(), r2.right(), 0.0)) {
+                dist = std::min(dist, r2.top() - r1.bottom());
+            }
+        }
+    }
+    return dist;
+}
+
+//---------------------------------------------------------
+//   randomSkyline
+//    Rectangles along a staff, on a quarter grid so that edges often touch,
+//    with some empty and reversed ones
+//---------------------------------------------------------
+
+static Shape randomSkyline(std::mt19937& random, double yOffset)
+{
+    Shape shape;
+    const size_t count = random() % 34;
+    double x = 0.0;
+
+    for (size_t i = 0; i < count; ++i) {
+        x += static_cast<int>(random() % 8) * 0.25;
+        double y = yOffset + static_cast<int>(random() % 40) * 0.25;
+        double w = static_cast<int>(random() % 16) * 0.25 - 0.5;
+        double h = static_cast<int>(random() % 16) * 0.25 - 0.5;
+        shape.add(RectF(x, y, w, h));
+    }
+
+    return shape;
+}
+
+/**
+ * @brief Engraving_ShapeTests_verticalDistancesMatchScalar
+ * @details The vectorized minVerticalDistance() and verticalClearance() give exactly
+ *          the results of the pairwise loops, for shapes of every size around the vector width
+ */
+TEST_F(Engraving_ShapeTests, verticalDistancesMatchScalar)
+{
+    std::mt19937 random(20231016);
+
+    for (int i = 0; i < 5000; ++i) {
+        Shape upper = randomSkyline(random, 0.0);
+        Shape lower = randomSkyline(random, static_cast<int>(random() % 24) * 0.25);
+
+        EXPECT_EQ(upper.minVerticalDistance(lower), scalarMinVerticalDistance(upper, lower));
+        EXPECT_EQ(upper.verticalClearance(lower), scalarVerticalClearance(upper, lower));
+        EXPECT_EQ(lower.minVerticalDistance(upper), scalarMinVerticalDistance(lower, upper));
+        EXPECT_EQ(lower.verticalClearance(upper), scalarVerticalClearance(lower, upper));
+    }
+}
@@ -0,0 +1,205 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2023 MuseScore BVBA and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+#include "dom/masterscore.h"
+#include "dom/measure.h"
+#include "dom/page.h"
+#include "dom/segment.h"
+#include "dom/skyline.h"
+#include "dom/system.h"
+
+#include "utils/scorerw.h"
+
+#include "log.h"
+
+using namespace mu;
+using namespace mu::engraving;
+
+static const String SKYLINE_DATA_DIR("all_elements_data/");
+
+class Engraving_SkylineTests : public ::testing::Test
+{
+};
+
+//---------------------------------------------------------
+//   staffShapes
+//    Shapes of all elements of a staff in a system, in
+//    system coordinates
+//---------------------------------------------------------
+
+static std::vector<Shape> staffShapes(const System* system, staff_idx_t staffIdx)
+{
+    std::vector<Shape> shapes;
+    for (const MeasureBase* mb : system->measures()) {
+        if (!mb->isMeasure()) {
+            continue;
+        }
+        const Measure* m = toMeasure(mb);
+        for (const Segment* s = m->first(); s; s = s->next()) {
+            if (!s->enabled()) {
+                continue;
+            }
+            for (const EngravingItem* e : s->elist()) {
+                if (e && e->staffIdx() == staffIdx && e->addToSkyline()) {
+                    shapes.push_back(e->shape().translated(e->pos() + s->pos() + m->pos()));
+                }
+            }
+        }
+    }
+    return shapes;
+}
+
+static void buildSkyline(Skyline& skyline, const std::vector<Shape>& shapes, bool batch)
+{
+    skyline.clear();
+    if (batch) {
+        skyline.beginBatch();
+    }
+    for (const Shape& shape : shapes) {
+        skyline.add(shape);
+    }
+    if (batch) {
+        skyline.endBatch();
+    }
+}
+
+//---------------------------------------------------------
+//   mergedSegments
+//    The outline of a line. Where a segment is split depends
+//    on the order the rectangles are added in, so neighbours
+//    at the same height are merged and empty ones dropped.
+//---------------------------------------------------------
+
+static std::vector<SkylineSegment> mergedSegments(const SkylineLine& line)
+{
+    std::vector<SkylineSegment> segments;
+    for (const SkylineSegment& s : line) {
+        if (s.w < 0.0000001) {
+            continue;
+        }
+        if (!segments.empty()) {
+            SkylineSegment& last = segments.back();
+            if (last.y == s.y && std::abs(last.x + last.w - s.x) < 0.0000001) {
+                last.w = s.x + s.w - last.x;
+                continue;
+            }
+        }
+        segments.push_back(s);
+    }
+    return segments;
+}
+
+static void expectSameSegments(const SkylineLine& expected, const SkylineLine& actual)
+{
+    std::vector<SkylineSegment> expectedSegments = mergedSegments(expected);
+    std::vector<SkylineSegment> actualSegments = mergedSegments(actual);
+
+    ASSERT_EQ(expectedSegments.size(), actualSegments.size());
+    for (size_t i = 0; i < expectedSegments.size(); ++i) {
+        EXPECT_NEAR(expectedSegments[i].x, actualSegments[i].x, 0.000001);
+        EXPECT_DOUBLE_EQ(expectedSegments[i].y, actualSegments[i].y);
+        EXPECT_NEAR(expectedSegments[i].w, actualSegments[i].w, 0.000001);
+    }
+}
+
+static std::vector<System*> allSystems(MasterScore* score)
+{
+    std::vector<System*> systems;
+    for (Page* page : score->pages()) {
+        for (System* system : page->systems()) {
+            systems.push_back(system);
+        }
+    }
+    return systems;
+}
+
+/**
+ * @brief Engraving_SkylineTests_batchMatchesIncremental
+ * @details Skylines built in one batch have the same outline as the ones built element by element,
+ *          regardless of the order in which the elements are added
+ */
+TEST_F(Engraving_SkylineTests, batchMatchesIncremental)
+{
+    MasterScore* score = ScoreRW::readScore(SKYLINE_DATA_DIR + "moonlight.mscx");
+    EXPECT_TRUE(score);
+
+    for (System* system : allSystems(score)) {
+        for (staff_idx_t staffIdx = 0; staffIdx < score->nstaves(); ++staffIdx) {
+            std::vector<Shape> shapes = staffShapes(system, staffIdx);
+
+            Skyline incremental;
+            buildSkyline(incremental, shapes, false);
+
+            std::reverse(shapes.begin(), shapes.end());
+            Skyline batch;
+            buildSkyline(batch, shapes, true);
+
+            expectSameSegments(incremental.north(), batch.north());
+            expectSameSegments(incremental.south(), batch.south());
+
+            const Skyline& other = system->staff(staffIdx)->skyline();
+            EXPECT_DOUBLE_EQ(incremental.minDistance(other), batch.minDistance(other));
+            EXPECT_DOUBLE_EQ(other.minDistance(incremental), other.minDistance(batch));
+        }
+    }
+
+    delete score;
+}
+
+/**
+ * @brief Engraving_SkylineTests_DISABLED_benchmarkBuild
+ * @details Compares building the skylines of all staves of a score element by element and in one batch
+ */
+TEST_F(Engraving_SkylineTests, DISABLED_benchmarkBuild)
+{
+    MasterScore* score = ScoreRW::readScore(SKYLINE_DATA_DIR + "moonlight.mscx");
+    EXPECT_TRUE(score);
+
+    std::vector<std::vector<Shape> > staves;
+    for (System* system : allSystems(score)) {
+        for (staff_idx_t staffIdx = 0; staffIdx < score->nstaves(); ++staffIdx) {
+            staves.push_back(staffShapes(system, staffIdx));
+        }
+    }
+
+    constexpr int ITERATIONS = 1000;
+    auto measure = [&staves](bool batch) {
+        auto start = std::chrono::steady_clock::now();
+        Skyline skyline;
+        for (int i = 0; i < ITERATIONS; ++i) {
+            for (const std::vector<Shape>& shapes : staves) {
+                buildSkyline(skyline, shapes, batch);
+            }
+        }
+        return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count();
+    };
+
+    LOGI() << "incremental: " << measure(false) << " us, batch: " << measure(true) << " us";
+
+    delete score;
+}
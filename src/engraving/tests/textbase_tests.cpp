@@ -31,6 +31,9 @@
 #include "dom/segment.h"
 #include "dom/stafftext.h"
 #include "dom/textedit.h"
+#include "dom/textmetricscache.h"
+
+#include "draw/fontmetrics.h"
 
 #include "utils/scorerw.h"
 #include "utils/scorecomp.h"
@@ -193,3 +196,47 @@ TEST_F(Engraving_TextBaseTests, musicalSymbolsNotItalic)
     EXPECT_TRUE(fragmentList.front().font(dynamic).italic());
     EXPECT_TRUE(!std::next(fragmentList.begin())->font(dynamic).italic());
 }
+
+/**
+ * @brief Engraving_TextBaseTests_textMetricsCache
+ * @details The cached text metrics are the ones of the font provider, and relayout reuses them
+ */
+TEST_F(Engraving_TextBaseTests, textMetricsCache)
+{
+    TextMetricsCache::clear();
+    EXPECT_EQ(TextMetricsCache::size(), size_t(0));
+
+    draw::Font font(u"Edwin", draw::Font::Type::Text);
+    font.setPointSizeF(10.0);
+    const String text(u"Kyrie eleison");
+
+    draw::FontMetrics fm(font);
+    TextMetricsData tm = TextMetricsCache::textMetrics(font, text);
+    EXPECT_DOUBLE_EQ(tm.width, fm.width(text));
+    EXPECT_EQ(tm.boundingRect, fm.boundingRect(text));
+    EXPECT_EQ(tm.tightBoundingRect, fm.tightBoundingRect(text));
+
+    FontMetricsData fmd = TextMetricsCache::fontMetrics(font);
+    EXPECT_DOUBLE_EQ(fmd.ascent, fm.ascent());
+    EXPECT_DOUBLE_EQ(fmd.lineSpacing, fm.lineSpacing());
+
+    // a different size is a different entry
+    draw::Font bigger = font;
+    bigger.setPointSizeF(20.0);
+    EXPECT_GT(TextMetricsCache::textMetrics(bigger, text).width, tm.width);
+
+    MasterScore* score = ScoreRW::readScore(u"test.mscx");
+    addStaffText(score);
+    score->doLayout();
+    const size_t entries = TextMetricsCache::size();
+    EXPECT_GT(entries, size_t(0));
+
+    // nothing changed, nothing new to measure
+    score->doLayout();
+    EXPECT_EQ(TextMetricsCache::size(), entries);
+
+    TextMetricsCache::clear();
+    EXPECT_EQ(TextMetricsCache::size(), size_t(0));
+
+    delete score;
+}
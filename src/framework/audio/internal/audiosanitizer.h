@@ -39,6 +39,9 @@ public:
     static void setupWorkerThread();
     static std::thread::id workerThread();
     static bool isWorkerThread();
+
+    //! NOTE The threads of AudioThreadPool, they process the tracks on behalf of the worker thread
+    static void setupWorkerPoolThread();
 };
 }
 
@@ -0,0 +1,132 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2023 MuseScore BVBA and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef MU_AUDIO_SAMPLESPROCESSING_H
+#define MU_AUDIO_SAMPLESPROCESSING_H
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+
+#include "audiotypes.h"
+#include "internal/fx/reverb/simdtypes.h"
+
+//! NOTE The kernels go through the interleaved buffers four samples at a time.
+//! With 1, 2 or 4 audio channels a vector then holds whole frames, so every lane
+//! always belongs to the same channel; other layouts are processed sample by sample
+namespace mu::audio::dsp {
+using ChannelValues = std::array<float, std::numeric_limits<audioch_t>::max() + 1>;
+
+inline bool isVectorizable(const audioch_t audioChannelsCount)
+{
+    return audioChannelsCount > 0 && 4 % audioChannelsCount == 0;
+}
+
+//! Multiplies the samples of every channel by its gain, the sums of the squared results are written to squaredSums
+inline void applyGains(float* buffer, const audioch_t audioChannelsCount, const samples_t samplesPerChannel,
+                       const ChannelValues& gains, ChannelValues& squaredSums)
+{
+    std::fill(squaredSums.begin(), squaredSums.begin() + audioChannelsCount, 0.f);
+
+    const size_t samplesCount = samplesPerChannel * audioChannelsCount;
+    size_t i = 0;
+
+    if (isVectorizable(audioChannelsCount)) {
+        const fx::simd::float_x4 gain = { gains[0 % audioChannelsCount], gains[1 % audioChannelsCount],
+                                          gains[2 % audioChannelsCount], gains[3 % audioChannelsCount] };
+        fx::simd::float_x4 squaredSum = 0.f;
+
+        const size_t vectorizedCount = samplesCount - samplesCount % 4;
+
+        for (; i < vectorizedCount; i += 4) {
+            fx::simd::float_x4 samples = fx::simd::load_unaligned(buffer + i) * gain;
+            fx::simd::store_unaligned(buffer + i, samples);
+            squaredSum = squaredSum + samples * samples;
+        }
+
+        float lanes[4];
+        fx::simd::store_unaligned(lanes, squaredSum);
+
+        for (int lane = 0; lane < 4; ++lane) {
+            squaredSums[lane % audioChannelsCount] += lanes[lane];
+        }
+    }
+
+    for (; i < samplesCount; ++i) {
+        audioch_t audioChNum = i % audioChannelsCount;
+
+        float sample = buffer[i] * gains[audioChNum];
+        buffer[i] = sample;
+        squaredSums[audioChNum] += sample * sample;
+    }
+}
+
+//! Adds the samples of the source to the destination, returns the peak absolute value of the source
+inline float mixSamples(float* dst, const float* src, const size_t samplesCount)
+{
+    size_t i = 0;
+    float peak = 0.f;
+
+    fx::simd::float_x4 peaks = 0.f;
+    const fx::simd::float_x4 zero = 0.f;
+    const size_t vectorizedCount = samplesCount - samplesCount % 4;
+
+    for (; i < vectorizedCount; i += 4) {
+        fx::simd::float_x4 samples = fx::simd::load_unaligned(src + i);
+        fx::simd::store_unaligned(dst + i, fx::simd::load_unaligned(dst + i) + samples);
+        peaks = fx::simd::maximum(peaks, fx::simd::maximum(samples, zero - samples));
+    }
+
+    float lanes[4];
+    fx::simd::store_unaligned(lanes, peaks);
+    for (float lane : lanes) {
+        peak = std::max(peak, lane);
+    }
+
+    for (; i < samplesCount; ++i) {
+        dst[i] += src[i];
+        peak = std::max(peak, std::abs(src[i]));
+    }
+
+    return peak;
+}
+
+//! Adds the samples of the source multiplied by the gain to the destination
+inline void mixSamples(float* dst, const float* src, const size_t samplesCount, const float gain)
+{
+    size_t i = 0;
+    const fx::simd::float_x4 gainX4 = gain;
+    const size_t vectorizedCount = samplesCount - samplesCount % 4;
+
+    for (; i < vectorizedCount; i += 4) {
+        fx::simd::float_x4 samples = fx::simd::load_unaligned(src + i) * gainX4;
+        fx::simd::store_unaligned(dst + i, fx::simd::load_unaligned(dst + i) + samples);
+    }
+
+    for (; i < samplesCount; ++i) {
+        dst[i] += src[i] * gain;
+    }
+}
+}
+
+#endif // MU_AUDIO_SAMPLESPROCESSING_H
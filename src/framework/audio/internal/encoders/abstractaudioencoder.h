@@ -56,8 +56,6 @@ public:
             return false;
         }
 
-        prepareOutputBuffer(totalSamplesNumber);
-
         return true;
     }
 
@@ -66,6 +64,7 @@ public:
         return m_format;
     }
 
+    //! NOTE Called for each rendered chunk of the track, flush() completes the file after the last one
     virtual size_t encode(samples_t samplesPerChannel, const float* input) = 0;
     virtual size_t flush() = 0;
 
@@ -75,7 +74,7 @@ public:
     }
 
 protected:
-    virtual size_t requiredOutputBufferSize(samples_t totalSamplesNumber) const = 0;
+    virtual size_t requiredOutputBufferSize(samples_t samplesPerChannel) const = 0;
 
     virtual void prepareWriting()
     {
@@ -106,9 +105,12 @@ protected:
         return true;
     }
 
-    virtual void prepareOutputBuffer(const samples_t totalSamplesNumber)
+    virtual void prepareOutputBuffer(const samples_t samplesPerChannel)
     {
-        m_outputBuffer.resize(requiredOutputBufferSize(totalSamplesNumber));
+        size_t requiredSize = requiredOutputBufferSize(samplesPerChannel);
+        if (m_outputBuffer.size() < requiredSize) {
+            m_outputBuffer.resize(requiredSize);
+        }
     }
 
     virtual void closeDestination()
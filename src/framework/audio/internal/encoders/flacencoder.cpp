@@ -92,8 +92,6 @@ bool FlacEncoder::init(const io::path_t& path, const SoundTrackFormat& format, c
         return false;
     }
 
-    prepareOutputBuffer(totalSamplesNumber);
-
     return true;
 }
 
@@ -103,30 +101,18 @@ size_t FlacEncoder::encode(samples_t samplesPerChannel, const float* input)
         return 0;
     }
 
-    size_t result = 0;
     size_t totalSamplesNumber = samplesPerChannel * m_format.audioChannelsNumber;
-    uint32_t frameSize = 1024;
-    size_t stepSize = frameSize * m_format.audioChannelsNumber;
-
-    std::vector<FLAC__int32> buff(samplesPerChannel * sizeof(float));
 
-    for (size_t i = 0; i < buff.size(); ++i) {
-        buff[i] = static_cast<FLAC__int32>(dsp::convertFloatSamples<FLAC__int16>(input[i]));
+    m_intermBuffer.resize(totalSamplesNumber);
+    for (size_t i = 0; i < totalSamplesNumber; ++i) {
+        m_intermBuffer[i] = static_cast<FLAC__int32>(dsp::convertFloatSamples<FLAC__int16>(input[i]));
     }
 
-    std::vector<FLAC__int32> intermBuff(stepSize);
-
-    for (size_t i = 0; i < totalSamplesNumber; i += stepSize) {
-        std::copy(buff.data() + i, buff.data() + i + stepSize, intermBuff.data());
-
-        if (m_flac->process_interleaved(intermBuff.data(), frameSize)) {
-            result += stepSize;
-        } else {
-            break;
-        }
+    if (!m_flac->process_interleaved(m_intermBuffer.data(), static_cast<uint32_t>(samplesPerChannel))) {
+        return 0;
     }
 
-    return result;
+    return totalSamplesNumber;
 }
 
 size_t FlacEncoder::flush()
@@ -135,9 +121,9 @@ size_t FlacEncoder::flush()
     return 0;
 }
 
-size_t FlacEncoder::requiredOutputBufferSize(samples_t totalSamplesNumber) const
+size_t FlacEncoder::requiredOutputBufferSize(samples_t /*samplesPerChannel*/) const
 {
-    return totalSamplesNumber;
+    return 0;
 }
 
 bool FlacEncoder::openDestination(const io::path_t& path)
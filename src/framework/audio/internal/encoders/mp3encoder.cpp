@@ -79,15 +79,17 @@ bool Mp3Encoder::init(const io::path_t& path, const SoundTrackFormat& format, co
     return true;
 }
 
-size_t Mp3Encoder::requiredOutputBufferSize(samples_t totalSamplesNumber) const
+size_t Mp3Encoder::requiredOutputBufferSize(samples_t samplesPerChannel) const
 {
-    //!Note See thirdparty/lame/API
+    //!Note See thirdparty/lame/API, the worst case is 1.25 * samples + 7200 bytes
 
-    return totalSamplesNumber;
+    return samplesPerChannel + samplesPerChannel / 4 + 7200;
 }
 
 size_t Mp3Encoder::encode(samples_t samplesPerChannel, const float* input)
 {
+    prepareOutputBuffer(samplesPerChannel);
+
     m_progress.progressChanged.send(0, 100, "");
 
     int encodedBytes = lame_encode_buffer_interleaved_ieee_float(m_handler->flags, input, samplesPerChannel,
@@ -103,6 +105,8 @@ size_t Mp3Encoder::encode(samples_t samplesPerChannel, const float* input)
 
 size_t Mp3Encoder::flush()
 {
+    prepareOutputBuffer(0);
+
     int encodedBytes = lame_encode_flush(m_handler->flags,
                                          m_outputBuffer.data(),
                                          static_cast<int>(m_outputBuffer.size()));
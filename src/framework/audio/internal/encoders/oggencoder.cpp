@@ -32,7 +32,7 @@ using namespace mu::audio::encode;
 size_t OggEncoder::encode(samples_t samplesPerChannel, const float* input)
 {
     m_progress.progressChanged.send(0, 100, "");
-    int code = ope_encoder_write_float(m_opusEncoder, input, samplesPerChannel + m_format.sampleRate * 2);
+    int code = ope_encoder_write_float(m_opusEncoder, input, static_cast<int>(samplesPerChannel));
     m_progress.progressChanged.send(100, 100, "");
 
     return code == OPE_OK ? samplesPerChannel : 0;
@@ -40,7 +40,8 @@ size_t OggEncoder::encode(samples_t samplesPerChannel, const float* input)
 
 size_t OggEncoder::flush()
 {
-    return ope_encoder_flush_header(m_opusEncoder);
+    //! NOTE Encodes the samples buffered by the encoder and finishes the stream
+    return ope_encoder_drain(m_opusEncoder) == OPE_OK ? 1 : 0;
 }
 
 size_t OggEncoder::requiredOutputBufferSize(samples_t /*totalSamplesNumber*/) const
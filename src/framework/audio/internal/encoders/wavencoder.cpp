@@ -22,10 +22,6 @@
 
 #include "wavencoder.h"
 
-#include <map>
-
-#include "async/async.h"
-
 using namespace mu::audio;
 using namespace mu::audio::encode;
 
@@ -50,7 +46,7 @@ struct WavHeader {
         const uint32_t file_length = headerLength + sampleDataLength;
         const uint32_t overallSize = file_length - 8;
         const uint32_t bytesPerFrame = audioChannelsNumber * bytesPerSample;
-        const uint32_t bytesPerSec = sampleRate * bytesPerSample;
+        const uint32_t bytesPerSec = sampleRate * bytesPerFrame;
 
         stream.write("RIFF", 4); // chunk ID
 
@@ -60,7 +56,7 @@ struct WavHeader {
 
         writeTagData<uint32_t>(stream, chunkSize);
         writeTagData<uint16_t>(stream, code);
-        writeTagData<uint16_t>(stream, 2);
+        writeTagData<uint16_t>(stream, audioChannelsNumber);
         writeTagData<uint32_t>(stream, sampleRate);
         writeTagData<uint32_t>(stream, bytesPerSec);
         writeTagData<uint16_t>(stream, bytesPerFrame);
@@ -89,56 +85,62 @@ size_t WavEncoder::encode(samples_t samplesPerChannel, const float* input)
         return 0;
     }
 
-    WavHeader header;
-    header.chunkSize = 18; // 18 is 2 bytes more to include cbsize field / extension size
-    header.bitsPerSample = 32;
-    header.code = 3; // IEEE_FLOAT = 3, PCM = 1
-    header.audioChannelsNumber = m_format.audioChannelsNumber;
-    header.sampleRate = m_format.sampleRate;
-    header.samplesPerChannel = samplesPerChannel;
-
-    header.write(m_fileStream);
-
-    int total = header.samplesPerChannel;
-    int progressStep = (total * 5) / 100; // every 5%
-    QVector<samples_t> progressValues;
-    for (samples_t sampleIdx = 0; sampleIdx < header.samplesPerChannel;) {
-        progressValues << sampleIdx;
-        sampleIdx += progressStep;
+    size_t samplesNumber = samplesPerChannel * m_format.audioChannelsNumber;
+    m_fileStream.write(reinterpret_cast<const char*>(input), samplesNumber * sizeof(float));
+    if (!m_fileStream) {
+        return 0;
     }
 
-    for (samples_t sampleIdx = 0; sampleIdx < header.samplesPerChannel; ++sampleIdx) {
-        for (audioch_t audioChNum = 0; audioChNum < m_format.audioChannelsNumber; ++audioChNum) {
-            int idx = sampleIdx * m_format.audioChannelsNumber + audioChNum;
-            m_fileStream.write(reinterpret_cast<const char*>(input + idx), 4);
-        }
+    m_samplesPerChannelWritten += samplesPerChannel;
 
-        if (progressValues.contains(sampleIdx)) {
-            m_progress.progressChanged.send(sampleIdx, total, "");
-        }
+    return samplesNumber;
+}
+
+size_t WavEncoder::flush()
+{
+    if (!m_fileStream.is_open()) {
+        return 0;
     }
 
-    return samplesPerChannel * m_format.audioChannelsNumber;
+    //! NOTE The sizes in the header are only known once all the samples are written
+    m_fileStream.seekp(0);
+    writeHeader();
+    m_fileStream.seekp(0, std::ios_base::end);
+    m_fileStream.flush();
+
+    return m_samplesPerChannelWritten * m_format.audioChannelsNumber;
 }
 
-size_t WavEncoder::flush()
+void WavEncoder::writeHeader()
 {
-    NOT_SUPPORTED;
+    WavHeader header;
+    header.chunkSize = 18; // 18 is 2 bytes more to include cbsize field / extension size
+    header.bitsPerSample = 32;
+    header.code = 3; // IEEE_FLOAT = 3, PCM = 1
+    header.audioChannelsNumber = m_format.audioChannelsNumber;
+    header.sampleRate = m_format.sampleRate;
+    header.samplesPerChannel = static_cast<uint32_t>(m_samplesPerChannelWritten);
 
-    return 0;
+    header.write(m_fileStream);
 }
 
-size_t WavEncoder::requiredOutputBufferSize(samples_t totalSamplesNumber) const
+size_t WavEncoder::requiredOutputBufferSize(samples_t /*samplesPerChannel*/) const
 {
-    return totalSamplesNumber;
+    return 0;
 }
 
 bool WavEncoder::openDestination(const io::path_t& path)
 {
     prepareWriting();
     m_fileStream.open(path.toStdString(), std::ios_base::binary);
+    if (!m_fileStream.is_open()) {
+        return false;
+    }
+
+    //! NOTE Reserves the place of the header, it is rewritten in flush()
+    writeHeader();
 
-    return m_fileStream.is_open();
+    return true;
 }
 
 void WavEncoder::closeDestination()
@@ -136,6 +136,23 @@ __finl float_x4 __vecc operator*(float_x4 a, float_x4 b)
 {
     return vmulq_f32(a.s, b.s);
 }
+
+__finl float_x4 __vecc maximum(float_x4 a, float_x4 b)
+{
+    return vmaxq_f32(a.s, b.s);
+}
+
+/// loads 4 floats from memory without alignment requirements
+__finl float_x4 load_unaligned(const float* src)
+{
+    return vld1q_f32(src);
+}
+
+/// stores 4 floats to memory without alignment requirements
+__finl void __vecc store_unaligned(float* dst, float_x4 a)
+{
+    vst1q_f32(dst, a.s);
+}
 } // namespace mu::audio::fx
 
 #endif // MU_AUDIO_SIMDTYPES_NEON_H
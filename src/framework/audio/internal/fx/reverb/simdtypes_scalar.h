@@ -83,6 +83,26 @@ __finl float_x4 __vecc operator*(float_x4 a, float_x4 b)
 {
     return { a[0] * b[0], a[1] * b[1], a[2] * b[2], a[3] * b[3] };
 }
+
+__finl float_x4 __vecc maximum(float_x4 a, float_x4 b)
+{
+    return { std::max(a[0], b[0]), std::max(a[1], b[1]), std::max(a[2], b[2]), std::max(a[3], b[3]) };
+}
+
+/// loads 4 floats from memory without alignment requirements
+__finl float_x4 load_unaligned(const float* src)
+{
+    return { src[0], src[1], src[2], src[3] };
+}
+
+/// stores 4 floats to memory without alignment requirements
+__finl void __vecc store_unaligned(float* dst, float_x4 a)
+{
+    dst[0] = a[0];
+    dst[1] = a[1];
+    dst[2] = a[2];
+    dst[3] = a[3];
+}
 } // namespace mu::audio::fx
 
 #endif // MU_AUDIO_SIMDTYPES_SCALAR_H
@@ -134,6 +134,23 @@ __finl float_x4 __vecc operator*(float_x4 a, float_x4 b)
 {
     return _mm_mul_ps(a.s, b.s);
 }
+
+__finl float_x4 __vecc maximum(float_x4 a, float_x4 b)
+{
+    return _mm_max_ps(a.s, b.s);
+}
+
+/// loads 4 floats from memory without alignment requirements
+__finl float_x4 load_unaligned(const float* src)
+{
+    return _mm_loadu_ps(src);
+}
+
+/// stores 4 floats to memory without alignment requirements
+__finl void __vecc store_unaligned(float* dst, float_x4 a)
+{
+    _mm_storeu_ps(dst, a.s);
+}
 } // namespace mu::audio::fx
 
 #endif // MU_AUDIO_SIMDTYPES_SSE2_H
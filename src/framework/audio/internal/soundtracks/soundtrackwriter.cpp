@@ -22,6 +22,8 @@
 
 #include "soundtrackwriter.h"
 
+#include <thread>
+
 #include "internal/worker/audioengine.h"
 #include "internal/encoders/mp3encoder.h"
 #include "internal/encoders/oggencoder.h"
@@ -36,8 +38,10 @@ using namespace mu;
 using namespace mu::audio;
 using namespace mu::audio::soundtrack;
 
-static constexpr int PREPARE_STEP = 0;
-static constexpr int ENCODE_STEP = 1;
+//! NOTE The rendered audio is passed to the encoder in chunks of a few render steps,
+//! only a handful of chunks exists at a time whatever the duration of the piece is
+static constexpr size_t RENDER_STEPS_PER_CHUNK = 64;
+static constexpr size_t CHUNKS_COUNT = 4;
 
 SoundTrackWriter::SoundTrackWriter(const io::path_t& destination, const SoundTrackFormat& format, const msecs_t totalDuration,
                                    IAudioSourcePtr source)
@@ -47,9 +51,13 @@ SoundTrackWriter::SoundTrackWriter(const io::path_t& destination, const SoundTra
         return;
     }
 
-    samples_t totalSamplesNumber = (totalDuration / 1000000.f) * sizeof(float) * format.sampleRate;
-    m_inputBuffer.resize(totalSamplesNumber);
-    m_intermBuffer.resize(config()->renderStep() * config()->audioChannelsCount());
+    const samples_t samplesPerChannel = (totalDuration / 1000000.f) * format.sampleRate;
+    m_totalSamplesNumber = samplesPerChannel * config()->audioChannelsCount();
+
+    m_chunks.resize(CHUNKS_COUNT);
+    for (Chunk& chunk : m_chunks) {
+        chunk.samples.resize(config()->renderStep() * RENDER_STEPS_PER_CHUNK * config()->audioChannelsCount());
+    }
 
     m_encoderPtr = createEncoder(format.type);
 
@@ -57,10 +65,7 @@ SoundTrackWriter::SoundTrackWriter(const io::path_t& destination, const SoundTra
         return;
     }
 
-    m_encoderPtr->init(destination, format, totalSamplesNumber);
-    m_encoderPtr->progress().progressChanged.onReceive(this, [this](int64_t current, int64_t total, std::string) {
-        sendStepProgress(ENCODE_STEP, current, total);
-    });
+    m_encoderPtr->init(destination, format, samplesPerChannel);
 }
 
 Ret SoundTrackWriter::write()
@@ -87,22 +92,7 @@ Ret SoundTrackWriter::write()
         m_isAborted = false;
     };
 
-    Ret ret = generateAudioData();
-    if (!ret) {
-        return ret;
-    }
-
-    size_t bytes = m_encoderPtr->encode(m_inputBuffer.size() / sizeof(float), m_inputBuffer.data());
-
-    if (m_isAborted) {
-        return make_ret(Ret::Code::Cancel);
-    }
-
-    if (bytes == 0) {
-        return make_ret(Err::ErrorEncode);
-    }
-
-    return make_ok();
+    return generateAudioData();
 }
 
 void SoundTrackWriter::abort()
@@ -133,31 +123,67 @@ Ret SoundTrackWriter::generateAudioData()
 {
     TRACEFUNC;
 
-    size_t inputBufferOffset = 0;
-    size_t inputBufferMaxOffset = m_inputBuffer.size();
+    {
+        std::lock_guard<std::mutex> lock(m_chunksMutex);
+
+        m_freeChunks.clear();
+        m_filledChunks.clear();
+        for (Chunk& chunk : m_chunks) {
+            m_freeChunks.push_back(&chunk);
+        }
+
+        m_isRenderingFinished = false;
+        m_isEncodingFailed = false;
+    }
+
+    m_lastProgress = -1;
+
+    //! NOTE The encoder works on its own thread, so a chunk is encoded while the next one is rendered
+    std::thread encodingThread(&SoundTrackWriter::encodeAudioData, this);
+
+    const samples_t renderStep = config()->renderStep();
+    const audioch_t audioChannelsCount = config()->audioChannelsCount();
+    size_t renderedSamples = 0;
 
-    sendStepProgress(PREPARE_STEP, inputBufferOffset, inputBufferMaxOffset);
+    sendProgress(renderedSamples, m_totalSamplesNumber);
 
-    samples_t renderStep = config()->renderStep();
+    while (renderedSamples < m_totalSamplesNumber && !m_isAborted) {
+        Chunk* chunk = takeFreeChunk();
+        if (!chunk) {
+            break;
+        }
 
-    while (inputBufferOffset < inputBufferMaxOffset && !m_isAborted) {
-        m_source->process(m_intermBuffer.data(), renderStep);
+        //! NOTE The source renders the whole chunk at once, the mixer spreads its tracks over the workers
+        samples_t samplesPerChannel = (m_totalSamplesNumber - renderedSamples) / audioChannelsCount;
+        samplesPerChannel = std::min<samples_t>(chunk->samples.size() / audioChannelsCount,
+                                                (samplesPerChannel + renderStep - 1) / renderStep * renderStep);
 
-        size_t samplesToCopy = std::min(m_intermBuffer.size(), inputBufferMaxOffset - inputBufferOffset);
+        m_source->process(chunk->samples.data(), samplesPerChannel);
 
-        std::copy(m_intermBuffer.begin(),
-                  m_intermBuffer.begin() + samplesToCopy,
-                  m_inputBuffer.begin() + inputBufferOffset);
+        chunk->size = std::min<size_t>(samplesPerChannel * audioChannelsCount, m_totalSamplesNumber - renderedSamples);
+        renderedSamples += chunk->size;
 
-        inputBufferOffset += samplesToCopy;
-        sendStepProgress(PREPARE_STEP, inputBufferOffset, inputBufferMaxOffset);
+        pushFilledChunk(chunk);
+        sendProgress(renderedSamples, m_totalSamplesNumber);
     }
 
+    {
+        std::lock_guard<std::mutex> lock(m_chunksMutex);
+        m_isRenderingFinished = true;
+    }
+
+    m_chunksChanged.notify_all();
+    encodingThread.join();
+
     if (m_isAborted) {
         return make_ret(Ret::Code::Cancel);
     }
 
-    if (inputBufferOffset == 0) {
+    if (m_isEncodingFailed) {
+        return make_ret(Err::ErrorEncode);
+    }
+
+    if (renderedSamples == 0) {
         LOGI() << "No audio to export";
         return make_ret(Err::NoAudioToExport);
     }
@@ -165,10 +191,78 @@ Ret SoundTrackWriter::generateAudioData()
     return make_ok();
 }
 
-void SoundTrackWriter::sendStepProgress(int step, int64_t current, int64_t total)
+void SoundTrackWriter::encodeAudioData()
 {
-    int stepRange = step == PREPARE_STEP ? 80 : 20;
-    int stepProgressStart = step == PREPARE_STEP ? 0 : 80;
-    int stepCurrentProgress = stepProgressStart + ((current * 100 / total) * stepRange) / 100;
-    m_progress.progressChanged.send(stepCurrentProgress, 100, "");
+    const audioch_t audioChannelsNumber = m_encoderPtr->format().audioChannelsNumber;
+
+    while (true) {
+        Chunk* chunk = nullptr;
+
+        {
+            std::unique_lock<std::mutex> lock(m_chunksMutex);
+            m_chunksChanged.wait(lock, [this]() {
+                return !m_filledChunks.empty() || m_isRenderingFinished;
+            });
+
+            if (m_filledChunks.empty()) {
+                return;
+            }
+
+            chunk = m_filledChunks.front();
+            m_filledChunks.pop_front();
+        }
+
+        bool ok = chunk->size == 0 || m_encoderPtr->encode(chunk->size / audioChannelsNumber, chunk->samples.data()) > 0;
+
+        {
+            std::lock_guard<std::mutex> lock(m_chunksMutex);
+            m_freeChunks.push_back(chunk);
+            m_isEncodingFailed = !ok;
+        }
+
+        m_chunksChanged.notify_all();
+
+        if (!ok) {
+            LOGE() << "Failed to encode audio";
+            return;
+        }
+    }
+}
+
+SoundTrackWriter::Chunk* SoundTrackWriter::takeFreeChunk()
+{
+    std::unique_lock<std::mutex> lock(m_chunksMutex);
+    m_chunksChanged.wait(lock, [this]() {
+        return !m_freeChunks.empty() || m_isEncodingFailed;
+    });
+
+    if (m_isEncodingFailed) {
+        return nullptr;
+    }
+
+    Chunk* chunk = m_freeChunks.front();
+    m_freeChunks.pop_front();
+
+    return chunk;
+}
+
+void SoundTrackWriter::pushFilledChunk(Chunk* chunk)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_chunksMutex);
+        m_filledChunks.push_back(chunk);
+    }
+
+    m_chunksChanged.notify_all();
+}
+
+void SoundTrackWriter::sendProgress(int64_t current, int64_t total)
+{
+    int progress = total > 0 ? static_cast<int>(current * 100 / total) : 100;
+    if (progress == m_lastProgress) {
+        return;
+    }
+
+    m_lastProgress = progress;
+    m_progress.progressChanged.send(progress, 100, "");
 }
@@ -24,7 +24,10 @@
 #define MU_AUDIO_SOUNDTRACKWRITER_H
 
 #include <vector>
+#include <deque>
 #include <cstdio>
+#include <mutex>
+#include <condition_variable>
 
 #include "async/asyncable.h"
 #include "modularity/ioc.h"
@@ -47,15 +50,33 @@ public:
     framework::Progress progress();
 
 private:
+    //! NOTE A piece of the rendered audio, passed from the rendering to the encoding thread
+    struct Chunk {
+        std::vector<float> samples;
+        size_t size = 0;
+    };
+
     encode::AbstractAudioEncoderPtr createEncoder(const SoundTrackType& type) const;
     Ret generateAudioData();
+    void encodeAudioData();
+
+    Chunk* takeFreeChunk();
+    void pushFilledChunk(Chunk* chunk);
 
-    void sendStepProgress(int step, int64_t current, int64_t total);
+    void sendProgress(int64_t current, int64_t total);
 
     IAudioSourcePtr m_source = nullptr;
 
-    std::vector<float> m_inputBuffer;
-    std::vector<float> m_intermBuffer;
+    samples_t m_totalSamplesNumber = 0;
+
+    std::vector<Chunk> m_chunks;
+    std::deque<Chunk*> m_freeChunks;
+    std::deque<Chunk*> m_filledChunks;
+    std::mutex m_chunksMutex;
+    std::condition_variable m_chunksChanged;
+    bool m_isRenderingFinished = false;
+    bool m_isEncodingFailed = false;
+    int m_lastProgress = -1;
 
     encode::AbstractAudioEncoderPtr m_encoderPtr = nullptr;
 
@@ -342,6 +342,12 @@ samples_t FluidSynth::process(float* buffer, samples_t samplesPerChannel)
         handleEvent(std::get<midi::Event>(event));
     }
 
+    //! NOTE Nothing sounds and nothing starts: the synth sleeps until the sequencer gives the next event,
+    //! no samples are returned, so the mixer channel can skip its processing as well
+    if (sequence.empty() && fluid_synth_get_active_voice_count(m_fluid->synth) == 0) {
+        return 0;
+    }
+
     fluid_synth_tune_notes(m_fluid->synth, 0, 0, m_tuning.size(), m_tuning.keys.data(), m_tuning.pitches.data(), true);
 
     int result = fluid_synth_write_float(m_fluid->synth, samplesPerChannel,
@@ -0,0 +1,189 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2023 MuseScore BVBA and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include "audiothreadpool.h"
+
+#include <chrono>
+
+#include "internal/audiosanitizer.h"
+
+using namespace mu::audio;
+
+//! NOTE The cursor keeps the generation in the high bits and the next job index in the low bits
+static constexpr int GENERATION_SHIFT = 32;
+static constexpr uint64_t INDEX_MASK = (uint64_t(1) << GENERATION_SHIFT) - 1;
+
+//! NOTE Only covers a run that follows right away (the slices of the offline rendering),
+//! between the callbacks of the playback the threads are kept awake, see setKeepAwake
+static constexpr std::chrono::microseconds SPIN_DURATION(5);
+
+AudioThreadPool::AudioThreadPool(size_t threadsCount)
+{
+    m_threads.reserve(threadsCount);
+
+    for (size_t i = 0; i < threadsCount; ++i) {
+        m_threads.emplace_back(&AudioThreadPool::th_work, this);
+    }
+}
+
+AudioThreadPool::~AudioThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_isStopped = true;
+    }
+
+    m_runStarted.notify_all();
+
+    for (std::thread& thread : m_threads) {
+        thread.join();
+    }
+}
+
+size_t AudioThreadPool::defaultThreadsCount()
+{
+    unsigned int hardwareThreads = std::thread::hardware_concurrency();
+
+    // The calling thread takes part in every run
+    return hardwareThreads > 1 ? hardwareThreads - 1 : 1;
+}
+
+size_t AudioThreadPool::threadsCount() const
+{
+    return m_threads.size();
+}
+
+void AudioThreadPool::setKeepAwake(bool keepAwake)
+{
+    m_keepAwake.store(keepAwake, std::memory_order_relaxed);
+}
+
+void AudioThreadPool::doRun(size_t jobsCount)
+{
+    if (jobsCount == 0) {
+        return;
+    }
+
+    const uint64_t generation = (generationOf(m_cursor.load()) + 1) & INDEX_MASK;
+
+    m_jobsCount = jobsCount;
+    m_pendingJobs = jobsCount;
+    m_cursor = generation << GENERATION_SHIFT;
+
+    if (m_sleepingThreads > 0) {
+        //! NOTE Taking the mutex orders the notification after a thread has started waiting
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+        }
+
+        m_runStarted.notify_all();
+    }
+
+    runJobs(generation);
+
+    while (m_pendingJobs.load(std::memory_order_acquire) > 0) {
+        std::this_thread::yield();
+    }
+}
+
+bool AudioThreadPool::runJobs(uint64_t generation)
+{
+    bool hasRunJobs = false;
+    size_t index = 0;
+
+    while (claimJob(generation, index)) {
+        m_invoke(m_context, index);
+        m_pendingJobs.fetch_sub(1, std::memory_order_release);
+        hasRunJobs = true;
+    }
+
+    return hasRunJobs;
+}
+
+bool AudioThreadPool::claimJob(uint64_t generation, size_t& index)
+{
+    uint64_t cursor = m_cursor.load(std::memory_order_acquire);
+
+    while (true) {
+        if (generationOf(cursor) != generation) {
+            return false;
+        }
+
+        //! NOTE If the count already belongs to the next run, the exchange fails on the generation
+        const uint64_t nextIndex = cursor & INDEX_MASK;
+        if (nextIndex >= m_jobsCount.load(std::memory_order_acquire)) {
+            return false;
+        }
+
+        if (m_cursor.compare_exchange_weak(cursor, cursor + 1, std::memory_order_acq_rel, std::memory_order_acquire)) {
+            index = static_cast<size_t>(nextIndex);
+            return true;
+        }
+    }
+}
+
+void AudioThreadPool::th_work()
+{
+    AudioSanitizer::setupWorkerPoolThread();
+
+    uint64_t generation = 0;
+
+    while (true) {
+        generation = th_waitForRun(generation);
+        if (m_isStopped) {
+            return;
+        }
+
+        runJobs(generation);
+    }
+}
+
+uint64_t AudioThreadPool::th_waitForRun(uint64_t lastGeneration)
+{
+    auto spinStart = std::chrono::steady_clock::now();
+
+    while (m_keepAwake.load(std::memory_order_relaxed) || std::chrono::steady_clock::now() - spinStart < SPIN_DURATION) {
+        uint64_t generation = generationOf(m_cursor.load(std::memory_order_acquire));
+        if (generation != lastGeneration || m_isStopped) {
+            return generation;
+        }
+
+        std::this_thread::yield();
+    }
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    ++m_sleepingThreads;
+
+    uint64_t generation = lastGeneration;
+    m_runStarted.wait(lock, [this, &generation, lastGeneration]() {
+        generation = generationOf(m_cursor.load());
+        return generation != lastGeneration || m_isStopped;
+    });
+
+    --m_sleepingThreads;
+
+    return generation;
+}
+
+uint64_t AudioThreadPool::generationOf(uint64_t cursor)
+{
+    return cursor >> GENERATION_SHIFT;
+}
@@ -0,0 +1,94 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2023 MuseScore BVBA and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#ifndef MU_AUDIO_AUDIOTHREADPOOL_H
+#define MU_AUDIO_AUDIOTHREADPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace mu::audio {
+//! NOTE Persistent threads for the parallel processing inside the audio callback.
+//! A run doesn't allocate nor lock: the jobs are claimed by an atomic cursor,
+//! which also holds the generation of the run, so a late thread can't take a job of the next run.
+//! While kept awake (the mixer is playing) idle threads keep yielding between the runs, so a callback
+//! neither takes the mutex nor waits for the threads to be rescheduled. This costs the cores of the pool
+//! for as long as the playback lasts, yielding still lets any other ready thread run on them.
+//! Otherwise idle threads spin for a few microseconds and then sleep, only waking them takes the mutex.
+class AudioThreadPool
+{
+public:
+    explicit AudioThreadPool(size_t threadsCount = defaultThreadsCount());
+    ~AudioThreadPool();
+
+    static size_t defaultThreadsCount();
+
+    size_t threadsCount() const;
+
+    //! NOTE Whether idle threads keep waiting for the next run instead of going to sleep
+    void setKeepAwake(bool keepAwake);
+
+    //! NOTE Calls job(index) for every index in [0, jobsCount), the calling thread takes part too.
+    //! Returns when all the jobs are done
+    template<typename Job>
+    void run(size_t jobsCount, Job& job)
+    {
+        m_context = &job;
+        m_invoke = [](void* context, size_t index) {
+            (*static_cast<Job*>(context))(index);
+        };
+
+        doRun(jobsCount);
+    }
+
+private:
+    using Invoke = void (*)(void* context, size_t index);
+
+    void doRun(size_t jobsCount);
+    bool runJobs(uint64_t generation);
+    bool claimJob(uint64_t generation, size_t& index);
+
+    void th_work();
+    uint64_t th_waitForRun(uint64_t lastGeneration);
+
+    static uint64_t generationOf(uint64_t cursor);
+
+    std::vector<std::thread> m_threads;
+
+    std::atomic<uint64_t> m_cursor = 0;
+    std::atomic<size_t> m_jobsCount = 0;
+    std::atomic<size_t> m_pendingJobs = 0;
+
+    void* m_context = nullptr;
+    Invoke m_invoke = nullptr;
+
+    std::mutex m_mutex;
+    std::condition_variable m_runStarted;
+    std::atomic<size_t> m_sleepingThreads = 0;
+    std::atomic<bool> m_keepAwake = false;
+    std::atomic<bool> m_isStopped = false;
+};
+}
+
+#endif // MU_AUDIO_AUDIOTHREADPOOL_H
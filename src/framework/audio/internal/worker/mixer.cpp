@@ -24,13 +24,13 @@
 #include "async/async.h"
 #include "log.h"
 
+#include <algorithm>
 #include <limits>
 
-#include "concurrency/taskscheduler.h"
-
 #include "internal/audiosanitizer.h"
 #include "internal/audiothread.h"
 #include "internal/dsp/audiomathutils.h"
+#include "internal/dsp/samplesprocessing.h"
 #include "audioerrors.h"
 
 using namespace mu;
@@ -68,6 +68,7 @@ RetVal<MixerChannelPtr> Mixer::addChannel(const TrackId trackId, IAudioSourcePtr
     }
 
     m_trackChannels.emplace(trackId, std::make_shared<MixerChannel>(trackId, std::move(source), m_sampleRate));
+    updateTracksData();
 
     result.val = m_trackChannels[trackId];
     result.ret = make_ret(Ret::Code::Ok);
@@ -102,6 +103,7 @@ Ret Mixer::removeChannel(const TrackId trackId)
 
     if (search != m_trackChannels.end() && search->second) {
         m_trackChannels.erase(trackId);
+        updateTracksData();
         return make_ret(Ret::Code::Ok);
     }
 
@@ -143,8 +145,20 @@ samples_t Mixer::process(float* outBuffer, samples_t samplesPerChannel)
 {
     ONLY_AUDIO_WORKER_THREAD;
 
-    for (IClockPtr clock : m_clocks) {
-        clock->forward((samplesPerChannel * 1000000) / m_sampleRate);
+    //! NOTE A slice longer than the render step comes from the offline rendering.
+    //! The tracks don't depend on each other until the master bus, so every track channel renders
+    //! the whole slice on its own worker, and only the master bus goes through it step by step
+    samples_t renderStep = std::min(samplesPerChannel, configuration()->renderStep());
+    if (renderStep == 0) {
+        renderStep = samplesPerChannel;
+    }
+
+    for (samples_t offset = 0; offset < samplesPerChannel; offset += renderStep) {
+        samples_t stepSamplesPerChannel = std::min(renderStep, samplesPerChannel - offset);
+
+        for (IClockPtr clock : m_clocks) {
+            clock->forward((stepSamplesPerChannel * 1000000) / m_sampleRate);
+        }
     }
 
     size_t outBufferSize = samplesPerChannel * m_audioChannelsCount;
@@ -154,18 +168,44 @@ samples_t Mixer::process(float* outBuffer, samples_t samplesPerChannel)
         m_writeCacheBuff.resize(outBufferSize, 0.f);
     }
 
-    TracksData tracksData;
-    processTrackChannels(outBufferSize, samplesPerChannel, tracksData);
+    processTrackChannels(outBufferSize, samplesPerChannel, renderStep);
 
-    prepareAuxBuffers(outBufferSize);
+    samples_t masterChannelSampleCount = 0;
+
+    for (samples_t offset = 0; offset < samplesPerChannel; offset += renderStep) {
+        samples_t stepSamplesPerChannel = std::min(renderStep, samplesPerChannel - offset);
+        size_t stepOffset = offset * m_audioChannelsCount;
+
+        masterChannelSampleCount += mixTracks(outBuffer + stepOffset, stepOffset, stepSamplesPerChannel);
+    }
+
+    return masterChannelSampleCount;
+}
+
+samples_t Mixer::mixTracks(float* outBuffer, size_t tracksDataOffset, samples_t samplesPerChannel)
+{
+    prepareAuxBuffers(samplesPerChannel * m_audioChannelsCount);
 
     samples_t masterChannelSampleCount = 0;
 
-    for (auto& pair : tracksData) {
-        const std::vector<float>& trackBuffer = pair.second;
+    for (const TrackData& trackData : m_tracksData) {
+        const AuxSendsParams& auxSends = trackData.channel->outputParams().auxSends;
+
+        if (trackData.isSleeping) {
+            masterChannelSampleCount = std::max(samplesPerChannel, masterChannelSampleCount);
+
+            //! NOTE Nothing to mix, but the aux channels it sends to keep playing their tails
+            if (!m_isSilence) {
+                writeTrackToAuxBuffers(nullptr, auxSends, samplesPerChannel);
+            }
+
+            continue;
+        }
+
+        const float* trackBuffer = trackData.buffer.data() + tracksDataOffset;
 
         bool outBufferIsSilent = false;
-        mixOutputFromChannel(outBuffer, trackBuffer.data(), samplesPerChannel, outBufferIsSilent);
+        mixOutputFromChannel(outBuffer, trackBuffer, samplesPerChannel, outBufferIsSilent);
         masterChannelSampleCount = std::max(samplesPerChannel, masterChannelSampleCount);
 
         if (!outBufferIsSilent) {
@@ -174,8 +214,7 @@ samples_t Mixer::process(float* outBuffer, samples_t samplesPerChannel)
             continue;
         }
 
-        const AuxSendsParams& auxSends = m_trackChannels.at(pair.first)->outputParams().auxSends;
-        writeTrackToAuxBuffers(trackBuffer.data(), auxSends, samplesPerChannel);
+        writeTrackToAuxBuffers(trackBuffer, auxSends, samplesPerChannel);
     }
 
     if (m_masterParams.muted || masterChannelSampleCount == 0 || m_isSilence) {
@@ -197,39 +236,81 @@ samples_t Mixer::process(float* outBuffer, samples_t samplesPerChannel)
     return masterChannelSampleCount;
 }
 
-void Mixer::processTrackChannels(size_t outBufferSize, size_t samplesPerChannel, TracksData& outTracksData)
+void Mixer::updateTracksData()
 {
-    auto processChannel = [outBufferSize, samplesPerChannel](MixerChannelPtr channel) -> std::vector<float> {
-        thread_local std::vector<float> buffer(outBufferSize, 0.f);
-        thread_local std::vector<float> silent_buffer(outBufferSize, 0.f);
+    std::vector<TrackData> tracksData;
+    tracksData.reserve(m_trackChannels.size());
 
-        buffer = silent_buffer;
+    for (const auto& pair : m_trackChannels) {
+        TrackData trackData;
+        trackData.trackId = pair.first;
+        trackData.channel = pair.second;
 
-        if (channel) {
-            channel->process(buffer.data(), samplesPerChannel);
+        auto it = std::find_if(m_tracksData.begin(), m_tracksData.end(), [&pair](const TrackData& data) {
+            return data.trackId == pair.first;
+        });
+
+        if (it != m_tracksData.end()) {
+            trackData.buffer = std::move(it->buffer);
         }
 
-        return buffer;
-    };
+        tracksData.push_back(std::move(trackData));
+    }
 
-    bool useMultithreading = m_trackChannels.size() > 2;
+    m_tracksData = std::move(tracksData);
+}
 
-    if (useMultithreading) {
-        std::map<TrackId, std::future<std::vector<float> > > futures;
+void Mixer::processTrackChannels(size_t outBufferSize, size_t samplesPerChannel, size_t renderStep)
+{
+    //! NOTE Only grows on a longer slice than before (the first offline rendering), not in the steady state
+    for (TrackData& trackData : m_tracksData) {
+        if (trackData.buffer.size() < outBufferSize) {
+            trackData.buffer.resize(outBufferSize);
+        }
+    }
+
+    const size_t audioChannelsCount = m_audioChannelsCount;
+
+    auto processChannel = [this, outBufferSize, samplesPerChannel, renderStep, audioChannelsCount](size_t index) {
+        TrackData& trackData = m_tracksData[index];
+        float* buffer = trackData.buffer.data();
+
+        std::fill(buffer, buffer + outBufferSize, 0.f);
 
-        for (const auto& pair : m_trackChannels) {
-            std::future<std::vector<float> > future = TaskScheduler::instance()->submit(processChannel, pair.second);
-            futures.emplace(pair.first, std::move(future));
+        trackData.isSleeping = true;
+
+        if (!trackData.channel) {
+            return;
         }
 
-        for (auto& pair : futures) {
-            outTracksData.emplace(pair.first, pair.second.get());
+        for (size_t offset = 0; offset < samplesPerChannel; offset += renderStep) {
+            samples_t processedSamplesCount = trackData.channel->process(buffer + offset * audioChannelsCount,
+                                                                          std::min(renderStep, samplesPerChannel - offset));
+
+            if (processedSamplesCount > 0) {
+                trackData.isSleeping = false;
+            }
         }
+    };
+
+    bool isSliced = renderStep < samplesPerChannel;
+    bool useMultithreading = m_tracksData.size() > 2 || (isSliced && m_tracksData.size() > 1);
+
+    if (useMultithreading) {
+        m_threadPool.run(m_tracksData.size(), processChannel);
     } else {
-        for (const auto& pair : m_trackChannels) {
-            outTracksData.emplace(pair.first, processChannel(pair.second));
+        for (size_t i = 0; i < m_tracksData.size(); ++i) {
+            processChannel(i);
         }
     }
+
+    //! NOTE The workers wait for the next callback awake while the tracks play,
+    //! and go to sleep once all of them are asleep
+    bool isIdle = std::all_of(m_tracksData.cbegin(), m_tracksData.cend(), [](const TrackData& trackData) {
+        return trackData.isSleeping;
+    });
+
+    m_threadPool.setKeepAwake(useMultithreading && !isIdle);
 }
 
 void Mixer::setIsActive(bool arg)
@@ -238,6 +319,10 @@ void Mixer::setIsActive(bool arg)
 
     AbstractAudioSource::setIsActive(arg);
 
+    if (!arg) {
+        m_threadPool.setKeepAwake(false);
+    }
+
     for (const auto& channel : m_trackChannels) {
         channel.second->setIsActive(arg);
     }
@@ -339,18 +424,8 @@ void Mixer::mixOutputFromChannel(float* outBuffer, const float* inBuffer, unsign
         return;
     }
 
-    for (audioch_t audioChNum = 0; audioChNum < m_audioChannelsCount; ++audioChNum) {
-        for (samples_t s = 0; s < samplesCount; ++s) {
-            int idx = s * m_audioChannelsCount + audioChNum;
-            float sample = inBuffer[idx];
-
-            outBuffer[idx] += sample;
-
-            if (outBufferIsSilent && !RealIsNull(sample)) {
-                outBufferIsSilent = false;
-            }
-        }
-    }
+    float peak = dsp::mixSamples(outBuffer, inBuffer, samplesCount * m_audioChannelsCount);
+    outBufferIsSilent = RealIsNull(peak);
 }
 
 void Mixer::prepareAuxBuffers(size_t outBufferSize)
@@ -387,15 +462,8 @@ void Mixer::writeTrackToAuxBuffers(const float* trackBuffer, const AuxSendsParam
             continue;
         }
 
-        float* auxBuffer = aux.buffer.data();
-        float signalAmount = auxSend.signalAmount;
-
-        for (audioch_t audioChNum = 0; audioChNum < m_audioChannelsCount; ++audioChNum) {
-            for (samples_t s = 0; s < samplesPerChannel; ++s) {
-                int idx = s * m_audioChannelsCount + audioChNum;
-
-                auxBuffer[idx] += trackBuffer[idx] * signalAmount;
-            }
+        if (trackBuffer) {
+            dsp::mixSamples(aux.buffer.data(), trackBuffer, samplesPerChannel * m_audioChannelsCount, auxSend.signalAmount);
         }
 
         aux.receivedAudioSignal = true;
@@ -423,35 +491,28 @@ void Mixer::completeOutput(float* buffer, samples_t samplesPerChannel)
         return;
     }
 
-    m_isSilence = true;
-
     float totalSquaredSum = 0.f;
     float volume = dsp::linearFromDecibels(m_masterParams.volume);
 
+    dsp::ChannelValues gains;
     for (audioch_t audioChNum = 0; audioChNum < m_audioChannelsCount; ++audioChNum) {
-        float singleChannelSquaredSum = 0.f;
-
-        gain_t totalGain = dsp::balanceGain(m_masterParams.balance, audioChNum) * volume;
-
-        for (samples_t s = 0; s < samplesPerChannel; ++s) {
-            int idx = s * m_audioChannelsCount + audioChNum;
-
-            float resultSample = buffer[idx] * totalGain;
-            buffer[idx] = resultSample;
+        gains[audioChNum] = dsp::balanceGain(m_masterParams.balance, audioChNum) * volume;
+    }
 
-            if (m_isSilence && !RealIsNull(resultSample)) {
-                m_isSilence = false;
-            }
+    dsp::ChannelValues squaredSums;
+    dsp::applyGains(buffer, m_audioChannelsCount, samplesPerChannel, gains, squaredSums);
 
-            float squaredSample = resultSample * resultSample;
-            totalSquaredSum += squaredSample;
-            singleChannelSquaredSum += squaredSample;
-        }
+    for (audioch_t audioChNum = 0; audioChNum < m_audioChannelsCount; ++audioChNum) {
+        totalSquaredSum += squaredSums[audioChNum];
 
-        float rms = dsp::samplesRootMeanSquare(singleChannelSquaredSum, samplesPerChannel);
+        float rms = dsp::samplesRootMeanSquare(squaredSums[audioChNum], samplesPerChannel);
         notifyAboutAudioSignalChanges(audioChNum, rms);
     }
 
+    //! NOTE No sample is louder than the square root of the sum of the squares,
+    //! so a null root means that every sample is null
+    m_isSilence = RealIsNull(std::sqrt(totalSquaredSum));
+
     if (!m_limiter->isActive()) {
         return;
     }
@@ -31,6 +31,7 @@
 
 #include "abstractaudiosource.h"
 #include "mixerchannel.h"
+#include "audiothreadpool.h"
 #include "internal/dsp/limiter.h"
 #include "ifxresolver.h"
 #include "iaudioconfiguration.h"
@@ -70,9 +71,16 @@ public:
     void setIsActive(bool arg) override;
 
 private:
-    using TracksData = std::map<TrackId, std::vector<float> >;
+    struct TrackData {
+        TrackId trackId = -1;
+        MixerChannelPtr channel;
+        std::vector<float> buffer;
+        bool isSleeping = false; // the channel produced no samples in the last slice
+    };
 
-    void processTrackChannels(size_t outBufferSize, size_t samplesPerChannel, TracksData& outTracksData);
+    void updateTracksData();
+    void processTrackChannels(size_t outBufferSize, size_t samplesPerChannel, size_t renderStep);
+    samples_t mixTracks(float* outBuffer, size_t tracksDataOffset, samples_t samplesPerChannel);
     void mixOutputFromChannel(float* outBuffer, const float* inBuffer, unsigned int samplesCount, bool& outBufferIsSilent);
     void prepareAuxBuffers(size_t outBufferSize);
     void writeTrackToAuxBuffers(const float* trackBuffer, const AuxSendsParams& auxSends, samples_t samplesPerChannel);
@@ -88,6 +96,10 @@ private:
 
     std::map<TrackId, MixerChannelPtr> m_trackChannels = {};
 
+    //! NOTE The buffers of the tracks are kept between the callbacks, so that processing doesn't allocate
+    std::vector<TrackData> m_tracksData;
+    AudioThreadPool m_threadPool;
+
     struct AuxChannelInfo {
         MixerChannelPtr channel;
         std::vector<float> buffer;
@@ -26,12 +26,16 @@
 #include "log.h"
 
 #include "internal/dsp/audiomathutils.h"
+#include "internal/dsp/samplesprocessing.h"
 #include "internal/audiosanitizer.h"
 
 using namespace mu;
 using namespace mu::audio;
 using namespace mu::async;
 
+//! NOTE About -100 dBFS, below what the 16 and 24 bit outputs can render audibly
+static constexpr float SLEEP_THRESHOLD_RMS = 0.00001f;
+
 MixerChannel::MixerChannel(const TrackId trackId, IAudioSourcePtr source, const unsigned int sampleRate)
     : m_trackId(trackId),
     m_sampleRate(sampleRate),
@@ -173,6 +177,19 @@ samples_t MixerChannel::process(float* buffer, samples_t samplesPerChannel)
         processedSamplesCount = m_audioSource->process(buffer, samplesPerChannel);
     }
 
+    //! NOTE The source went silent, the effects still play their tails on the silence.
+    //! Once the output has decayed, the channel sleeps until the source produces samples again
+    if (processedSamplesCount == 0 && !m_params.muted && !m_isSleeping) {
+        std::fill(buffer, buffer + samplesPerChannel * audioChannelsCount(), 0.f);
+
+        processFx(buffer, samplesPerChannel);
+
+        float rms = completeOutput(buffer, samplesPerChannel);
+        m_isSleeping = rms < SLEEP_THRESHOLD_RMS;
+
+        return samplesPerChannel;
+    }
+
     if (processedSamplesCount == 0 || m_params.muted) {
         unsigned int channelsCount = audioChannelsCount();
         std::fill(buffer, buffer + samplesPerChannel * channelsCount, 0.f);
@@ -184,51 +201,53 @@ samples_t MixerChannel::process(float* buffer, samples_t samplesPerChannel)
         return processedSamplesCount;
     }
 
-    for (IFxProcessorPtr fx : m_fxProcessors) {
+    m_isSleeping = false;
+
+    processFx(buffer, samplesPerChannel);
+    completeOutput(buffer, samplesPerChannel);
+
+    return processedSamplesCount;
+}
+
+void MixerChannel::processFx(float* buffer, samples_t samplesPerChannel)
+{
+    for (IFxProcessorPtr& fx : m_fxProcessors) {
         if (!fx->active()) {
             continue;
         }
         fx->process(buffer, samplesPerChannel);
     }
-
-    completeOutput(buffer, samplesPerChannel);
-
-    return processedSamplesCount;
 }
 
-void MixerChannel::completeOutput(float* buffer, unsigned int samplesCount) const
+float MixerChannel::completeOutput(float* buffer, unsigned int samplesCount) const
 {
     unsigned int channelsCount = audioChannelsCount();
     float volume = dsp::linearFromDecibels(m_params.volume);
     float totalSquaredSum = 0.f;
 
+    dsp::ChannelValues gains;
     for (audioch_t audioChNum = 0; audioChNum < channelsCount; ++audioChNum) {
-        float singleChannelSquaredSum = 0.f;
-
-        gain_t totalGain = dsp::balanceGain(m_params.balance, audioChNum) * volume;
-
-        for (unsigned int s = 0; s < samplesCount; ++s) {
-            int idx = s * channelsCount + audioChNum;
+        gains[audioChNum] = dsp::balanceGain(m_params.balance, audioChNum) * volume;
+    }
 
-            float resultSample = buffer[idx] * totalGain;
-            buffer[idx] = resultSample;
+    dsp::ChannelValues squaredSums;
+    dsp::applyGains(buffer, channelsCount, samplesCount, gains, squaredSums);
 
-            float squaredSample = resultSample * resultSample;
-            singleChannelSquaredSum += squaredSample;
-            totalSquaredSum += squaredSample;
-        }
+    for (audioch_t audioChNum = 0; audioChNum < channelsCount; ++audioChNum) {
+        totalSquaredSum += squaredSums[audioChNum];
 
-        float rms = dsp::samplesRootMeanSquare(singleChannelSquaredSum, samplesCount);
+        float rms = dsp::samplesRootMeanSquare(squaredSums[audioChNum], samplesCount);
 
         notifyAboutAudioSignalChanges(audioChNum, rms);
     }
 
-    if (!m_compressor->isActive()) {
-        return;
+    float totalRms = dsp::samplesRootMeanSquare(totalSquaredSum, samplesCount * channelsCount);
+
+    if (m_compressor->isActive()) {
+        m_compressor->process(totalRms, buffer, channelsCount, samplesCount);
     }
 
-    float totalRms = dsp::samplesRootMeanSquare(totalSquaredSum, samplesCount * channelsCount);
-    m_compressor->process(totalRms, buffer, channelsCount, samplesCount);
+    return totalRms;
 }
 
 void MixerChannel::notifyAboutAudioSignalChanges(const audioch_t audioChannelNumber, const float linearRms) const
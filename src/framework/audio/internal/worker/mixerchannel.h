@@ -57,7 +57,8 @@ public:
     samples_t process(float* buffer, samples_t samplesPerChannel) override;
 
 private:
-    void completeOutput(float* buffer, unsigned int samplesCount) const;
+    void processFx(float* buffer, samples_t samplesPerChannel);
+    float completeOutput(float* buffer, unsigned int samplesCount) const;
     void notifyAboutAudioSignalChanges(const audioch_t audioChannelNumber, const float linearRms) const;
 
     TrackId m_trackId = -1;
@@ -71,6 +72,10 @@ private:
 
     dsp::CompressorPtr m_compressor = nullptr;
 
+    //! NOTE The source is silent and the effects tails have decayed,
+    //! process() doesn't produce samples until the source does
+    bool m_isSleeping = false;
+
     mutable async::Channel<AudioOutputParams> m_paramsChanges;
     mutable AudioSignalsNotifier m_audioSignalNotifier;
 };
@@ -0,0 +1,101 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2023 MuseScore BVBA and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "audio/internal/worker/audiothreadpool.h"
+
+using namespace mu::audio;
+
+namespace mu::audio {
+class Audio_AudioThreadPoolTest : public ::testing::Test
+{
+public:
+};
+}
+
+TEST_F(Audio_AudioThreadPoolTest, EveryJobRunsOncePerRun)
+{
+    AudioThreadPool pool(3);
+
+    constexpr size_t JOBS_COUNT = 64;
+    std::vector<std::atomic<int> > calls(JOBS_COUNT);
+
+    for (int run = 1; run <= 1000; ++run) {
+        auto job = [&calls](size_t index) {
+            calls[index].fetch_add(1);
+        };
+
+        pool.run(JOBS_COUNT, job);
+
+        for (size_t i = 0; i < JOBS_COUNT; ++i) {
+            ASSERT_EQ(calls[i].load(), run);
+        }
+    }
+}
+
+TEST_F(Audio_AudioThreadPoolTest, RunsAfterThreadsFellAsleep)
+{
+    AudioThreadPool pool(2);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+    std::atomic<size_t> sum = 0;
+    auto job = [&sum](size_t index) {
+        sum += index;
+    };
+
+    pool.run(10, job);
+    EXPECT_EQ(sum.load(), 45u);
+
+    pool.run(0, job);
+    EXPECT_EQ(sum.load(), 45u);
+}
+
+TEST_F(Audio_AudioThreadPoolTest, RunsWhileKeptAwake)
+{
+    AudioThreadPool pool(2);
+    pool.setKeepAwake(true);
+
+    std::atomic<size_t> sum = 0;
+    auto job = [&sum](size_t index) {
+        sum += index;
+    };
+
+    //! NOTE Longer than the spin, the threads must not have gone to sleep
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+    pool.run(10, job);
+    EXPECT_EQ(sum.load(), 45u);
+
+    //! NOTE Once not kept awake anymore, the threads sleep and are woken by the next run
+    pool.setKeepAwake(false);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+    pool.run(10, job);
+    EXPECT_EQ(sum.load(), 90u);
+}
@@ -0,0 +1,243 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2023 MuseScore BVBA and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+#include "audio/internal/encoders/wavencoder.h"
+#include "audio/internal/encoders/flacencoder.h"
+
+using namespace mu;
+using namespace mu::audio;
+using namespace mu::audio::encode;
+
+namespace mu::audio {
+class Audio_EncodersTest : public ::testing::Test
+{
+public:
+    static constexpr sample_rate_t SAMPLE_RATE = 44100;
+
+    //! NOTE The export renders the track in chunks of this size, the last one is usually shorter
+    static constexpr samples_t CHUNK_SIZE = 512 * 64;
+    static constexpr samples_t TOTAL_SAMPLES_PER_CHANNEL = 2 * CHUNK_SIZE + 1001;
+
+    void TearDown() override
+    {
+        std::error_code ec;
+        std::filesystem::remove(m_path, ec);
+    }
+
+    io::path_t makePath(const std::string& extension)
+    {
+        m_path = std::filesystem::temp_directory_path()
+                 / (std::string("audio_encoders_test_") + ::testing::UnitTest::GetInstance()->current_test_info()->name() + extension);
+        return io::path_t(m_path.string());
+    }
+
+    static std::vector<float> makeSamples(audioch_t channels)
+    {
+        std::vector<float> samples(TOTAL_SAMPLES_PER_CHANNEL * channels);
+        for (size_t i = 0; i < samples.size(); ++i) {
+            samples[i] = static_cast<float>(static_cast<int>(i % 200) - 100) / 200.f;
+        }
+
+        return samples;
+    }
+
+    //! NOTE Feeds the samples the way SoundTrackWriter does: full chunks and a shorter tail
+    static size_t encodeInChunks(AbstractAudioEncoder& encoder, const std::vector<float>& samples, audioch_t channels)
+    {
+        size_t encoded = 0;
+        samples_t offset = 0;
+
+        while (offset < TOTAL_SAMPLES_PER_CHANNEL) {
+            samples_t chunk = std::min(CHUNK_SIZE, TOTAL_SAMPLES_PER_CHANNEL - offset);
+            encoded += encoder.encode(chunk, samples.data() + offset * channels);
+            offset += chunk;
+        }
+
+        return encoded;
+    }
+
+    std::vector<uint8_t> readFile() const
+    {
+        std::ifstream stream(m_path, std::ios_base::binary);
+        return std::vector<uint8_t>(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+    }
+
+    static uint32_t readLE(const std::vector<uint8_t>& data, size_t offset, size_t bytes)
+    {
+        uint32_t value = 0;
+        for (size_t i = 0; i < bytes; ++i) {
+            value |= static_cast<uint32_t>(data.at(offset + i)) << (8 * i);
+        }
+
+        return value;
+    }
+
+    static uint64_t readBE(const std::vector<uint8_t>& data, size_t offset, size_t bytes)
+    {
+        uint64_t value = 0;
+        for (size_t i = 0; i < bytes; ++i) {
+            value = (value << 8) | data.at(offset + i);
+        }
+
+        return value;
+    }
+
+    static std::string readTag(const std::vector<uint8_t>& data, size_t offset)
+    {
+        return std::string(data.begin() + offset, data.begin() + offset + 4);
+    }
+
+    void checkWav(audioch_t channels)
+    {
+        std::vector<float> samples = makeSamples(channels);
+
+        SoundTrackFormat format;
+        format.type = SoundTrackType::WAV;
+        format.sampleRate = SAMPLE_RATE;
+        format.audioChannelsNumber = channels;
+
+        WavEncoder encoder;
+        ASSERT_TRUE(encoder.init(makePath(".wav"), format, TOTAL_SAMPLES_PER_CHANNEL));
+
+        EXPECT_EQ(encodeInChunks(encoder, samples, channels), samples.size());
+        EXPECT_EQ(encoder.flush(), samples.size());
+
+        std::vector<uint8_t> data = readFile();
+
+        const size_t headerLength = 46;
+        const uint32_t dataLength = static_cast<uint32_t>(samples.size() * sizeof(float));
+        ASSERT_EQ(data.size(), headerLength + dataLength);
+
+        EXPECT_EQ(readTag(data, 0), "RIFF");
+        EXPECT_EQ(readLE(data, 4, 4), data.size() - 8);
+        EXPECT_EQ(readTag(data, 8), "WAVE");
+        EXPECT_EQ(readTag(data, 12), "fmt ");
+        EXPECT_EQ(readLE(data, 16, 4), 18u);                              // fmt chunk size
+        EXPECT_EQ(readLE(data, 20, 2), 3u);                               // IEEE float
+        EXPECT_EQ(readLE(data, 22, 2), channels);
+        EXPECT_EQ(readLE(data, 24, 4), SAMPLE_RATE);
+        EXPECT_EQ(readLE(data, 28, 4), SAMPLE_RATE * channels * sizeof(float)); // bytes per second
+        EXPECT_EQ(readLE(data, 32, 2), channels * sizeof(float));         // block align
+        EXPECT_EQ(readLE(data, 34, 2), 32u);                              // bits per sample
+        EXPECT_EQ(readLE(data, 36, 2), 0u);                               // cbSize
+        EXPECT_EQ(readTag(data, 38), "data");
+        EXPECT_EQ(readLE(data, 42, 4), dataLength);
+
+        EXPECT_EQ(std::memcmp(data.data() + headerLength, samples.data(), dataLength), 0);
+    }
+
+private:
+    std::filesystem::path m_path;
+};
+}
+
+/**
+ * @brief Audio_EncodersTest_WavStereo
+ * @details The header of an exported stereo WAV file matches the written samples,
+ *          the length of the track is not a multiple of the chunk size
+ */
+TEST_F(Audio_EncodersTest, WavStereo)
+{
+    checkWav(2);
+}
+
+/**
+ * @brief Audio_EncodersTest_WavMono
+ * @details The channel count and the byte rate in the header follow the format, not a fixed stereo layout
+ */
+TEST_F(Audio_EncodersTest, WavMono)
+{
+    checkWav(1);
+}
+
+/**
+ * @brief Audio_EncodersTest_WavFlushTwice
+ * @details Rewriting the header does not append anything to the file
+ */
+TEST_F(Audio_EncodersTest, WavFlushTwice)
+{
+    const audioch_t channels = 2;
+    std::vector<float> samples = makeSamples(channels);
+
+    SoundTrackFormat format;
+    format.type = SoundTrackType::WAV;
+    format.sampleRate = SAMPLE_RATE;
+    format.audioChannelsNumber = channels;
+
+    WavEncoder encoder;
+    ASSERT_TRUE(encoder.init(makePath(".wav"), format, TOTAL_SAMPLES_PER_CHANNEL));
+
+    encodeInChunks(encoder, samples, channels);
+    encoder.flush();
+    encoder.flush();
+
+    std::vector<uint8_t> data = readFile();
+    EXPECT_EQ(data.size(), 46 + samples.size() * sizeof(float));
+    EXPECT_EQ(readLE(data, 42, 4), samples.size() * sizeof(float));
+}
+
+/**
+ * @brief Audio_EncodersTest_FlacStreamInfo
+ * @details The STREAMINFO block of an exported FLAC file holds the exact number of samples,
+ *          the length of the track is not a multiple of the FLAC block size (4096)
+ */
+TEST_F(Audio_EncodersTest, FlacStreamInfo)
+{
+    const audioch_t channels = 2;
+    std::vector<float> samples = makeSamples(channels);
+    ASSERT_NE(TOTAL_SAMPLES_PER_CHANNEL % 4096, 0u);
+
+    SoundTrackFormat format;
+    format.type = SoundTrackType::FLAC;
+    format.sampleRate = SAMPLE_RATE;
+    format.audioChannelsNumber = channels;
+
+    FlacEncoder encoder;
+    ASSERT_TRUE(encoder.init(makePath(".flac"), format, TOTAL_SAMPLES_PER_CHANNEL));
+
+    EXPECT_EQ(encodeInChunks(encoder, samples, channels), samples.size());
+    encoder.flush();
+
+    std::vector<uint8_t> data = readFile();
+    ASSERT_GT(data.size(), 42u);
+
+    EXPECT_EQ(readTag(data, 0), "fLaC");
+    EXPECT_EQ(data[4] & 0x7f, 0);                                 // STREAMINFO
+    EXPECT_EQ(readBE(data, 5, 3), 34u);                           // block length
+
+    //! NOTE Bytes 18..25 of STREAMINFO: 20 bits sample rate, 3 bits channels - 1,
+    //!      5 bits bits per sample - 1, 36 bits total samples
+    const uint64_t packed = readBE(data, 8 + 10, 8);
+    EXPECT_EQ(packed >> 44, SAMPLE_RATE);
+    EXPECT_EQ(((packed >> 41) & 0x7) + 1, channels);
+    EXPECT_EQ(((packed >> 36) & 0x1f) + 1, 16u);
+    EXPECT_EQ(packed & 0xfffffffffULL, TOTAL_SAMPLES_PER_CHANNEL);
+}
@@ -0,0 +1,259 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2023 MuseScore BVBA and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+#include "audio/internal/worker/mixerchannel.h"
+#include "audio/internal/worker/abstractaudiosource.h"
+#include "audio/internal/audiosanitizer.h"
+#include "audio/ifxresolver.h"
+
+using namespace mu;
+using namespace mu::audio;
+
+namespace mu::audio {
+class SwitchableSource : public AbstractAudioSource
+{
+public:
+    unsigned int audioChannelsCount() const override
+    {
+        return 2;
+    }
+
+    samples_t process(float* buffer, samples_t samplesPerChannel) override
+    {
+        calls++;
+
+        if (!playing) {
+            return 0;
+        }
+
+        std::fill(buffer, buffer + samplesPerChannel * audioChannelsCount(), 0.01f);
+
+        return samplesPerChannel;
+    }
+
+    bool playing = false;
+    int calls = 0;
+};
+
+//! NOTE A stereo one-pole feedback, every input keeps ringing and decays by DECAY per sample
+class DecayFx : public IFxProcessor
+{
+public:
+    static constexpr float DECAY = 0.995f;
+
+    DecayFx()
+    {
+        m_params.chainOrder = 0;
+        m_params.resourceMeta.id = "decay";
+        m_params.resourceMeta.type = AudioResourceType::MusePlugin;
+        m_params.active = true;
+    }
+
+    AudioFxType type() const override
+    {
+        return AudioFxType::MuseFx;
+    }
+
+    const AudioFxParams& params() const override
+    {
+        return m_params;
+    }
+
+    async::Channel<audio::AudioFxParams> paramsChanged() const override
+    {
+        return m_paramsChanged;
+    }
+
+    void setSampleRate(unsigned int) override {}
+
+    bool active() const override
+    {
+        return m_params.active;
+    }
+
+    void setActive(bool active) override
+    {
+        m_params.active = active;
+    }
+
+    void process(float* buffer, unsigned int sampleCount) override
+    {
+        calls++;
+
+        for (unsigned int i = 0; i < sampleCount; ++i) {
+            for (size_t ch = 0; ch < 2; ++ch) {
+                m_state[ch] = buffer[i * 2 + ch] + m_state[ch] * DECAY;
+                buffer[i * 2 + ch] = m_state[ch];
+            }
+        }
+    }
+
+    int calls = 0;
+
+private:
+    AudioFxParams m_params;
+    async::Channel<audio::AudioFxParams> m_paramsChanged;
+    float m_state[2] = { 0.f, 0.f };
+};
+
+class DecayFxResolver : public fx::IFxResolver
+{
+public:
+    DecayFxResolver(IFxProcessorPtr fx)
+        : m_fx(fx) {}
+
+    std::vector<IFxProcessorPtr> resolveMasterFxList(const AudioFxChain&) override { return {}; }
+    std::vector<IFxProcessorPtr> resolveFxList(const TrackId, const AudioFxChain&) override { return { m_fx }; }
+    AudioResourceMetaList resolveAvailableResources() const override { return {}; }
+    void registerResolver(const AudioFxType, IResolverPtr) override {}
+    void clearAllFx() override {}
+
+private:
+    IFxProcessorPtr m_fx;
+};
+
+class Audio_MixerChannelTest : public ::testing::Test
+{
+public:
+    void SetUp() override
+    {
+        AudioSanitizer::setupWorkerThread();
+
+        m_source = std::make_shared<SwitchableSource>();
+        m_fx = std::make_shared<DecayFx>();
+
+        m_channel = std::make_shared<MixerChannel>(0, m_source, 44100);
+        m_channel->setfxResolver(std::make_shared<DecayFxResolver>(m_fx));
+
+        AudioOutputParams params;
+        params.fxChain.emplace(m_fx->params().chainOrder, m_fx->params());
+        m_channel->applyOutputParams(params);
+
+        m_buffer.resize(RENDER_STEP * 2);
+    }
+
+    samples_t process()
+    {
+        return m_channel->process(m_buffer.data(), RENDER_STEP);
+    }
+
+    bool bufferIsSilent() const
+    {
+        return std::all_of(m_buffer.begin(), m_buffer.end(), [](float sample) { return sample == 0.f; });
+    }
+
+    static constexpr samples_t RENDER_STEP = 512;
+
+    std::shared_ptr<SwitchableSource> m_source;
+    std::shared_ptr<DecayFx> m_fx;
+    MixerChannelPtr m_channel;
+    std::vector<float> m_buffer;
+};
+}
+
+/**
+ * @brief Audio_MixerChannelTest_SilentChannelSleeps
+ * @details A channel whose source produces nothing runs its effects once on the silence,
+ *          then produces no samples and skips its effects, while still asking the source every step
+ */
+TEST_F(Audio_MixerChannelTest, SilentChannelSleeps)
+{
+    EXPECT_EQ(process(), RENDER_STEP);
+    EXPECT_TRUE(bufferIsSilent());
+    EXPECT_EQ(m_fx->calls, 1);
+
+    for (int i = 0; i < 10; ++i) {
+        EXPECT_EQ(process(), 0u);
+        EXPECT_TRUE(bufferIsSilent());
+    }
+
+    EXPECT_EQ(m_fx->calls, 1);
+    EXPECT_EQ(m_source->calls, 11);
+}
+
+/**
+ * @brief Audio_MixerChannelTest_TailRingsOutBeforeSleeping
+ * @details When the source stops, the effects tail keeps playing, decaying, until it is inaudible
+ */
+TEST_F(Audio_MixerChannelTest, TailRingsOutBeforeSleeping)
+{
+    m_source->playing = true;
+    for (int i = 0; i < 10; ++i) {
+        EXPECT_EQ(process(), RENDER_STEP);
+    }
+
+    m_source->playing = false;
+
+    int ringingSteps = 0;
+    float lastPeak = std::numeric_limits<float>::max();
+
+    while (process() == RENDER_STEP) {
+        float peak = *std::max_element(m_buffer.begin(), m_buffer.end());
+
+        //! CHECK The tail is not cut, it decays step by step
+        EXPECT_GT(peak, 0.f);
+        EXPECT_LT(peak, lastPeak);
+        lastPeak = peak;
+
+        ASSERT_LT(++ringingSteps, 100);
+    }
+
+    EXPECT_GT(ringingSteps, 1);
+    EXPECT_TRUE(bufferIsSilent());
+
+    int fxCalls = m_fx->calls;
+    EXPECT_EQ(process(), 0u);
+    EXPECT_EQ(m_fx->calls, fxCalls);
+}
+
+/**
+ * @brief Audio_MixerChannelTest_WakesOnNewInput
+ * @details A sleeping channel processes again, effects included, as soon as its source produces samples
+ */
+TEST_F(Audio_MixerChannelTest, WakesOnNewInput)
+{
+    process();
+    ASSERT_EQ(process(), 0u);
+
+    int fxCalls = m_fx->calls;
+
+    m_source->playing = true;
+    EXPECT_EQ(process(), RENDER_STEP);
+    EXPECT_FALSE(bufferIsSilent());
+    EXPECT_EQ(m_fx->calls, fxCalls + 1);
+
+    //! CHECK Stopped again, it rings out and sleeps again
+    m_source->playing = false;
+
+    int steps = 0;
+    while (process() != 0) {
+        ASSERT_LT(++steps, 100);
+    }
+
+    EXPECT_GT(steps, 0);
+}
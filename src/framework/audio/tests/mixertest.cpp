@@ -0,0 +1,164 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2023 MuseScore BVBA and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <vector>
+
+#include "audio/internal/worker/mixer.h"
+#include "audio/internal/audiosanitizer.h"
+
+#include "mocks/audioconfigurationmock.h"
+
+using ::testing::Return;
+
+using namespace mu;
+using namespace mu::audio;
+
+namespace mu::audio {
+class ConstantSource : public AbstractAudioSource
+{
+public:
+    ConstantSource(float value, audioch_t audioChannelsCount)
+        : m_value(value), m_audioChannelsCount(audioChannelsCount) {}
+
+    unsigned int audioChannelsCount() const override
+    {
+        return m_audioChannelsCount;
+    }
+
+    samples_t process(float* buffer, samples_t samplesPerChannel) override
+    {
+        if (!AudioSanitizer::isWorkerThread()) {
+            wrongThreadCalls.fetch_add(1);
+        }
+
+        calls.fetch_add(1);
+
+        std::fill(buffer, buffer + samplesPerChannel * m_audioChannelsCount, m_value);
+
+        return samplesPerChannel;
+    }
+
+    std::atomic<int> calls { 0 };
+    std::atomic<int> wrongThreadCalls { 0 };
+
+private:
+    float m_value = 0.f;
+    audioch_t m_audioChannelsCount = 0;
+};
+
+class Audio_MixerTest : public ::testing::Test
+{
+public:
+    void SetUp() override
+    {
+        AudioSanitizer::setupWorkerThread();
+
+        m_configuration = std::make_shared<AudioConfigurationMock>();
+        ON_CALL(*m_configuration, audioChannelsCount()).WillByDefault(Return(AUDIO_CHANNELS_COUNT));
+        ON_CALL(*m_configuration, renderStep()).WillByDefault(Return(RENDER_STEP));
+
+        m_mixer = std::make_shared<Mixer>();
+        m_mixer->setconfiguration(m_configuration);
+        m_mixer->setAudioChannelsCount(AUDIO_CHANNELS_COUNT);
+        m_mixer->setSampleRate(44100);
+        m_mixer->setIsActive(true);
+    }
+
+    void TearDown() override
+    {
+        m_mixer.reset();
+    }
+
+    static constexpr audioch_t AUDIO_CHANNELS_COUNT = 2;
+    static constexpr samples_t RENDER_STEP = 512;
+
+    std::shared_ptr<AudioConfigurationMock> m_configuration;
+    MixerPtr m_mixer;
+};
+}
+
+//! NOTE More than two tracks go through the thread pool,
+//! where the channels have to pass the same thread checks as on the worker thread
+TEST_F(Audio_MixerTest, ProcessesTracksOnThreadPool)
+{
+    constexpr int TRACKS_COUNT = 6;
+    constexpr float TRACK_VALUE = 0.01f;
+
+    std::vector<std::shared_ptr<ConstantSource> > sources;
+
+    for (int i = 0; i < TRACKS_COUNT; ++i) {
+        auto source = std::make_shared<ConstantSource>(TRACK_VALUE, AUDIO_CHANNELS_COUNT);
+        ASSERT_TRUE(m_mixer->addChannel(i, source).ret);
+        sources.push_back(source);
+    }
+
+    constexpr int RUNS_COUNT = 100;
+    std::vector<float> buffer(RENDER_STEP * AUDIO_CHANNELS_COUNT);
+
+    for (int run = 0; run < RUNS_COUNT; ++run) {
+        EXPECT_EQ(m_mixer->process(buffer.data(), RENDER_STEP), RENDER_STEP);
+    }
+
+    for (const auto& source : sources) {
+        EXPECT_EQ(source->calls.load(), RUNS_COUNT);
+        EXPECT_EQ(source->wrongThreadCalls.load(), 0);
+    }
+
+    //! NOTE The master bus only scales the sum of the tracks, the sum itself must be the same for every sample
+    for (size_t i = AUDIO_CHANNELS_COUNT; i < buffer.size(); ++i) {
+        EXPECT_FLOAT_EQ(buffer[i], buffer[i % AUDIO_CHANNELS_COUNT]);
+    }
+
+    EXPECT_GT(buffer[0], TRACK_VALUE);
+}
+
+//! NOTE An offline slice is longer than the render step, every track renders it at once on the pool
+TEST_F(Audio_MixerTest, ProcessesSliceLongerThanRenderStep)
+{
+    constexpr int TRACKS_COUNT = 3;
+    constexpr samples_t SLICE_SIZE = RENDER_STEP * 4 + 100;
+
+    std::vector<std::shared_ptr<ConstantSource> > sources;
+
+    for (int i = 0; i < TRACKS_COUNT; ++i) {
+        auto source = std::make_shared<ConstantSource>(0.01f, AUDIO_CHANNELS_COUNT);
+        ASSERT_TRUE(m_mixer->addChannel(i, source).ret);
+        sources.push_back(source);
+    }
+
+    std::vector<float> buffer(SLICE_SIZE * AUDIO_CHANNELS_COUNT);
+    EXPECT_EQ(m_mixer->process(buffer.data(), SLICE_SIZE), SLICE_SIZE);
+
+    for (const auto& source : sources) {
+        //! NOTE Four full steps and the remainder
+        EXPECT_EQ(source->calls.load(), 5);
+        EXPECT_EQ(source->wrongThreadCalls.load(), 0);
+    }
+
+    //! NOTE Every step of the slice is mixed, the tail included
+    for (float sample : buffer) {
+        EXPECT_GT(sample, 0.f);
+    }
+}
@@ -0,0 +1,155 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2023 MuseScore BVBA and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <vector>
+
+#include "audio/internal/dsp/samplesprocessing.h"
+
+#include "log.h"
+
+using namespace mu::audio;
+
+namespace mu::audio {
+class Audio_SamplesProcessingTest : public ::testing::Test
+{
+public:
+    static std::vector<float> makeSignal(size_t samplesCount)
+    {
+        std::vector<float> signal(samplesCount);
+        for (size_t i = 0; i < samplesCount; ++i) {
+            signal[i] = static_cast<float>((i * 7919) % 2001) / 1000.f - 1.f;
+        }
+
+        return signal;
+    }
+
+    //! NOTE The strided per channel loop the mixer used before the kernels
+    static void applyGainsScalar(float* buffer, audioch_t audioChannelsCount, samples_t samplesPerChannel,
+                                 const dsp::ChannelValues& gains, dsp::ChannelValues& squaredSums)
+    {
+        for (audioch_t audioChNum = 0; audioChNum < audioChannelsCount; ++audioChNum) {
+            squaredSums[audioChNum] = 0.f;
+
+            for (samples_t s = 0; s < samplesPerChannel; ++s) {
+                size_t idx = s * audioChannelsCount + audioChNum;
+
+                float resultSample = buffer[idx] * gains[audioChNum];
+                buffer[idx] = resultSample;
+                squaredSums[audioChNum] += resultSample * resultSample;
+            }
+        }
+    }
+};
+}
+
+TEST_F(Audio_SamplesProcessingTest, ApplyGains)
+{
+    for (audioch_t audioChannelsCount : { 1, 2, 3, 4 }) {
+        // 67 frames, so that the vectorized loop leaves a tail
+        constexpr samples_t SAMPLES_PER_CHANNEL = 67;
+
+        std::vector<float> expected = makeSignal(SAMPLES_PER_CHANNEL * audioChannelsCount);
+        std::vector<float> actual = expected;
+
+        dsp::ChannelValues gains;
+        for (audioch_t audioChNum = 0; audioChNum < audioChannelsCount; ++audioChNum) {
+            gains[audioChNum] = 0.5f + audioChNum * 0.25f;
+        }
+
+        dsp::ChannelValues expectedSums;
+        applyGainsScalar(expected.data(), audioChannelsCount, SAMPLES_PER_CHANNEL, gains, expectedSums);
+
+        dsp::ChannelValues actualSums;
+        dsp::applyGains(actual.data(), audioChannelsCount, SAMPLES_PER_CHANNEL, gains, actualSums);
+
+        for (size_t i = 0; i < expected.size(); ++i) {
+            ASSERT_FLOAT_EQ(expected[i], actual[i]);
+        }
+
+        for (audioch_t audioChNum = 0; audioChNum < audioChannelsCount; ++audioChNum) {
+            EXPECT_NEAR(expectedSums[audioChNum], actualSums[audioChNum], expectedSums[audioChNum] * 1e-5f);
+        }
+    }
+}
+
+TEST_F(Audio_SamplesProcessingTest, MixSamples)
+{
+    constexpr size_t SAMPLES_COUNT = 131;
+
+    std::vector<float> src = makeSignal(SAMPLES_COUNT);
+    std::vector<float> dst(SAMPLES_COUNT, 0.25f);
+    std::vector<float> dstWithGain(SAMPLES_COUNT, 0.25f);
+
+    float peak = dsp::mixSamples(dst.data(), src.data(), SAMPLES_COUNT);
+    dsp::mixSamples(dstWithGain.data(), src.data(), SAMPLES_COUNT, 0.5f);
+
+    float expectedPeak = 0.f;
+    for (size_t i = 0; i < SAMPLES_COUNT; ++i) {
+        EXPECT_FLOAT_EQ(dst[i], 0.25f + src[i]);
+        EXPECT_FLOAT_EQ(dstWithGain[i], 0.25f + src[i] * 0.5f);
+        expectedPeak = std::max(expectedPeak, std::abs(src[i]));
+    }
+
+    EXPECT_FLOAT_EQ(peak, expectedPeak);
+
+    std::vector<float> silence(SAMPLES_COUNT, 0.f);
+    EXPECT_FLOAT_EQ(dsp::mixSamples(dst.data(), silence.data(), SAMPLES_COUNT), 0.f);
+}
+
+//! NOTE Only timings, run it with --gtest_also_run_disabled_tests
+TEST_F(Audio_SamplesProcessingTest, DISABLED_ApplyGainsBenchmark)
+{
+    // 64 tracks of 512 stereo frames, as a mixer callback
+    constexpr audioch_t AUDIO_CHANNELS_COUNT = 2;
+    constexpr samples_t SAMPLES_PER_CHANNEL = 512;
+    constexpr int ITERATIONS = 64 * 200;
+
+    std::vector<float> buffer = makeSignal(SAMPLES_PER_CHANNEL * AUDIO_CHANNELS_COUNT);
+
+    dsp::ChannelValues gains;
+    gains[0] = 0.999f;
+    gains[1] = 1.001f;
+    dsp::ChannelValues squaredSums;
+
+    auto measure = [&](auto func) {
+        float checksum = 0.f;
+        auto start = std::chrono::steady_clock::now();
+
+        for (int i = 0; i < ITERATIONS; ++i) {
+            func(buffer.data(), AUDIO_CHANNELS_COUNT, SAMPLES_PER_CHANNEL, gains, squaredSums);
+            checksum += squaredSums[0];
+        }
+
+        auto duration = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+        EXPECT_GT(checksum, 0.f);
+
+        return duration.count();
+    };
+
+    auto scalarUs = measure(applyGainsScalar);
+    auto kernelUs = measure(dsp::applyGains);
+
+    LOGI() << "applyGains, scalar: " << scalarUs << " us, kernel: " << kernelUs << " us";
+}
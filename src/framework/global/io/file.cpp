@@ -42,6 +42,11 @@ path_t File::filePath() const
     return m_filePath;
 }
 
+void File::setMemoryMapped(bool arg)
+{
+    m_memoryMapped = arg;
+}
+
 bool File::exists() const
 {
     return fileSystem()->exists(m_filePath);
@@ -103,6 +108,17 @@ bool File::doOpen(OpenMode m)
         }
     }
 
+    if (m_memoryMapped && m == OpenMode::ReadOnly) {
+        RetVal<ByteArray> rv = fileSystem()->mapFile(m_filePath);
+        if (!rv.ret) {
+            setError(rv.ret.code(), rv.ret.text());
+            return false;
+        }
+
+        m_data = rv.val;
+        return true;
+    }
+
     m_data = ByteArray();
     Ret ret = fileSystem()->readFile(m_filePath, m_data);
     if (!ret) {
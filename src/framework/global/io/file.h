@@ -40,6 +40,9 @@ public:
 
     path_t filePath() const;
 
+    //! NOTE If set, the file opened as ReadOnly is mapped into memory instead of being read
+    void setMemoryMapped(bool arg);
+
     bool exists() const;
     bool remove();
 
@@ -62,6 +65,7 @@ private:
 
     path_t m_filePath;
     ByteArray m_data;
+    bool m_memoryMapped = false;
 };
 }
 
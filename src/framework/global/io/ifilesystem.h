@@ -63,6 +63,10 @@ public:
     virtual Ret readFile(const io::path_t& filePath, ByteArray& data) const = 0;
     virtual Ret writeFile(const io::path_t& filePath, const ByteArray& data) const = 0;
 
+    //! NOTE Maps the file into memory read only, the mapping lives as long as the returned data or its copies.
+    //! Falls back to reading the file if it can't be mapped
+    virtual RetVal<ByteArray> mapFile(const io::path_t& filePath) const = 0;
+
     //! NOTE File info
     virtual io::path_t canonicalFilePath(const io::path_t& filePath) const = 0;
     virtual io::path_t absolutePath(const io::path_t& filePath) const = 0;
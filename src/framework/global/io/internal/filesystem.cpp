@@ -219,6 +219,36 @@ Ret FileSystem::writeFile(const io::path_t& filePath, const ByteArray& data) con
     return ret;
 }
 
+RetVal<ByteArray> FileSystem::mapFile(const io::path_t& filePath) const
+{
+    RetVal<ByteArray> result;
+
+    auto file = std::make_shared<QFile>(filePath.toQString());
+    if (!file->open(QIODevice::ReadOnly)) {
+        result.ret = make_ret(Err::FSReadError);
+        result.ret.setText(file->errorString().toStdString());
+        return result;
+    }
+
+    qint64 size = file->size();
+    if (size == 0) {
+        result.ret = make_ok();
+        return result;
+    }
+
+    //! NOTE The file is unmapped when the QFile is destroyed
+    const uchar* data = file->map(0, size);
+    if (!data) {
+        LOGW() << "failed map file: " << filePath << ", err: " << file->errorString();
+        file->close();
+        return readFile(filePath);
+    }
+
+    result.ret = make_ok();
+    result.val = ByteArray::fromRawData(data, static_cast<size_t>(size), file);
+    return result;
+}
+
 Ret FileSystem::makePath(const io::path_t& path) const
 {
     if (!QDir().mkpath(path.toQString())) {
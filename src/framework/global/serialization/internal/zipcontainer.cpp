@@ -23,8 +23,11 @@
 
 #include <ctime>
 #include <cstring>
+#include <future>
+#include <mutex>
 #include <zlib.h>
 
+#include "concurrency/taskscheduler.h"
 #include "io/dir.h"
 
 #include "log.h"
@@ -149,7 +152,7 @@ static int inflate(Bytef* dest, ulong* destLen, const Bytef* source, ulong sourc
     return err;
 }
 
-static int deflate(Bytef* dest, ulong* destLen, const Bytef* source, ulong sourceLen)
+static int deflate(Bytef* dest, ulong* destLen, const Bytef* source, ulong sourceLen, int level)
 {
     z_stream stream;
     int err;
@@ -166,7 +169,7 @@ static int deflate(Bytef* dest, ulong* destLen, const Bytef* source, ulong sourc
     stream.zfree = (free_func)0;
     stream.opaque = (voidpf)0;
 
-    err = deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY);
+    err = deflateInit2(&stream, level, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY);
     if (err != Z_OK) {
         return err;
     }
@@ -182,6 +185,123 @@ static int deflate(Bytef* dest, ulong* destLen, const Bytef* source, ulong sourc
     return err;
 }
 
+static ByteArray deflateData(const ByteArray& contents, int level)
+{
+    ByteArray data;
+    ulong len = (ulong)contents.size();
+    // shamelessly copied form zlib
+    len += (len >> 12) + (len >> 14) + 11;
+    int res;
+    do {
+        data.resize(len);
+        res = deflate((uint8_t*)data.data(), &len, (const uint8_t*)contents.constData(), (ulong)contents.size(), level);
+
+        switch (res) {
+        case Z_OK:
+            data.resize(len);
+            break;
+        case Z_MEM_ERROR:
+            LOGW("Zip: Z_MEM_ERROR: Not enough memory to compress file, skipping");
+            data.resize(0);
+            break;
+        case Z_BUF_ERROR:
+            len *= 2;
+            break;
+        }
+    } while (res == Z_BUF_ERROR);
+
+    return data;
+}
+
+//! NOTE Large files are compressed in chunks concurrently, like pigz does.
+//! Every chunk is primed with the end of the previous one and ends byte aligned (Z_SYNC_FLUSH),
+//! so the concatenated chunks are a single deflate stream
+static constexpr size_t DEFLATE_CHUNK_SIZE = 1024 * 1024;
+static constexpr size_t DEFLATE_DICT_SIZE = 32 * 1024;
+
+static ByteArray deflateChunk(const uint8_t* dict, size_t dictLen, const uint8_t* source, size_t sourceLen, bool last, int level)
+{
+    z_stream stream;
+    std::memset(&stream, 0, sizeof(z_stream));
+
+    if (deflateInit2(&stream, level, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+        return ByteArray();
+    }
+
+    if (dictLen > 0 && deflateSetDictionary(&stream, dict, (uInt)dictLen) != Z_OK) {
+        deflateEnd(&stream);
+        return ByteArray();
+    }
+
+    // the sync flush marker takes a few more bytes than the bound of a finished stream
+    ByteArray data;
+    data.resize(deflateBound(&stream, (uLong)sourceLen) + 16);
+
+    stream.next_in = const_cast<Bytef*>(source);
+    stream.avail_in = (uInt)sourceLen;
+    stream.next_out = (Bytef*)data.data();
+    stream.avail_out = (uInt)data.size();
+
+    int err = deflate(&stream, last ? Z_FINISH : Z_SYNC_FLUSH);
+    bool ok = last ? err == Z_STREAM_END : (err == Z_OK && stream.avail_in == 0 && stream.avail_out > 0);
+    data.resize(stream.total_out);
+
+    deflateEnd(&stream);
+
+    return ok ? data : ByteArray();
+}
+
+static std::vector<std::future<ByteArray> > deflateChunksAsync(TaskScheduler* scheduler, const ByteArray& contents, int level)
+{
+    std::vector<std::future<ByteArray> > chunks;
+
+    const size_t size = contents.size();
+    for (size_t pos = 0; pos < size || pos == 0; pos += DEFLATE_CHUNK_SIZE) {
+        const size_t len = std::min(DEFLATE_CHUNK_SIZE, size - pos);
+        const size_t dictLen = std::min(DEFLATE_DICT_SIZE, pos);
+        const bool last = pos + len >= size;
+
+        chunks.push_back(scheduler->submit([contents, pos, len, dictLen, last, level]() {
+            const uint8_t* data = contents.constData();
+            return deflateChunk(data + pos - dictLen, dictLen, data + pos, len, last, level);
+        }));
+
+        if (last) {
+            break;
+        }
+    }
+
+    return chunks;
+}
+
+static ByteArray joinChunks(std::vector<std::future<ByteArray> >& chunks)
+{
+    std::vector<ByteArray> parts;
+    parts.reserve(chunks.size());
+
+    size_t size = 0;
+    bool ok = true;
+    for (std::future<ByteArray>& chunk : chunks) {
+        parts.push_back(chunk.get());
+        ok &= !parts.back().empty();
+        size += parts.back().size();
+    }
+
+    if (!ok) {
+        return ByteArray();
+    }
+
+    ByteArray data;
+    data.resize(size);
+    uint8_t* dst = (uint8_t*)data.data();
+    for (const ByteArray& part : parts) {
+        std::memcpy(dst, part.constData(), part.size());
+        dst += part.size();
+    }
+
+    return data;
+}
+
 namespace WindowsFileAttributes {
 enum {
     Dir        = 0x10, // FILE_ATTRIBUTE_DIRECTORY
@@ -372,6 +492,10 @@ LocalFileHeader CentralFileHeader::toLocalHeader() const
 struct ZipContainer::Impl {
     IODevice* device = nullptr;
 
+    //! NOTE Guards the device and the file tree,
+    //! so that files can be read from several threads at once
+    std::mutex readMutex;
+
     bool dirtyFileTree = true;
     std::vector<FileHeader> fileHeaders;
     ByteArray comment;
@@ -379,12 +503,33 @@ struct ZipContainer::Impl {
     ZipContainer::Status status = ZipContainer::NoError;
 
     ZipContainer::CompressionPolicy compressionPolicy = ZipContainer::AlwaysCompress;
+    int compressionLevel = Z_DEFAULT_COMPRESSION;
+    bool parallelCompression = false;
 
     enum EntryType {
         Directory, File, Symlink
     };
 
-    void addEntry(EntryType type, const std::string& fileName, const ByteArray& contents);
+    //! NOTE An entry waiting for its compression to finish, entries are written in the order they were added
+    struct PendingEntry {
+        EntryType type = File;
+        std::string fileName;
+        ushort compressionMethod = CompressionMethodStored;
+        uint crc_32 = 0;
+        uint uncompressedSize = 0;
+        ByteArray data;
+        ByteArray chunksSource;
+        std::vector<std::future<ByteArray> > chunks;
+    };
+
+    std::vector<PendingEntry> pendingEntries;
+
+    void writePendingEntries();
+    void writeEntry(const PendingEntry& entry);
+
+    void addEntry(EntryType type, const std::string& fileName, const ByteArray& contents,
+                  const ZipContainer::RawFileData* previous = nullptr);
+    int findFileHeader(const ByteArray& fileName) const;
     bool writeToDevice(const uint8_t* data, size_t len);
     bool writeToDevice(const ByteArray& data);
 
@@ -547,13 +692,45 @@ ZipContainer::FileInfo ZipContainer::Impl::fillFileInfo(int index) const
     return fileInfo;
 }
 
-void ZipContainer::Impl::addEntry(EntryType type, const std::string& fileName, const ByteArray& contents)
+int ZipContainer::Impl::findFileHeader(const ByteArray& fileName) const
+{
+    for (size_t i = 0; i < fileHeaders.size(); ++i) {
+        if (fileHeaders.at(i).file_name == fileName) {
+            return static_cast<int>(i);
+        }
+    }
+
+    return -1;
+}
+
+//! NOTE Different contents can have the same CRC32 and size, so the previous data
+//! is only reused if it really is the same. Inflating is still much cheaper than deflating again
+static bool isSameContent(const ZipContainer::RawFileData& previous, const ByteArray& contents)
+{
+    if (previous.compressionMethod == CompressionMethodStored) {
+        return previous.data == contents;
+    }
+
+    if (previous.compressionMethod != CompressionMethodDeflated || contents.empty()) {
+        return false;
+    }
+
+    ByteArray inflated(contents.size());
+    ulong len = static_cast<ulong>(inflated.size());
+    int res = inflate(inflated.data(), &len, previous.data.constData(), static_cast<ulong>(previous.data.size()));
+
+    return res == Z_OK
+           && len == contents.size()
+           && std::memcmp(inflated.constData(), contents.constData(), contents.size()) == 0;
+}
+
+void ZipContainer::Impl::addEntry(EntryType type, const std::string& fileName, const ByteArray& contents,
+                                  const ZipContainer::RawFileData* previous)
 {
     if (!(device->isOpen() || device->open(IODevice::WriteOnly))) {
         status = ZipContainer::FileOpenError;
         return;
     }
-    device->seek(start_of_directory);
 
     // don't compress small files
     ZipContainer::CompressionPolicy compression = compressionPolicy;
@@ -565,54 +742,91 @@ void ZipContainer::Impl::addEntry(EntryType type, const std::string& fileName, c
         }
     }
 
+    PendingEntry entry;
+    entry.type = type;
+    entry.fileName = fileName;
+    entry.uncompressedSize = (uint)contents.size();
+
+    entry.crc_32 = ::crc32(0, 0, 0);
+    entry.crc_32 = ::crc32(entry.crc_32, (const uint8_t*)contents.constData(), (uint)contents.size());
+
+    // the content hasn't changed since the previous container, no need to compress it again
+    const bool reusePrevious = previous
+                               && previous->crc == entry.crc_32
+                               && previous->size == static_cast<int64_t>(contents.size())
+                               && isSameContent(*previous, contents);
+
+    TaskScheduler* scheduler = TaskScheduler::instance();
+    const bool parallel = parallelCompression && !scheduler->containsThread(std::this_thread::get_id());
+
+    if (reusePrevious) {
+        entry.compressionMethod = (ushort)previous->compressionMethod;
+        entry.data = previous->data;
+    } else if (compression == ZipContainer::AlwaysCompress) {
+        entry.compressionMethod = CompressionMethodDeflated;
+        if (parallel) {
+            entry.chunksSource = contents;
+            entry.chunks = deflateChunksAsync(scheduler, contents, compressionLevel);
+        } else {
+            entry.data = deflateData(contents, compressionLevel);
+        }
+    } else {
+        entry.compressionMethod = CompressionMethodStored;
+        entry.data = contents;
+    }
+
+    pendingEntries.push_back(std::move(entry));
+
+    if (!parallel) {
+        writePendingEntries();
+    }
+}
+
+void ZipContainer::Impl::writePendingEntries()
+{
+    for (PendingEntry& entry : pendingEntries) {
+        if (!entry.chunks.empty()) {
+            entry.data = joinChunks(entry.chunks);
+            if (entry.data.empty()) {
+                LOGW("Zip: failed to compress file in chunks, compressing it as a whole");
+                entry.data = deflateData(entry.chunksSource, compressionLevel);
+            }
+        }
+
+        writeEntry(entry);
+    }
+
+    pendingEntries.clear();
+}
+
+void ZipContainer::Impl::writeEntry(const PendingEntry& entry)
+{
+    device->seek(start_of_directory);
+
     FileHeader header;
     std::memset(&header.h, 0, sizeof(CentralFileHeader));
     writeUInt(header.h.signature, 0x02014b50);
 
     writeUShort(header.h.version_needed, ZIP_VERSION);
-    writeUInt(header.h.uncompressed_size, (uint)contents.size());
+    writeUInt(header.h.uncompressed_size, entry.uncompressedSize);
 
     std::time_t t = std::time(0);   // get time now
     std::tm* now = std::localtime(&t);
     writeMSDosDate(header.h.last_mod_file, *now);
-    ByteArray data = contents;
-    if (compression == ZipContainer::AlwaysCompress) {
-        writeUShort(header.h.compression_method, CompressionMethodDeflated);
 
-        ulong len = (ulong)contents.size();
-        // shamelessly copied form zlib
-        len += (len >> 12) + (len >> 14) + 11;
-        int res;
-        do {
-            data.resize(len);
-            res = deflate((uint8_t*)data.data(), &len, (const uint8_t*)contents.constData(), (ulong)contents.size());
+    writeUInt(header.h.crc_32, entry.crc_32);
+    writeUShort(header.h.compression_method, entry.compressionMethod);
 
-            switch (res) {
-            case Z_OK:
-                data.resize(len);
-                break;
-            case Z_MEM_ERROR:
-                LOGW("Zip: Z_MEM_ERROR: Not enough memory to compress file, skipping");
-                data.resize(0);
-                break;
-            case Z_BUF_ERROR:
-                len *= 2;
-                break;
-            }
-        } while (res == Z_BUF_ERROR);
-    }
+    const ByteArray& data = entry.data;
 // TODO add a check if data.size() > contents.size().  Then try to store the original and revert the compression method to be uncompressed
     writeUInt(header.h.compressed_size, (uint)data.size());
-    uint crc_32 = ::crc32(0, 0, 0);
-    crc_32 = ::crc32(crc_32, (const uint8_t*)contents.constData(), (uint)contents.size());
-    writeUInt(header.h.crc_32, crc_32);
 
     // if bit 11 is set, the filename and comment fields must be encoded using UTF-8
     ushort general_purpose_bits = Utf8Names; // always use utf-8
     writeUShort(header.h.general_purpose_bits, general_purpose_bits);
 
     //const bool inUtf8 = (general_purpose_bits & Utf8Names) != 0;
-    header.file_name = ByteArray(fileName.c_str(), fileName.size());
+    header.file_name = ByteArray(entry.fileName.c_str(), entry.fileName.size());
     if (header.file_name.size() > 0xffff) {
         LOGW("Zip: Filename is too long, chopping it to 65535 bytes");
         header.file_name = header.file_name.left(0xffff); // ### don't break the utf-8 sequence, if any
@@ -632,7 +846,7 @@ void ZipContainer::Impl::addEntry(EntryType type, const std::string& fileName, c
                     | UnixFileAttributes::ExeUser
                     | UnixFileAttributes::ReadGroup
                     | UnixFileAttributes::ReadOther;
-    switch (type) {
+    switch (entry.type) {
     case Symlink:
         mode |= UnixFileAttributes::SymLink;
         break;
@@ -690,6 +904,7 @@ ZipContainer::~ZipContainer()
 
 std::vector<ZipContainer::FileInfo> ZipContainer::fileInfoList() const
 {
+    std::lock_guard lock(p->readMutex);
     p->scanFiles();
     std::vector<FileInfo> files;
     const int numFileHeaders = (int)p->fileHeaders.size();
@@ -702,36 +917,28 @@ std::vector<ZipContainer::FileInfo> ZipContainer::fileInfoList() const
 
 int ZipContainer::count() const
 {
+    std::lock_guard lock(p->readMutex);
     p->scanFiles();
     return (int)p->fileHeaders.size();
 }
 
 bool ZipContainer::fileExists(const std::string& fileName) const
 {
+    std::lock_guard lock(p->readMutex);
     p->scanFiles();
     ByteArray fileNameBa = ByteArray::fromRawData(fileName.c_str(), fileName.size());
-    for (size_t i = 0; i < p->fileHeaders.size(); ++i) {
-        if (p->fileHeaders.at(i).file_name == fileNameBa) {
-            return true;
-        }
-    }
-    return false;
+    return p->findFileHeader(fileNameBa) != -1;
 }
 
 ByteArray ZipContainer::fileData(const std::string& fileName) const
 {
+    std::unique_lock lock(p->readMutex);
     p->scanFiles();
 
     ByteArray fileNameBa = ByteArray::fromRawData(fileName.c_str(), fileName.size());
 
-    size_t i;
-    for (i = 0; i < p->fileHeaders.size(); ++i) {
-        if (p->fileHeaders.at(i).file_name == fileNameBa) {
-            break;
-        }
-    }
-
-    if (i == p->fileHeaders.size()) {
+    int i = p->findFileHeader(fileNameBa);
+    if (i == -1) {
         return ByteArray();
     }
 
@@ -761,22 +968,31 @@ ByteArray ZipContainer::fileData(const std::string& fileName) const
         return ByteArray();
     }
 
-    ByteArray compressed = p->device->read(compressed_size);
+    //! NOTE The entry is taken straight from the device data (e.g. a memory mapped file),
+    //! so the compressed data isn't copied before inflating
+    const size_t dataPos = p->device->pos();
+    const uint8_t* deviceData = p->device->readData();
+    if (!deviceData || compressed_size < 0 || dataPos + compressed_size > p->device->size()) {
+        LOGW("Zip: The data of the entry is truncated.");
+        return ByteArray();
+    }
+
+    const uint8_t* compressed = deviceData + dataPos;
+
+    // the rest only works with the device data, which isn't changed by reading, other files can be read meanwhile
+    lock.unlock();
+
     if (compression_method == CompressionMethodStored) {
         // no compression
-        compressed.truncate(uncompressed_size);
-        return compressed;
+        return ByteArray(compressed, static_cast<size_t>(std::min(compressed_size, uncompressed_size)));
     } else if (compression_method == CompressionMethodDeflated) {
         // Deflate
-        //qDebug("compressed=%d", compressed.size());
-        compressed.truncate(compressed_size);
         ByteArray baunzip;
         ulong len = std::max(uncompressed_size,  1);
         int res;
         do {
             baunzip.resize(len);
-            res = inflate((uint8_t*)baunzip.data(), &len,
-                          (const uint8_t*)compressed.constData(), compressed_size);
+            res = inflate((uint8_t*)baunzip.data(), &len, compressed, compressed_size);
 
             switch (res) {
             case Z_OK:
@@ -802,8 +1018,53 @@ ByteArray ZipContainer::fileData(const std::string& fileName) const
     return ByteArray();
 }
 
+ZipContainer::RawFileData ZipContainer::rawFileData(const std::string& fileName) const
+{
+    std::lock_guard lock(p->readMutex);
+    p->scanFiles();
+
+    ByteArray fileNameBa = ByteArray::fromRawData(fileName.c_str(), fileName.size());
+
+    int i = p->findFileHeader(fileNameBa);
+    if (i == -1) {
+        return RawFileData();
+    }
+
+    const FileHeader& header = p->fileHeaders.at(i);
+
+    ushort general_purpose_bits = readUShort(header.h.general_purpose_bits);
+    if ((general_purpose_bits & (Encrypted | HasDataDescriptor)) != 0) {
+        return RawFileData();
+    }
+
+    size_t compressed_size = readUInt(header.h.compressed_size);
+
+    p->device->seek(readUInt(header.h.offset_local_header));
+    LocalFileHeader lh;
+    if (p->device->read((uint8_t*)&lh, sizeof(LocalFileHeader)) != sizeof(LocalFileHeader)) {
+        return RawFileData();
+    }
+
+    uint skip = readUShort(lh.file_name_length) + readUShort(lh.extra_field_length);
+    p->device->seek(p->device->pos() + skip);
+
+    RawFileData raw;
+    raw.filePath = fileName;
+    raw.crc = readUInt(header.h.crc_32);
+    raw.size = readUInt(header.h.uncompressed_size);
+    raw.compressionMethod = readUShort(lh.compression_method);
+    raw.data = p->device->read(compressed_size);
+    if (raw.data.size() != compressed_size) {
+        LOGW("Zip: The data of the entry is truncated.");
+        return RawFileData();
+    }
+
+    return raw;
+}
+
 ZipContainer::Status ZipContainer::status() const
 {
+    std::lock_guard lock(p->readMutex);
     return p->status;
 }
 
@@ -817,11 +1078,36 @@ ZipContainer::CompressionPolicy ZipContainer::compressionPolicy() const
     return p->compressionPolicy;
 }
 
+void ZipContainer::setCompressionLevel(int level)
+{
+    p->compressionLevel = level;
+}
+
+int ZipContainer::compressionLevel() const
+{
+    return p->compressionLevel;
+}
+
+void ZipContainer::setParallelCompression(bool parallel)
+{
+    p->parallelCompression = parallel;
+}
+
+bool ZipContainer::parallelCompression() const
+{
+    return p->parallelCompression;
+}
+
 void ZipContainer::addFile(const std::string& fileName, const ByteArray& data)
 {
     p->addEntry(Impl::File, Dir::fromNativeSeparators(fileName).toStdString(), data);
 }
 
+void ZipContainer::addFile(const std::string& fileName, const ByteArray& data, const RawFileData& previous)
+{
+    p->addEntry(Impl::File, Dir::fromNativeSeparators(fileName).toStdString(), data, previous.isValid() ? &previous : nullptr);
+}
+
 void ZipContainer::addDirectory(const std::string& dirName)
 {
     std::string name(Dir::fromNativeSeparators(dirName).toStdString());
@@ -839,6 +1125,8 @@ void ZipContainer::close()
         return;
     }
 
+    p->writePendingEntries();
+
     bool ok = true;
 
     //qDebug("Zip::close writing directory, %d entries", p->fileHeaders.size());
@@ -66,6 +66,20 @@ public:
     bool fileExists(const std::string& fileName) const;
     ByteArray fileData(const std::string& fileName) const;
 
+    //! NOTE The entry as it's stored in the container, without inflating it
+    struct RawFileData
+    {
+        std::string filePath;
+        unsigned int crc = 0;
+        int64_t size = 0;
+        int compressionMethod = 0;
+        ByteArray data;
+
+        bool isValid() const { return !filePath.empty(); }
+    };
+
+    RawFileData rawFileData(const std::string& fileName) const;
+
     // Write
     enum CompressionPolicy {
         AlwaysCompress,
@@ -76,7 +90,17 @@ public:
     void setCompressionPolicy(CompressionPolicy policy);
     CompressionPolicy compressionPolicy() const;
 
+    // zlib compression level, from 0 (none) to 9 (best), -1 is the zlib default
+    void setCompressionLevel(int level);
+    int compressionLevel() const;
+
+    // the files are compressed on the worker pool and written in order on close
+    void setParallelCompression(bool parallel);
+    bool parallelCompression() const;
+
     void addFile(const std::string& fileName, const ByteArray& data);
+    // if previous has the same content, its compressed data is written as is
+    void addFile(const std::string& fileName, const ByteArray& data, const RawFileData& previous);
     void addDirectory(const std::string& dirName);
 
 private:
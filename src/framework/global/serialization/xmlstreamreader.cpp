@@ -21,23 +21,682 @@
  */
 #include "xmlstreamreader.h"
 
+#include <cctype>
 #include <cstring>
-
-#include "thirdparty/tinyxml/tinyxml2.h"
+#include <map>
+#include <string>
+#include <vector>
 
 #include "log.h"
 
 using namespace mu;
 using namespace mu::io;
-using namespace tinyxml2;
+
+//! NOTE The reader tokenizes the input in place, one token per readNext(), without building a document tree.
+//! It takes the data over, it is copied only if the caller still shares it (see ByteArray::data).
+//! Names and values are decoded (entities, line ends) and terminated in the data,
+//! so the views returned for them stay valid as long as the data is set.
+//! A malformed document is reported where it fails, as by QXmlStreamReader: readNext() returns Invalid there.
+//! Like the tinyxml2 based reader it replaces, it drops text that consists of whitespace only,
+//! skips processing instructions after the XML declaration, and doesn't end an element without content
+//! that is followed by a comment (see Xml::readToken).
+
+namespace {
+struct ParsedAttribute {
+    const char* name = nullptr;
+    const char* value = nullptr;
+    char* nameEnd = nullptr;
+};
+
+inline bool isWhiteSpace(char c)
+{
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+
+inline bool isNameStartChar(unsigned char c)
+{
+    return c >= 128 || std::isalpha(c) || c == ':' || c == '_';
+}
+
+inline bool isNameChar(unsigned char c)
+{
+    return isNameStartChar(c) || std::isdigit(c) || c == '.' || c == '-';
+}
+
+static size_t toUtf8(uint32_t ucs4, char* out)
+{
+    if (ucs4 < 0x80) {
+        out[0] = static_cast<char>(ucs4);
+        return 1;
+    } else if (ucs4 < 0x800) {
+        out[0] = static_cast<char>(0xC0 | (ucs4 >> 6));
+        out[1] = static_cast<char>(0x80 | (ucs4 & 0x3F));
+        return 2;
+    } else if (ucs4 < 0x10000) {
+        out[0] = static_cast<char>(0xE0 | (ucs4 >> 12));
+        out[1] = static_cast<char>(0x80 | ((ucs4 >> 6) & 0x3F));
+        out[2] = static_cast<char>(0x80 | (ucs4 & 0x3F));
+        return 3;
+    } else if (ucs4 < 0x110000) {
+        out[0] = static_cast<char>(0xF0 | (ucs4 >> 18));
+        out[1] = static_cast<char>(0x80 | ((ucs4 >> 12) & 0x3F));
+        out[2] = static_cast<char>(0x80 | ((ucs4 >> 6) & 0x3F));
+        out[3] = static_cast<char>(0x80 | (ucs4 & 0x3F));
+        return 4;
+    }
+    return 0;
+}
+
+//! NOTE Decodes &#123; and &#x7b; to utf-8 at q, returns the position after the reference,
+//! or nullptr if it is not a valid character reference.
+//! The utf-8 sequence is always shorter than the reference, so it can be decoded in place.
+static const char* decodeCharRef(const char* p, const char* end, char*& q)
+{
+    const char* s = p + 2; // skip &#
+    int base = 10;
+    if (s < end && (*s == 'x' || *s == 'X')) {
+        base = 16;
+        ++s;
+    }
+
+    uint32_t ucs4 = 0;
+    const char* digits = s;
+    for (; s < end && *s != ';'; ++s) {
+        int d = -1;
+        if (*s >= '0' && *s <= '9') {
+            d = *s - '0';
+        } else if (base == 16 && *s >= 'a' && *s <= 'f') {
+            d = *s - 'a' + 10;
+        } else if (base == 16 && *s >= 'A' && *s <= 'F') {
+            d = *s - 'A' + 10;
+        }
+        if (d < 0 || ucs4 > 0x10FFFF) {
+            return nullptr;
+        }
+        ucs4 = ucs4 * base + d;
+    }
+
+    if (s == end || s == digits) {
+        return nullptr;
+    }
+
+    size_t len = toUtf8(ucs4, q);
+    if (len == 0) {
+        return nullptr;
+    }
+    q += len;
+    return s + 1;
+}
+
+struct Entity {
+    const char* pattern;
+    size_t length;
+    char value;
+};
+
+static const Entity ENTITIES[] = {
+    { "quot", 4, '\"' },
+    { "amp", 3, '&' },
+    { "apos", 4, '\'' },
+    { "lt", 2, '<' },
+    { "gt", 2, '>' }
+};
+
+//! NOTE Normalizes line ends to \n and, if needed, replaces the predefined entities
+//! and character references, in place. Terminates the result, returns its end.
+static char* decode(char* p, char* end, bool processEntities)
+{
+    char* q = p;
+    while (p < end) {
+        char c = *p;
+        if (c == '\r' || c == '\n') {
+            // CR-LF, LF-CR and a single CR or LF become LF
+            char other = c == '\r' ? '\n' : '\r';
+            p += (p + 1 < end && *(p + 1) == other) ? 2 : 1;
+            *q++ = '\n';
+        } else if (c == '&' && processEntities) {
+            if (p + 1 < end && *(p + 1) == '#') {
+                const char* next = decodeCharRef(p, end, q);
+                if (next) {
+                    p = const_cast<char*>(next);
+                    continue;
+                }
+            } else {
+                bool found = false;
+                for (const Entity& e : ENTITIES) {
+                    if (p + e.length + 1 < end && std::strncmp(p + 1, e.pattern, e.length) == 0 && *(p + e.length + 1) == ';') {
+                        *q++ = e.value;
+                        p += e.length + 2;
+                        found = true;
+                        break;
+                    }
+                }
+                if (found) {
+                    continue;
+                }
+            }
+            // not an entity, keep as is
+            *q++ = *p++;
+        } else {
+            *q++ = *p++;
+        }
+    }
+    *q = 0;
+    return q;
+}
+}
+
+//! NOTE The binary form starts with a zero byte, so it can't be taken for XML.
+//! Records: token type (byte), line, then
+//! StartElement - name, attribute count, attributes (name, string);
+//! Characters, Comment, DTD, StartDocument - string; others - nothing.
+//! Numbers are varints. A name is its index in the table of the names met so far,
+//! a new name is followed by its string. Strings are length, bytes and a terminating zero,
+//! so they can be used in place.
+static const char BINARY_MAGIC[] = { 0, 'M', 'X', 'B', 1 };
+static constexpr size_t BINARY_MAGIC_SIZE = sizeof(BINARY_MAGIC);
+
+static void writeVarInt(ByteArray& out, uint64_t val)
+{
+    while (val >= 0x80) {
+        out.push_back(static_cast<uint8_t>(val | 0x80));
+        val >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(val));
+}
+
+static void writeString(ByteArray& out, const char* str)
+{
+    size_t len = std::strlen(str);
+    writeVarInt(out, len);
+    out.push_back(reinterpret_cast<const uint8_t*>(str), len + 1);
+}
 
 struct XmlStreamReader::Xml {
-    XMLDocument doc;
-    XMLNode* node = nullptr;
-    XMLError err;
+    struct Token {
+        TokenType type = TokenType::NoToken;
+        const char* name = nullptr;
+        const char* value = nullptr;
+        int64_t line = 0;
+        int64_t column = 0;
+        // an end of element that directly follows its start
+        bool endsEmptyElement = false;
+    };
+
+    // the input, XML is decoded in it, the binary form is only read
+    ByteArray data;
+    char* pos = nullptr;
+    const char* end = nullptr;
+    // the '<' before pos was overwritten by the terminator of the preceding text
+    bool tagOpened = false;
+    // read anything but XML declarations
+    bool contentStarted = false;
+    bool pendingEndElement = false;
+
+    std::vector<const char*> openElements;
+    const char* name = nullptr;
+    const char* value = nullptr;
+    // of the last start element read
+    std::vector<ParsedAttribute> attributes;
+    TokenType lastType = TokenType::NoToken;
+
+    // the position of the tokenizer
+    int64_t line = 1;
+    const char* lineStart = nullptr;
+
+    // the data is in the binary form
+    bool binary = false;
+    std::vector<const char*> names;
+
+    Error err = NoError;
+    String errStr;
     String customErr;
+
+    // the current token, and the one read after an element without child nodes, see readToken()
+    Token token;
+    Token lookahead;
+    bool hasLookahead = false;
+
+    void reset(ByteArray&& d)
+    {
+        data = std::move(d);
+        binary = data.size() >= BINARY_MAGIC_SIZE && std::memcmp(data.constData(), BINARY_MAGIC, BINARY_MAGIC_SIZE) == 0;
+        // the binary form is never written, so it is read in place also if it is shared or mapped
+        pos = binary ? const_cast<char*>(data.constChar()) : reinterpret_cast<char*>(data.data());
+        end = pos + data.size();
+        lineStart = pos;
+        tagOpened = false;
+        contentStarted = false;
+        pendingEndElement = false;
+        openElements.clear();
+        name = nullptr;
+        value = nullptr;
+        attributes.clear();
+        lastType = TokenType::NoToken;
+        line = 1;
+        names.clear();
+        if (binary) {
+            pos += BINARY_MAGIC_SIZE;
+        }
+        err = NoError;
+        errStr.clear();
+        customErr.clear();
+        token = Token();
+        lookahead = Token();
+        hasLookahead = false;
+    }
+
+    void countLines(const char* from, const char* to)
+    {
+        for (const char* p = from; p < to; ++p) {
+            if (*p == '\n') {
+                ++line;
+                lineStart = p + 1;
+            }
+        }
+    }
+
+    void skipWhiteSpace()
+    {
+        char* p = pos;
+        while (isWhiteSpace(*p)) {
+            ++p;
+        }
+        countLines(pos, p);
+        pos = p;
+    }
+
+    TokenType setError(Error e, const String& message)
+    {
+        err = e;
+        errStr = message + u" (line " + String::number(line) + u")";
+        return TokenType::Invalid;
+    }
+
+    // the content up to endTag, with normalized line ends
+    char* readUntil(const char* endTag)
+    {
+        char* tagEnd = std::strstr(pos, endTag);
+        if (!tagEnd) {
+            return nullptr;
+        }
+
+        char* start = pos;
+        countLines(start, tagEnd + std::strlen(endTag));
+        pos = tagEnd + std::strlen(endTag);
+        decode(start, tagEnd, false);
+        return start;
+    }
+
+    char* readName()
+    {
+        if (!isNameStartChar(static_cast<unsigned char>(*pos))) {
+            return nullptr;
+        }
+        char* start = pos;
+        while (isNameChar(static_cast<unsigned char>(*pos))) {
+            ++pos;
+        }
+        return start;
+    }
+
+    bool readVarInt(uint64_t& val)
+    {
+        val = 0;
+        for (int shift = 0; pos < end && shift < 64; shift += 7) {
+            uint8_t b = static_cast<uint8_t>(*pos++);
+            val |= static_cast<uint64_t>(b & 0x7F) << shift;
+            if (!(b & 0x80)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    const char* readBinaryString()
+    {
+        uint64_t len = 0;
+        if (!readVarInt(len) || len >= static_cast<uint64_t>(end - pos) || pos[len] != 0) {
+            return nullptr;
+        }
+        const char* str = pos;
+        pos += len + 1;
+        return str;
+    }
+
+    const char* readBinaryName()
+    {
+        uint64_t index = 0;
+        if (!readVarInt(index) || index > names.size()) {
+            return nullptr;
+        }
+        if (index == names.size()) {
+            const char* str = readBinaryString();
+            if (!str) {
+                return nullptr;
+            }
+            names.push_back(str);
+        }
+        return names.at(index);
+    }
+
+    Token scan();
+    const Token& readToken();
+    TokenType next();
+    TokenType nextBinary();
+    TokenType readTag();
+    TokenType readStartElement();
+    TokenType readEndElement();
+    const char* attribute(const char* name) const;
 };
 
+//! NOTE Reads the next token of the input, as it is
+XmlStreamReader::Xml::Token XmlStreamReader::Xml::scan()
+{
+    Token t;
+    if (err != NoError) {
+        t.type = TokenType::Invalid;
+        t.line = line;
+        return t;
+    }
+
+    t.type = binary ? nextBinary() : next();
+    t.name = name;
+    t.value = value;
+    t.line = line;
+    t.column = binary ? 1 : static_cast<int64_t>(pos - lineStart) + 1;
+    t.endsEmptyElement = t.type == TokenType::EndElement && lastType == TokenType::StartElement;
+    lastType = t.type;
+    return t;
+}
+
+//! NOTE The tinyxml2 based reader went from an element without child nodes straight to its next sibling,
+//! if that was a comment or a declaration, without an end of the element.
+//! So after such an end the next token is read ahead, and the end is dropped if it is one of them.
+//! A start element read ahead keeps its attributes, because the end of element before it has none
+const XmlStreamReader::Xml::Token& XmlStreamReader::Xml::readToken()
+{
+    if (hasLookahead) {
+        hasLookahead = false;
+        token = lookahead;
+        return token;
+    }
+
+    token = scan();
+    if (token.endsEmptyElement) {
+        Token t = scan();
+        if (t.type == TokenType::Comment || t.type == TokenType::DTD) {
+            token = t;
+        } else {
+            lookahead = t;
+            hasLookahead = true;
+        }
+    }
+
+    return token;
+}
+
+XmlStreamReader::TokenType XmlStreamReader::Xml::next()
+{
+    name = nullptr;
+    value = nullptr;
+    attributes.clear();
+
+    if (pendingEndElement) {
+        pendingEndElement = false;
+        name = openElements.back();
+        openElements.pop_back();
+        return TokenType::EndElement;
+    }
+
+    if (tagOpened) {
+        tagOpened = false;
+        return readTag();
+    }
+
+    char* start = pos;
+    skipWhiteSpace();
+
+    if (!*pos) {
+        if (!openElements.empty()) {
+            return setError(PrematureEndOfDocumentError,
+                            u"unexpected end of document, missing </" + String::fromUtf8(openElements.back()) + u">");
+        }
+        return TokenType::EndDocument;
+    }
+
+    if (*pos == '<') {
+        ++pos;
+        return readTag();
+    }
+
+    // text, including its leading white space
+    char* end = std::strchr(pos, '<');
+    if (!end) {
+        return setError(PrematureEndOfDocumentError, u"unexpected end of document in text");
+    }
+
+    contentStarted = true;
+    countLines(pos, end);
+    pos = end + 1;
+    tagOpened = true;
+    decode(start, end, true);
+    value = start;
+    return TokenType::Characters;
+}
+
+XmlStreamReader::TokenType XmlStreamReader::Xml::nextBinary()
+{
+    static const String CORRUPTED = u"corrupted binary data";
+
+    name = nullptr;
+    value = nullptr;
+    attributes.clear();
+
+    if (pos == end) {
+        return openElements.empty() ? TokenType::EndDocument : setError(PrematureEndOfDocumentError, CORRUPTED);
+    }
+
+    TokenType type = static_cast<TokenType>(static_cast<uint8_t>(*pos++));
+    uint64_t num = 0;
+    if (!readVarInt(num)) {
+        return setError(NotWellFormedError, CORRUPTED);
+    }
+    line = static_cast<int64_t>(num);
+
+    switch (type) {
+    case TokenType::StartDocument:
+        value = readBinaryString();
+        return value ? type : setError(NotWellFormedError, CORRUPTED);
+    case TokenType::EndDocument:
+        return openElements.empty() ? type : setError(NotWellFormedError, CORRUPTED);
+    case TokenType::StartElement: {
+        name = readBinaryName();
+        uint64_t count = 0;
+        if (!name || !readVarInt(count)) {
+            return setError(NotWellFormedError, CORRUPTED);
+        }
+        for (uint64_t i = 0; i < count; ++i) {
+            const char* attrName = readBinaryName();
+            const char* attrValue = attrName ? readBinaryString() : nullptr;
+            if (!attrValue) {
+                return setError(NotWellFormedError, CORRUPTED);
+            }
+            attributes.push_back({ attrName, attrValue, nullptr });
+        }
+        openElements.push_back(name);
+        return type;
+    }
+    case TokenType::EndElement:
+        if (openElements.empty()) {
+            return setError(NotWellFormedError, CORRUPTED);
+        }
+        name = openElements.back();
+        openElements.pop_back();
+        return type;
+    case TokenType::Characters:
+    case TokenType::Comment:
+    case TokenType::DTD:
+        value = readBinaryString();
+        return value ? type : setError(NotWellFormedError, CORRUPTED);
+    default:
+        break;
+    }
+
+    return setError(NotWellFormedError, CORRUPTED);
+}
+
+XmlStreamReader::TokenType XmlStreamReader::Xml::readTag()
+{
+    if (std::strncmp(pos, "?", 1) == 0) {
+        ++pos;
+        value = readUntil("?>");
+        if (!value) {
+            return setError(PrematureEndOfDocumentError, u"unterminated processing instruction");
+        }
+
+        // a processing instruction in the content (e.g. of MusicXML exporters) is meant for another application
+        if (contentStarted) {
+            value = nullptr;
+            return next();
+        }
+
+        return TokenType::StartDocument;
+    }
+
+    contentStarted = true;
+
+    if (std::strncmp(pos, "!--", 3) == 0) {
+        pos += 3;
+        value = readUntil("-->");
+        return value ? TokenType::Comment : setError(PrematureEndOfDocumentError, u"unterminated comment");
+    }
+
+    if (std::strncmp(pos, "![CDATA[", 8) == 0) {
+        pos += 8;
+        value = readUntil("]]>");
+        return value ? TokenType::Characters : setError(PrematureEndOfDocumentError, u"unterminated CDATA section");
+    }
+
+    if (*pos == '!') {
+        ++pos;
+        value = readUntil(">");
+        return value ? TokenType::DTD : setError(PrematureEndOfDocumentError, u"unterminated declaration");
+    }
+
+    skipWhiteSpace();
+    if (*pos == '/') {
+        ++pos;
+        return readEndElement();
+    }
+
+    return readStartElement();
+}
+
+XmlStreamReader::TokenType XmlStreamReader::Xml::readStartElement()
+{
+    char* elementName = readName();
+    if (!elementName) {
+        return setError(NotWellFormedError, u"invalid element name");
+    }
+    // the names are terminated after the whole tag is read, the terminators overwrite the syntax
+    char* nameEnd = pos;
+
+    bool empty = false;
+    for (;;) {
+        skipWhiteSpace();
+        if (*pos == '>') {
+            ++pos;
+            break;
+        }
+        if (*pos == '/' && *(pos + 1) == '>') {
+            pos += 2;
+            empty = true;
+            break;
+        }
+
+        char* attrName = readName();
+        if (!attrName) {
+            return setError(NotWellFormedError, u"invalid attribute in element " + String::fromAscii(elementName, nameEnd - elementName));
+        }
+        char* attrNameEnd = pos;
+
+        skipWhiteSpace();
+        if (*pos != '=') {
+            return setError(NotWellFormedError, u"expected '=' after attribute name");
+        }
+        ++pos;
+        skipWhiteSpace();
+
+        char quote = *pos;
+        if (quote != '\"' && quote != '\'') {
+            return setError(NotWellFormedError, u"expected quoted attribute value");
+        }
+        ++pos;
+
+        char* valueEnd = std::strchr(pos, quote);
+        if (!valueEnd) {
+            return setError(PrematureEndOfDocumentError, u"unterminated attribute value");
+        }
+
+        char* attrValue = pos;
+        countLines(pos, valueEnd + 1);
+        pos = valueEnd + 1;
+        decode(attrValue, valueEnd, true);
+
+        attributes.push_back({ attrName, attrValue, attrNameEnd });
+    }
+
+    *nameEnd = 0;
+    for (size_t i = 0; i < attributes.size(); ++i) {
+        *attributes[i].nameEnd = 0;
+        for (size_t j = 0; j < i; ++j) {
+            if (std::strcmp(attributes[i].name, attributes[j].name) == 0) {
+                return setError(NotWellFormedError, u"duplicate attribute " + String::fromUtf8(attributes[i].name));
+            }
+        }
+    }
+
+    name = elementName;
+    openElements.push_back(elementName);
+    pendingEndElement = empty;
+    return TokenType::StartElement;
+}
+
+XmlStreamReader::TokenType XmlStreamReader::Xml::readEndElement()
+{
+    char* endName = readName();
+    if (!endName) {
+        return setError(NotWellFormedError, u"invalid end tag");
+    }
+    char* nameEnd = pos;
+
+    skipWhiteSpace();
+    if (*pos != '>') {
+        return setError(NotWellFormedError, u"expected '>' in end tag");
+    }
+    ++pos;
+    *nameEnd = 0;
+
+    if (openElements.empty() || std::strcmp(openElements.back(), endName) != 0) {
+        return setError(NotWellFormedError, u"mismatched end tag </" + String::fromUtf8(endName) + u">");
+    }
+
+    name = openElements.back();
+    openElements.pop_back();
+    return TokenType::EndElement;
+}
+
+const char* XmlStreamReader::Xml::attribute(const char* attrName) const
+{
+    for (const ParsedAttribute& a : attributes) {
+        if (std::strcmp(a.name, attrName) == 0) {
+            return a.value;
+        }
+    }
+    return nullptr;
+}
+
 XmlStreamReader::XmlStreamReader()
 {
     m_xml = new Xml();
@@ -46,22 +705,20 @@ XmlStreamReader::XmlStreamReader()
 XmlStreamReader::XmlStreamReader(IODevice* device)
 {
     m_xml = new Xml();
-    ByteArray data = device->readAll();
-    setData(data);
+    setData(device->readAll());
 }
 
-XmlStreamReader::XmlStreamReader(const ByteArray& data)
+XmlStreamReader::XmlStreamReader(ByteArray data)
 {
     m_xml = new Xml();
-    setData(data);
+    setData(std::move(data));
 }
 
 #ifndef NO_QT_SUPPORT
 XmlStreamReader::XmlStreamReader(const QByteArray& data)
 {
     m_xml = new Xml();
-    ByteArray ba = ByteArray::fromQByteArrayNoCopy(data);
-    setData(ba);
+    setData(ByteArray::fromQByteArrayNoCopy(data));
 }
 
 #endif
@@ -71,78 +728,108 @@ XmlStreamReader::~XmlStreamReader()
     delete m_xml;
 }
 
-void XmlStreamReader::setData(const ByteArray& data)
+void XmlStreamReader::setData(ByteArray data)
 {
-    m_xml->doc.Clear();
-    m_xml->err = m_xml->doc.Parse(reinterpret_cast<const char*>(data.constData()), data.size());
-    m_token = m_xml->err == XML_SUCCESS ? TokenType::NoToken : TokenType::Invalid;
-    m_xml->customErr.clear();
-
-    if (m_xml->err != XML_SUCCESS) {
-        LOGE() << errorString();
-    }
-}
+    m_xml->reset(std::move(data));
+    m_token = TokenType::NoToken;
+    m_entities.clear();
+
+    if (!m_xml->binary) {
+        // skip the byte order mark
+        m_xml->skipWhiteSpace();
+        if (std::strncmp(m_xml->pos, "\xEF\xBB\xBF", 3) == 0) {
+            m_xml->pos += 3;
+            m_xml->skipWhiteSpace();
+        }
 
-bool XmlStreamReader::readNextStartElement()
-{
-    while (readNext() != Invalid) {
-        if (isEndElement()) {
-            return false;
-        } else if (isStartElement()) {
-            return true;
+        if (!*m_xml->pos) {
+            m_token = m_xml->setError(PrematureEndOfDocumentError, u"empty document");
+            LOGE() << errorString();
+            return;
         }
     }
-    return false;
 }
 
-bool XmlStreamReader::atEnd() const
+bool XmlStreamReader::isBinary(const ByteArray& data)
 {
-    return m_token == TokenType::EndDocument || m_token == TokenType::Invalid;
+    return data.size() >= BINARY_MAGIC_SIZE && std::memcmp(data.constData(), BINARY_MAGIC, BINARY_MAGIC_SIZE) == 0;
 }
 
-static XmlStreamReader::TokenType resolveToken(XMLNode* n, bool isStartElement)
+ByteArray XmlStreamReader::toBinary(const ByteArray& xml)
 {
-    if (n->ToElement()) {
-        return isStartElement ? XmlStreamReader::TokenType::StartElement : XmlStreamReader::TokenType::EndElement;
-    } else if (n->ToText()) {
-        return XmlStreamReader::TokenType::Characters;
-    } else if (n->ToComment()) {
-        return XmlStreamReader::TokenType::Comment;
-    } else if (n->ToDeclaration()) {
-        return XmlStreamReader::TokenType::StartDocument;
-    } else if (n->ToDocument()) {
-        return XmlStreamReader::TokenType::EndDocument;
-    } else if (n->ToUnknown()) {
-        return XmlStreamReader::TokenType::DTD;
+    XmlStreamReader reader(xml);
+    Xml* x = reader.m_xml;
+    if (x->err != NoError) {
+        return ByteArray();
     }
-    return XmlStreamReader::TokenType::Unknown;
-}
 
-static std::pair<XMLNode*, XmlStreamReader::TokenType> resolveNode(XMLNode* currentNode, XmlStreamReader::TokenType currentToken)
-{
-    if (currentToken == XmlStreamReader::TokenType::StartElement) {
-        XMLNode* child = currentNode->FirstChild();
-        if (child) {
-            return { child, resolveToken(child, true) };
+    ByteArray out;
+    out.reserve(xml.size());
+    out.push_back(reinterpret_cast<const uint8_t*>(BINARY_MAGIC), BINARY_MAGIC_SIZE);
+
+    std::map<std::string, size_t> nameIndexes;
+    auto writeName = [&out, &nameIndexes](const char* name) {
+        auto it = nameIndexes.find(name);
+        if (it != nameIndexes.end()) {
+            writeVarInt(out, it->second);
+            return;
+        }
+        size_t index = nameIndexes.size();
+        nameIndexes.emplace(name, index);
+        writeVarInt(out, index);
+        writeString(out, name);
+    };
+
+    // all tokens, also the ends that readToken() drops, so that the binary form is read as the xml
+    for (;;) {
+        Xml::Token t = x->scan();
+        if (t.type == TokenType::Invalid) {
+            return ByteArray();
         }
 
-        XMLNode* sibling = currentNode->NextSibling();
-        if (!sibling || sibling->ToElement() || sibling->ToText()) {
-            return { currentNode, XmlStreamReader::TokenType::EndElement };
+        out.push_back(static_cast<uint8_t>(t.type));
+        writeVarInt(out, static_cast<uint64_t>(t.line));
+
+        switch (t.type) {
+        case TokenType::StartElement:
+            writeName(t.name);
+            writeVarInt(out, x->attributes.size());
+            for (const ParsedAttribute& a : x->attributes) {
+                writeName(a.name);
+                writeString(out, a.value);
+            }
+            break;
+        case TokenType::StartDocument:
+        case TokenType::Characters:
+        case TokenType::Comment:
+        case TokenType::DTD:
+            writeString(out, t.value);
+            break;
+        default:
+            break;
         }
-    }
 
-    XMLNode* sibling = currentNode->NextSibling();
-    if (sibling) {
-        return { sibling, resolveToken(sibling, true) };
+        if (t.type == TokenType::EndDocument) {
+            return out;
+        }
     }
+}
 
-    XMLNode* parent = currentNode->Parent();
-    if (parent) {
-        return { parent, resolveToken(parent, false) };
+bool XmlStreamReader::readNextStartElement()
+{
+    while (readNext() != Invalid) {
+        if (isEndElement()) {
+            return false;
+        } else if (isStartElement()) {
+            return true;
+        }
     }
+    return false;
+}
 
-    return { nullptr, XmlStreamReader::TokenType::EndDocument };
+bool XmlStreamReader::atEnd() const
+{
+    return m_token == TokenType::EndDocument || m_token == TokenType::Invalid;
 }
 
 XmlStreamReader::TokenType XmlStreamReader::readNext()
@@ -151,24 +838,18 @@ XmlStreamReader::TokenType XmlStreamReader::readNext()
         return m_token;
     }
 
-    if (m_xml->err != XML_SUCCESS || m_token == EndDocument) {
-        m_xml->node = nullptr;
+    if (m_token == EndDocument) {
         m_token = TokenType::Invalid;
         return m_token;
     }
 
-    if (!m_xml->node) {
-        m_xml->node = m_xml->doc.FirstChild();
-        m_token = m_xml->node->ToDeclaration() ? TokenType::StartDocument : resolveToken(m_xml->node, true);
+    m_token = m_xml->readToken().type;
+    if (m_token == TokenType::Invalid) {
+        LOGE() << errorString();
         return m_token;
     }
 
-    std::pair<XMLNode*, XmlStreamReader::TokenType> p = resolveNode(m_xml->node, m_token);
-
-    m_xml->node = p.first;
-    m_token = p.second;
-
-    if (m_token == XmlStreamReader::TokenType::DTD) {
+    if (m_token == TokenType::DTD) {
         tryParseEntity(m_xml);
     }
 
@@ -179,7 +860,7 @@ void XmlStreamReader::tryParseEntity(Xml* xml)
 {
     static const char* ENTITY = { "ENTITY" };
 
-    const char* str = xml->node->Value();
+    const char* str = xml->token.value;
     if (std::strncmp(str, ENTITY, 6) == 0) {
         String val = String::fromUtf8(str);
         StringList list = val.split(' ');
@@ -195,7 +876,7 @@ void XmlStreamReader::tryParseEntity(Xml* xml)
 
 String XmlStreamReader::nodeValue(Xml* xml) const
 {
-    String str = String::fromUtf8(xml->node->Value());
+    String str = String::fromUtf8(xml->token.value);
     if (!m_entities.empty()) {
         for (const auto& p : m_entities) {
             str.replace(p.first, p.second);
@@ -245,7 +926,7 @@ void XmlStreamReader::skipCurrentElement()
 
 AsciiStringView XmlStreamReader::name() const
 {
-    return (m_xml->node && m_xml->node->ToElement()) ? m_xml->node->Value() : AsciiStringView();
+    return (m_token == TokenType::StartElement || m_token == TokenType::EndElement) ? m_xml->token.name : AsciiStringView();
 }
 
 bool XmlStreamReader::hasAttribute(const char* name) const
@@ -253,12 +934,7 @@ bool XmlStreamReader::hasAttribute(const char* name) const
     if (m_token != TokenType::StartElement) {
         return false;
     }
-
-    XMLElement* e = m_xml->node->ToElement();
-    if (!e) {
-        return false;
-    }
-    return e->FindAttribute(name) != nullptr;
+    return m_xml->attribute(name) != nullptr;
 }
 
 String XmlStreamReader::attribute(const char* name) const
@@ -266,12 +942,7 @@ String XmlStreamReader::attribute(const char* name) const
     if (m_token != TokenType::StartElement) {
         return String();
     }
-
-    XMLElement* e = m_xml->node->ToElement();
-    if (!e) {
-        return String();
-    }
-    return String::fromUtf8(e->Attribute(name));
+    return String::fromUtf8(m_xml->attribute(name));
 }
 
 String XmlStreamReader::attribute(const char* name, const String& def) const
@@ -284,12 +955,7 @@ AsciiStringView XmlStreamReader::asciiAttribute(const char* name) const
     if (m_token != TokenType::StartElement) {
         return AsciiStringView();
     }
-
-    XMLElement* e = m_xml->node->ToElement();
-    if (!e) {
-        return AsciiStringView();
-    }
-    return e->Attribute(name);
+    return m_xml->attribute(name);
 }
 
 AsciiStringView XmlStreamReader::asciiAttribute(const char* name, const AsciiStringView& def) const
@@ -324,15 +990,11 @@ std::vector<XmlStreamReader::Attribute> XmlStreamReader::attributes() const
         return attrs;
     }
 
-    XMLElement* e = m_xml->node->ToElement();
-    if (!e) {
-        return attrs;
-    }
-
-    for (const XMLAttribute* xa = e->FirstAttribute(); xa; xa = xa->Next()) {
+    attrs.reserve(m_xml->attributes.size());
+    for (const ParsedAttribute& xa : m_xml->attributes) {
         Attribute a;
-        a.name = xa->Name();
-        a.value = String::fromUtf8(xa->Value());
+        a.name = xa.name;
+        a.value = String::fromUtf8(xa.value);
         attrs.push_back(std::move(a));
     }
     return attrs;
@@ -340,7 +1002,7 @@ std::vector<XmlStreamReader::Attribute> XmlStreamReader::attributes() const
 
 String XmlStreamReader::text() const
 {
-    if (m_xml->node && (m_xml->node->ToText() || m_xml->node->ToComment())) {
+    if (m_token == TokenType::Characters || m_token == TokenType::Comment) {
         return nodeValue(m_xml);
     }
     return String();
@@ -348,8 +1010,8 @@ String XmlStreamReader::text() const
 
 AsciiStringView XmlStreamReader::asciiText() const
 {
-    if (m_xml->node && (m_xml->node->ToText() || m_xml->node->ToComment())) {
-        return m_xml->node->Value();
+    if (m_token == TokenType::Characters || m_token == TokenType::Comment) {
+        return m_xml->token.value;
     }
     return AsciiStringView();
 }
@@ -364,6 +1026,7 @@ String XmlStreamReader::readText()
                 result = nodeValue(m_xml);
                 break;
             case EndElement:
+            case Invalid:
                 return result;
             case Comment:
                 break;
@@ -384,9 +1047,10 @@ AsciiStringView XmlStreamReader::readAsciiText()
         while (1) {
             switch (readNext()) {
             case Characters:
-                result = AsciiStringView(m_xml->node->Value());
+                result = AsciiStringView(m_xml->token.value);
                 break;
             case EndElement:
+            case Invalid:
                 return result;
             case Comment:
                 break;
@@ -414,12 +1078,12 @@ double XmlStreamReader::readDouble(bool* ok)
 
 int64_t XmlStreamReader::lineNumber() const
 {
-    return m_xml->doc.ErrorLineNum();
+    return m_xml->token.type == TokenType::NoToken ? m_xml->line : m_xml->token.line;
 }
 
 int64_t XmlStreamReader::columnNumber() const
 {
-    return 0;
+    return m_xml->token.column > 0 ? m_xml->token.column : 1;
 }
 
 XmlStreamReader::Error XmlStreamReader::error() const
@@ -427,13 +1091,7 @@ XmlStreamReader::Error XmlStreamReader::error() const
     if (!m_xml->customErr.isEmpty()) {
         return CustomError;
     }
-
-    XMLError err = m_xml->doc.ErrorID();
-    if (err == XML_SUCCESS) {
-        return NoError;
-    }
-
-    return NotWellFormedError;
+    return m_xml->err;
 }
 
 bool XmlStreamReader::isError() const
@@ -446,7 +1104,7 @@ String XmlStreamReader::errorString() const
     if (!m_xml->customErr.empty()) {
         return m_xml->customErr;
     }
-    return String::fromUtf8(m_xml->doc.ErrorStr());
+    return m_xml->errStr;
 }
 
 void XmlStreamReader::raiseError(const String& message)
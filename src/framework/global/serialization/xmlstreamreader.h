@@ -68,7 +68,7 @@ public:
 
     XmlStreamReader();
     explicit XmlStreamReader(io::IODevice* device);
-    explicit XmlStreamReader(const ByteArray& data);
+    explicit XmlStreamReader(ByteArray data);
 #ifndef NO_QT_SUPPORT
     explicit XmlStreamReader(const QByteArray& data);
 #endif
@@ -77,7 +77,14 @@ public:
     XmlStreamReader(const XmlStreamReader&) = delete;
     XmlStreamReader& operator=(const XmlStreamReader&) = delete;
 
-    void setData(const ByteArray& data);
+    //! NOTE The data can be XML or its binary form, see toBinary.
+    //! XML is decoded in place, so pass the data over (std::move) to avoid its copy
+    void setData(ByteArray data);
+
+    //! NOTE Compact binary form of an XML document: the tokens as this reader produces them, already decoded.
+    //! It is read without parsing. Returns an empty array if the document is not well formed
+    static ByteArray toBinary(const ByteArray& xml);
+    static bool isBinary(const ByteArray& data);
 
     bool readNextStartElement();
     bool atEnd() const;
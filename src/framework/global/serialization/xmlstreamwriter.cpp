@@ -21,22 +21,158 @@
  */
 #include "xmlstreamwriter.h"
 
-#include "containers.h"
-#include "textstream.h"
+#include <charconv>
+#include <clocale>
+#include <cstdio>
+#include <cstring>
 
 #include "log.h"
 
 using namespace mu;
 
+//! NOTE The document is written as UTF-8 straight into a byte buffer,
+//! the text is escaped and the numbers are formatted in place, without intermediate strings
+static constexpr size_t XMLSTREAMWRITER_BUFFERSIZE = 64 * 1024;
+
 struct XmlStreamWriter::Impl {
-    std::list<std::string> stack;
-    TextStream stream;
+    std::vector<std::string> stack;
+    io::IODevice* device = nullptr;
+    std::string buf;
+
+    inline void put(char c) { buf.push_back(c); }
+    inline void put(const char* s, size_t len) { buf.append(s, len); }
+    inline void put(const AsciiStringView& s) { buf.append(s.ascii(), s.size()); }
 
     void putLevel()
     {
-        size_t level = stack.size();
-        for (size_t i = 0; i < level * 2; ++i) {
-            stream << ' ';
+        buf.append(stack.size() * 2, ' ');
+    }
+
+    // escapes a single ascii char, see String::toXmlEscaped
+    inline void putEscaped(char c)
+    {
+        switch (c) {
+        case '<': put("&lt;", 4);
+            break;
+        case '>': put("&gt;", 4);
+            break;
+        case '&': put("&amp;", 5);
+            break;
+        case '\"': put("&quot;", 6);
+            break;
+        default:
+            // ignore invalid characters in xml 1.0
+            if (static_cast<unsigned char>(c) < 0x20 && c != 0x09 && c != 0x0A && c != 0x0D) {
+                break;
+            }
+            put(c);
+            break;
+        }
+    }
+
+    void putEscaped(const char* s, size_t len)
+    {
+        for (size_t i = 0; i < len; ++i) {
+            putEscaped(s[i]);
+        }
+    }
+
+    void putUtf8(char32_t c)
+    {
+        if (c < 0x80) {
+            put(static_cast<char>(c));
+        } else if (c < 0x800) {
+            put(static_cast<char>(0xC0 | (c >> 6)));
+            put(static_cast<char>(0x80 | (c & 0x3F)));
+        } else if (c < 0x10000) {
+            put(static_cast<char>(0xE0 | (c >> 12)));
+            put(static_cast<char>(0x80 | ((c >> 6) & 0x3F)));
+            put(static_cast<char>(0x80 | (c & 0x3F)));
+        } else {
+            put(static_cast<char>(0xF0 | (c >> 18)));
+            put(static_cast<char>(0x80 | ((c >> 12) & 0x3F)));
+            put(static_cast<char>(0x80 | ((c >> 6) & 0x3F)));
+            put(static_cast<char>(0x80 | (c & 0x3F)));
+        }
+    }
+
+    void putString(const String& s, bool escaped)
+    {
+        const size_t size = s.size();
+        for (size_t i = 0; i < size; ++i) {
+            char16_t c = s.at(i).unicode();
+            if (c < 0x80) {
+                if (escaped) {
+                    putEscaped(static_cast<char>(c));
+                } else {
+                    put(static_cast<char>(c));
+                }
+                continue;
+            }
+
+            char32_t code = c;
+            char16_t next = i + 1 < size ? s.at(i + 1).unicode() : 0;
+            if (c >= 0xD800 && c < 0xDC00 && next >= 0xDC00 && next < 0xE000) {
+                code = 0x10000 + ((static_cast<char32_t>(c) - 0xD800) << 10) + (next - 0xDC00);
+                ++i;
+            } else if (c >= 0xD800 && c < 0xE000) {
+                // unpaired surrogate
+                code = 0xFFFD;
+            }
+            putUtf8(code);
+        }
+    }
+
+    template<typename T>
+    void putInteger(T val)
+    {
+        char tmp[24];
+        std::to_chars_result res = std::to_chars(tmp, tmp + sizeof(tmp), val);
+        put(tmp, res.ptr - tmp);
+    }
+
+    void putDouble(double val)
+    {
+        //! NOTE Same as std::ostream with the default precision
+        char tmp[32];
+        int len = std::snprintf(tmp, sizeof(tmp), "%g", val);
+        if (len <= 0) {
+            return;
+        }
+
+        len = std::min(len, static_cast<int>(sizeof(tmp) - 1));
+
+        // the C locale may be changed by the application
+        const char* point = std::localeconv()->decimal_point;
+        if (point && point[0] != '.' && point[0] != '\0') {
+            const size_t pointLen = std::strlen(point);
+            const char* found = std::strstr(tmp, point);
+            if (found) {
+                const size_t pos = found - tmp;
+                put(tmp, pos);
+                put('.');
+                put(found + pointLen, len - pos - pointLen);
+                return;
+            }
+        }
+
+        put(tmp, len);
+    }
+
+    void flush()
+    {
+        if (device && device->isOpen() && !buf.empty()) {
+            device->write(reinterpret_cast<const uint8_t*>(buf.data()), buf.size());
+            buf.clear();
+        }
+    }
+
+    //! NOTE The data is passed to the device when the buffer is full and every time a top level element is closed,
+    //! so that the device has the complete document once it is written
+    void flushIfNeeded()
+    {
+        if (stack.empty() || buf.size() > XMLSTREAMWRITER_BUFFERSIZE) {
+            flush();
         }
     }
 };
@@ -49,7 +185,7 @@ XmlStreamWriter::XmlStreamWriter()
 XmlStreamWriter::XmlStreamWriter(io::IODevice* dev)
 {
     m_impl = new Impl();
-    m_impl->stream.setDevice(dev);
+    m_impl->device = dev;
 }
 
 XmlStreamWriter::~XmlStreamWriter()
@@ -60,22 +196,27 @@ XmlStreamWriter::~XmlStreamWriter()
 
 void XmlStreamWriter::setDevice(io::IODevice* dev)
 {
-    m_impl->stream.setDevice(dev);
+    m_impl->device = dev;
 }
 
 void XmlStreamWriter::flush()
 {
-    m_impl->stream.flush();
+    m_impl->flush();
 }
 
 void XmlStreamWriter::startDocument()
 {
-    m_impl->stream << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n";
+    static const char header[] = "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n";
+    m_impl->put(header, sizeof(header) - 1);
+    m_impl->flushIfNeeded();
 }
 
 void XmlStreamWriter::writeDoctype(const String& type)
 {
-    m_impl->stream << "<!DOCTYPE " << type << '>' << '\n';
+    m_impl->put("<!DOCTYPE ", 10);
+    m_impl->putString(type, false);
+    m_impl->put(">\n", 2);
+    m_impl->flushIfNeeded();
 }
 
 String XmlStreamWriter::escapeSymbol(char16_t c)
@@ -100,25 +241,29 @@ void XmlStreamWriter::writeValue(const Value& v)
     switch (v.index()) {
     case 0:
         break;
-    case 1: m_impl->stream << std::get<int>(v);
-        break;
-    case 2: m_impl->stream << std::get<unsigned int>(v);
-        break;
-    case 3: m_impl->stream << std::get<signed long int>(v);
+    case 1: m_impl->putInteger(std::get<int>(v));
         break;
-    case 4: m_impl->stream << std::get<unsigned long int>(v);
+    case 2: m_impl->putInteger(std::get<unsigned int>(v));
         break;
-    case 5: m_impl->stream << std::get<signed long long>(v);
+    case 3: m_impl->putInteger(std::get<signed long int>(v));
         break;
-    case 6: m_impl->stream << std::get<unsigned long long>(v);
+    case 4: m_impl->putInteger(std::get<unsigned long int>(v));
         break;
-    case 7: m_impl->stream << std::get<double>(v);
+    case 5: m_impl->putInteger(std::get<signed long long>(v));
         break;
-    case 8: m_impl->stream << escapeString(AsciiStringView(std::get<const char*>(v)));
+    case 6: m_impl->putInteger(std::get<unsigned long long>(v));
         break;
-    case 9: m_impl->stream << escapeString(std::get<AsciiStringView>(v));
+    case 7: m_impl->putDouble(std::get<double>(v));
         break;
-    case 10: m_impl->stream << escapeString(std::get<String>(v));
+    case 8: {
+        const char* str = std::get<const char*>(v);
+        m_impl->putEscaped(str, std::strlen(str));
+    } break;
+    case 9: {
+        const AsciiStringView& str = std::get<AsciiStringView>(v);
+        m_impl->putEscaped(str.ascii(), str.size());
+    } break;
+    case 10: m_impl->putString(std::get<String>(v), true);
         break;
     default:
         LOGI() << "index: " << v.index();
@@ -127,20 +272,29 @@ void XmlStreamWriter::writeValue(const Value& v)
     }
 }
 
+void XmlStreamWriter::writeAttributes(const Attributes& attrs)
+{
+    for (const Attribute& a : attrs) {
+        m_impl->put(' ');
+        m_impl->put(a.first);
+        m_impl->put("=\"", 2);
+        writeValue(a.second);
+        m_impl->put('\"');
+    }
+}
+
 void XmlStreamWriter::startElement(const AsciiStringView& name, const Attributes& attrs)
 {
     IF_ASSERT_FAILED(!name.contains(' ')) {
     }
 
     m_impl->putLevel();
-    m_impl->stream << '<' << name;
-    for (const Attribute& a : attrs) {
-        m_impl->stream << ' ' << a.first << '=' << '\"';
-        writeValue(a.second);
-        m_impl->stream << '\"';
-    }
-    m_impl->stream << '>' << '\n';
-    m_impl->stack.push_back(name.ascii());
+    m_impl->put('<');
+    m_impl->put(name);
+    writeAttributes(attrs);
+    m_impl->put(">\n", 2);
+    m_impl->stack.emplace_back(name.ascii(), name.size());
+    m_impl->flushIfNeeded();
 }
 
 void XmlStreamWriter::startElement(const String& name, const Attributes& attrs)
@@ -152,15 +306,27 @@ void XmlStreamWriter::startElement(const String& name, const Attributes& attrs)
 void XmlStreamWriter::startElementRaw(const String& name)
 {
     m_impl->putLevel();
-    m_impl->stream << '<' << name << '>' << '\n';
-    m_impl->stack.push_back(name.split(' ')[0].toStdString());
+    m_impl->put('<');
+    const size_t nameStart = m_impl->buf.size();
+    m_impl->putString(name, false);
+    const size_t nameEnd = std::min(m_impl->buf.find(' ', nameStart), m_impl->buf.size());
+    m_impl->stack.push_back(m_impl->buf.substr(nameStart, nameEnd - nameStart));
+    m_impl->put(">\n", 2);
+    m_impl->flushIfNeeded();
 }
 
 void XmlStreamWriter::endElement()
 {
+    IF_ASSERT_FAILED(!m_impl->stack.empty()) {
+        return;
+    }
+
     m_impl->putLevel();
-    m_impl->stream << "</" << mu::takeLast(m_impl->stack) << '>' << '\n';
-    flush();
+    m_impl->put("</", 2);
+    m_impl->buf.append(m_impl->stack.back());
+    m_impl->put(">\n", 2);
+    m_impl->stack.pop_back();
+    m_impl->flushIfNeeded();
 }
 
 // <element attr="value" />
@@ -170,13 +336,11 @@ void XmlStreamWriter::element(const AsciiStringView& name, const Attributes& att
     }
 
     m_impl->putLevel();
-    m_impl->stream << '<' << name;
-    for (const Attribute& a : attrs) {
-        m_impl->stream << ' ' << a.first << '=' << '\"';
-        writeValue(a.second);
-        m_impl->stream << '\"';
-    }
-    m_impl->stream << "/>\n";
+    m_impl->put('<');
+    m_impl->put(name);
+    writeAttributes(attrs);
+    m_impl->put("/>\n", 3);
+    m_impl->flushIfNeeded();
 }
 
 void XmlStreamWriter::element(const AsciiStringView& name, const Value& body)
@@ -185,9 +349,14 @@ void XmlStreamWriter::element(const AsciiStringView& name, const Value& body)
     }
 
     m_impl->putLevel();
-    m_impl->stream << '<' << name << '>';
+    m_impl->put('<');
+    m_impl->put(name);
+    m_impl->put('>');
     writeValue(body);
-    m_impl->stream << "</" << name << '>' << '\n';
+    m_impl->put("</", 2);
+    m_impl->put(name);
+    m_impl->put(">\n", 2);
+    m_impl->flushIfNeeded();
 }
 
 void XmlStreamWriter::element(const AsciiStringView& name, const Attributes& attrs, const Value& body)
@@ -196,45 +365,63 @@ void XmlStreamWriter::element(const AsciiStringView& name, const Attributes& att
     }
 
     m_impl->putLevel();
-    m_impl->stream << '<' << name;
-    for (const Attribute& a : attrs) {
-        m_impl->stream << ' ' << a.first << '=' << '\"';
-        writeValue(a.second);
-        m_impl->stream << '\"';
-    }
-    m_impl->stream << ">";
+    m_impl->put('<');
+    m_impl->put(name);
+    writeAttributes(attrs);
+    m_impl->put('>');
     writeValue(body);
-    m_impl->stream << "</" << name << '>' << '\n';
+    m_impl->put("</", 2);
+    m_impl->put(name);
+    m_impl->put(">\n", 2);
+    m_impl->flushIfNeeded();
 }
 
 void XmlStreamWriter::elementRaw(const String& nameWithAttributes, const Value& body)
 {
-    m_impl->putLevel();
     if (body.index() == 0) {
-        m_impl->stream << '<' << nameWithAttributes << "/>\n";
-    } else {
-        String ename(String(nameWithAttributes).split(' ')[0]);
-        m_impl->stream << '<' << nameWithAttributes << '>';
-        writeValue(body);
-        m_impl->stream << "</" << ename << '>' << '\n';
+        elementStringRaw(nameWithAttributes, String());
+        return;
     }
+
+    m_impl->putLevel();
+    m_impl->put('<');
+    const size_t nameStart = m_impl->buf.size();
+    m_impl->putString(nameWithAttributes, false);
+    const size_t nameEnd = std::min(m_impl->buf.find(' ', nameStart), m_impl->buf.size());
+    const std::string name = m_impl->buf.substr(nameStart, nameEnd - nameStart);
+    m_impl->put('>');
+    writeValue(body);
+    m_impl->put("</", 2);
+    m_impl->put(name.data(), name.size());
+    m_impl->put(">\n", 2);
+    m_impl->flushIfNeeded();
 }
 
 void XmlStreamWriter::elementStringRaw(const String& nameWithAttributes, const String& body)
 {
     m_impl->putLevel();
+    m_impl->put('<');
+    const size_t nameStart = m_impl->buf.size();
+    m_impl->putString(nameWithAttributes, false);
     if (body.isEmpty()) {
-        m_impl->stream << '<' << nameWithAttributes << "/>\n";
+        m_impl->put("/>\n", 3);
     } else {
-        String ename(String(nameWithAttributes).split(' ')[0]);
-        m_impl->stream << '<' << nameWithAttributes << '>';
-        m_impl->stream << body;
-        m_impl->stream << "</" << ename << '>' << '\n';
+        const size_t nameEnd = std::min(m_impl->buf.find(' ', nameStart), m_impl->buf.size());
+        const std::string name = m_impl->buf.substr(nameStart, nameEnd - nameStart);
+        m_impl->put('>');
+        m_impl->putString(body, false);
+        m_impl->put("</", 2);
+        m_impl->put(name.data(), name.size());
+        m_impl->put(">\n", 2);
     }
+    m_impl->flushIfNeeded();
 }
 
 void XmlStreamWriter::comment(const String& text)
 {
     m_impl->putLevel();
-    m_impl->stream << "<!-- " << text << " -->\n";
+    m_impl->put("<!-- ", 5);
+    m_impl->putString(text, false);
+    m_impl->put(" -->\n", 5);
+    m_impl->flushIfNeeded();
 }
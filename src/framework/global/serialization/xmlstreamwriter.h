@@ -22,7 +22,6 @@
 #ifndef MU_GLOBAL_XMLSTREAMWRITER_H
 #define MU_GLOBAL_XMLSTREAMWRITER_H
 
-#include <list>
 #include <variant>
 
 #include "types/string.h"
@@ -73,6 +72,7 @@ protected:
 private:
 
     void writeValue(const Value& v);
+    void writeAttributes(const Attributes& attrs);
 
     struct Impl;
     Impl* m_impl = nullptr;
@@ -38,7 +38,9 @@ ZipReader::ZipReader(const io::path_t& filePath)
     : m_filePath(filePath)
 {
     m_impl = new Impl();
-    m_impl->device = new File(filePath);
+    File* file = new File(filePath);
+    file->setMemoryMapped(true);
+    m_impl->device = file;
     m_impl->isSelfDevice = true;
     if (m_impl->device->open(IODevice::ReadOnly)) {
     }
@@ -105,3 +107,17 @@ ByteArray ZipReader::fileData(const std::string& fileName) const
 {
     return m_impl->zip->fileData(fileName);
 }
+
+ZipReader::RawFileData ZipReader::rawFileData(const std::string& fileName) const
+{
+    ZipContainer::RawFileData zraw = m_impl->zip->rawFileData(fileName);
+
+    RawFileData raw;
+    raw.filePath = zraw.filePath;
+    raw.crc = zraw.crc;
+    raw.size = static_cast<uint64_t>(zraw.size);
+    raw.compressionMethod = zraw.compressionMethod;
+    raw.data = zraw.data;
+
+    return raw;
+}
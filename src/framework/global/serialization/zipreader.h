@@ -43,6 +43,18 @@ public:
         bool isValid() const { return isDir || isFile || isSymLink; }
     };
 
+    //! NOTE A file as it's stored in the archive, see ZipWriter::addFile
+    struct RawFileData
+    {
+        std::string filePath;
+        uint32_t crc = 0;
+        uint64_t size = 0;
+        int compressionMethod = 0;
+        ByteArray data;
+
+        bool isValid() const { return !filePath.empty(); }
+    };
+
     explicit ZipReader(const io::path_t& filePath);
     explicit ZipReader(io::IODevice* device);
     ~ZipReader();
@@ -54,6 +66,7 @@ public:
     std::vector<FileInfo> fileInfoList() const;
     bool fileExists(const std::string& fileName) const;
     ByteArray fileData(const std::string& fileName) const;
+    RawFileData rawFileData(const std::string& fileName) const;
 
 private:
     struct Impl;
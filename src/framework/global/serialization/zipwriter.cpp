@@ -89,8 +89,31 @@ bool ZipWriter::hasError() const
     return m_impl->zip->status() != ZipContainer::NoError;
 }
 
+void ZipWriter::setCompressionLevel(int level)
+{
+    m_impl->zip->setCompressionLevel(level);
+}
+
+void ZipWriter::setParallelCompression(bool parallel)
+{
+    m_impl->zip->setParallelCompression(parallel);
+}
+
 void ZipWriter::addFile(const std::string& fileName, const ByteArray& data)
 {
     m_impl->zip->addFile(fileName, data);
     flush();
 }
+
+void ZipWriter::addFile(const std::string& fileName, const ByteArray& data, const ZipReader::RawFileData& previous)
+{
+    ZipContainer::RawFileData zraw;
+    zraw.filePath = previous.filePath;
+    zraw.crc = previous.crc;
+    zraw.size = static_cast<int64_t>(previous.size);
+    zraw.compressionMethod = previous.compressionMethod;
+    zraw.data = previous.data;
+
+    m_impl->zip->addFile(fileName, data, zraw);
+    flush();
+}
@@ -25,6 +25,8 @@
 #include "io/path.h"
 #include "io/iodevice.h"
 
+#include "zipreader.h"
+
 namespace mu {
 class ZipWriter
 {
@@ -37,8 +39,18 @@ public:
     void close();
     bool hasError() const;
 
+    // zlib compression level, from 0 (none) to 9 (best), -1 is the zlib default
+    void setCompressionLevel(int level);
+
+    //! NOTE The files are compressed on the worker pool, large ones in chunks,
+    //! and written in the order they were added on close
+    void setParallelCompression(bool parallel);
+
     void addFile(const std::string& fileName, const ByteArray& data);
 
+    //! NOTE If the previous file has the same content, its compressed data is written as is
+    void addFile(const std::string& fileName, const ByteArray& data, const ZipReader::RawFileData& previous);
+
 private:
 
     void flush();
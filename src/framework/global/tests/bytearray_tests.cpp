@@ -197,3 +197,28 @@ TEST_F(Global_Types_ByteArrayTests, Modification)
     EXPECT_EQ(ba10.size(), 0);
     EXPECT_TRUE(ba10.empty());
 }
+
+TEST_F(Global_Types_ByteArrayTests, RawDataOwner)
+{
+    //! GIVEN Data owned by a shared pointer
+    auto owner = std::make_shared<std::vector<uint8_t> >(std::vector<uint8_t> { 1, 2, 3, 4, 5, 6 });
+    std::weak_ptr<std::vector<uint8_t> > weakOwner = owner;
+
+    //! DO Make ByteArray without copying the data
+    ByteArray ba = ByteArray::fromRawData(owner->data(), owner->size(), owner);
+    owner.reset();
+
+    //! CHECK The data is kept by the ByteArray
+    EXPECT_FALSE(weakOwner.expired());
+    EXPECT_EQ(ba.size(), 6);
+    EXPECT_EQ(ba.at(5), 6);
+    EXPECT_FALSE(weakOwner.expired());
+
+    //! DO Modify the data
+    ba[0] = 42;
+
+    //! CHECK The data is copied and the owner is released
+    EXPECT_TRUE(weakOwner.expired());
+    EXPECT_EQ(ba[0], 42);
+    EXPECT_EQ(ba[5], 6);
+}
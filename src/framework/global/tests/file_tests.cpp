@@ -207,3 +207,31 @@ TEST_F(Global_IO_FileTests, FileTests_Exists_Append)
         EXPECT_EQ(refba, data);
     }
 }
+
+TEST_F(Global_IO_FileTests, FileTests_MemoryMapped)
+{
+    path_t filePath("FileTests_MemoryMapped.txt");
+    createFile(filePath, "Hello World!");
+
+    ByteArray data;
+    {
+        //! GIVE File to be mapped
+        File f(filePath);
+        f.setMemoryMapped(true);
+
+        //! DO Open file
+        EXPECT_TRUE(f.open(IODevice::ReadOnly));
+
+        //! CHECK
+        EXPECT_EQ(f.size(), 12);
+
+        //! DO Read data
+        f.seek(6);
+        data = f.readAll();
+    }
+
+    //! CHECK The read data is a copy, it outlives the file
+    std::string ref = "World!";
+    ByteArray refba(reinterpret_cast<const uint8_t*>(ref.c_str()), ref.size());
+    EXPECT_EQ(refba, data);
+}
@@ -0,0 +1,288 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2023 MuseScore BVBA and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include <gtest/gtest.h>
+
+#include "serialization/xmlstreamreader.h"
+
+using namespace mu;
+
+class Global_Ser_XmlStreamReader : public ::testing::Test
+{
+public:
+};
+
+static ByteArray xml(const char* str)
+{
+    return ByteArray(str);
+}
+
+TEST_F(Global_Ser_XmlStreamReader, Tokens)
+{
+    XmlStreamReader reader(xml("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+                               "<museScore version=\"4.20\">\n"
+                               "  <!-- comment -->\n"
+                               "  <Division>480</Division>\n"
+                               "  <empty/>\n"
+                               "</museScore>\n"));
+
+    EXPECT_EQ(reader.readNext(), XmlStreamReader::StartDocument);
+
+    EXPECT_EQ(reader.readNext(), XmlStreamReader::StartElement);
+    EXPECT_EQ(reader.name(), "museScore");
+    EXPECT_EQ(reader.attribute("version"), u"4.20");
+    EXPECT_DOUBLE_EQ(reader.doubleAttribute("version"), 4.2);
+    EXPECT_FALSE(reader.hasAttribute("id"));
+
+    EXPECT_EQ(reader.readNext(), XmlStreamReader::Comment);
+    EXPECT_EQ(reader.text(), u" comment ");
+
+    EXPECT_TRUE(reader.readNextStartElement());
+    EXPECT_EQ(reader.name(), "Division");
+    EXPECT_EQ(reader.readInt(), 480);
+    EXPECT_TRUE(reader.isEndElement());
+    EXPECT_EQ(reader.name(), "Division");
+
+    EXPECT_TRUE(reader.readNextStartElement());
+    EXPECT_EQ(reader.name(), "empty");
+    EXPECT_EQ(reader.readNext(), XmlStreamReader::EndElement);
+    EXPECT_EQ(reader.name(), "empty");
+
+    EXPECT_EQ(reader.readNext(), XmlStreamReader::EndElement);
+    EXPECT_EQ(reader.name(), "museScore");
+    EXPECT_EQ(reader.readNext(), XmlStreamReader::EndDocument);
+    EXPECT_TRUE(reader.atEnd());
+    EXPECT_EQ(reader.readNext(), XmlStreamReader::Invalid);
+    EXPECT_FALSE(reader.isError());
+}
+
+TEST_F(Global_Ser_XmlStreamReader, TextAndEntities)
+{
+    XmlStreamReader reader(xml("<text a='1 &lt; 2' b=\"&#x266D;\"> x &amp; <b>y</b> &#9837;z\r\n</text>"));
+
+    EXPECT_TRUE(reader.readNextStartElement());
+    EXPECT_EQ(reader.attribute("a"), u"1 < 2");
+    EXPECT_EQ(reader.attribute("b"), u"♭");
+
+    std::vector<XmlStreamReader::Attribute> attrs = reader.attributes();
+    ASSERT_EQ(attrs.size(), 2u);
+    EXPECT_EQ(attrs.at(0).name, "a");
+    EXPECT_EQ(attrs.at(1).name, "b");
+
+    // leading and trailing white space of text is kept
+    EXPECT_EQ(reader.readNext(), XmlStreamReader::Characters);
+    EXPECT_EQ(reader.text(), u" x & ");
+    EXPECT_TRUE(reader.readNextStartElement());
+    EXPECT_EQ(reader.readText(), u"y");
+    EXPECT_EQ(reader.readNext(), XmlStreamReader::Characters);
+    EXPECT_EQ(reader.text(), u" ♭z\n");
+    EXPECT_EQ(reader.readNext(), XmlStreamReader::EndElement);
+    EXPECT_FALSE(reader.isError());
+}
+
+TEST_F(Global_Ser_XmlStreamReader, CDataAndCustomEntities)
+{
+    XmlStreamReader reader(xml("<!ENTITY nbsp \"&#160;\">\n"
+                               "<a><![CDATA[<b>&amp;</b>]]></a>\n"
+                               "<c>x&nbsp;y</c>"));
+
+    EXPECT_EQ(reader.readNext(), XmlStreamReader::DTD);
+
+    EXPECT_TRUE(reader.readNextStartElement());
+    EXPECT_EQ(reader.readText(), u"<b>&amp;</b>");
+
+    EXPECT_TRUE(reader.readNextStartElement());
+    EXPECT_EQ(reader.readText(), u"x&#160;y");
+}
+
+TEST_F(Global_Ser_XmlStreamReader, Errors)
+{
+    {
+        XmlStreamReader reader(xml("<a>\n<b>\n</a>"));
+        EXPECT_TRUE(reader.readNextStartElement());
+        EXPECT_TRUE(reader.readNextStartElement());
+        EXPECT_EQ(reader.readNext(), XmlStreamReader::Invalid);
+        EXPECT_EQ(reader.error(), XmlStreamReader::NotWellFormedError);
+        EXPECT_EQ(reader.lineNumber(), 3);
+    }
+
+    {
+        XmlStreamReader reader(xml("<a><b/>"));
+        reader.skipCurrentElement();
+        EXPECT_EQ(reader.tokenType(), XmlStreamReader::Invalid);
+        EXPECT_EQ(reader.error(), XmlStreamReader::PrematureEndOfDocumentError);
+    }
+
+    {
+        XmlStreamReader reader(xml("  "));
+        EXPECT_EQ(reader.readNext(), XmlStreamReader::Invalid);
+        EXPECT_TRUE(reader.isError());
+    }
+
+    {
+        XmlStreamReader reader(xml("<a b=c/>"));
+        EXPECT_FALSE(reader.readNextStartElement());
+        EXPECT_EQ(reader.error(), XmlStreamReader::NotWellFormedError);
+    }
+}
+
+TEST_F(Global_Ser_XmlStreamReader, Binary)
+{
+    //! GIVEN Some xml
+    ByteArray data = xml("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+                         "<museScore version=\"4.20\">\n"
+                         "  <Part id=\"1\"><name>Flute &amp; Piccolo</name></Part>\n"
+                         "  <Part id=\"2\"><name>Oboe</name></Part>\n"
+                         "</museScore>\n");
+    EXPECT_FALSE(XmlStreamReader::isBinary(data));
+
+    //! DO Convert it to the binary form
+    ByteArray binary = XmlStreamReader::toBinary(data);
+    EXPECT_TRUE(XmlStreamReader::isBinary(binary));
+
+    //! CHECK The binary form is read as the xml
+    XmlStreamReader reader(data);
+    XmlStreamReader binaryReader(binary);
+    while (!reader.atEnd()) {
+        XmlStreamReader::TokenType type = reader.readNext();
+        EXPECT_EQ(binaryReader.readNext(), type);
+        EXPECT_EQ(binaryReader.lineNumber(), reader.lineNumber());
+        if (type == XmlStreamReader::StartElement || type == XmlStreamReader::EndElement) {
+            EXPECT_EQ(binaryReader.name(), reader.name());
+            EXPECT_EQ(binaryReader.attribute("id"), reader.attribute("id"));
+        } else if (type == XmlStreamReader::Characters) {
+            EXPECT_EQ(binaryReader.text(), reader.text());
+        }
+    }
+    EXPECT_TRUE(binaryReader.atEnd());
+    EXPECT_FALSE(binaryReader.isError());
+
+    //! CHECK Invalid xml has no binary form, truncated binary data is an error
+    EXPECT_TRUE(XmlStreamReader::toBinary(xml("<a><b></a>")).empty());
+
+    XmlStreamReader truncated(ByteArray(binary.constData(), binary.size() - 8));
+    while (truncated.readNext() != XmlStreamReader::Invalid) {
+    }
+    EXPECT_TRUE(truncated.isError());
+}
+
+TEST_F(Global_Ser_XmlStreamReader, MalformedReportedWhereItFails)
+{
+    //! GIVEN Xml that is malformed only at its end
+    XmlStreamReader reader(xml("<museScore>\n<Score>\n<Division>480</Division>\n</museScore>"));
+
+    //! CHECK It is read up to there, like by QXmlStreamReader
+    EXPECT_FALSE(reader.isError());
+    EXPECT_TRUE(reader.readNextStartElement());
+    EXPECT_EQ(reader.name(), "museScore");
+    EXPECT_TRUE(reader.readNextStartElement());
+    EXPECT_EQ(reader.name(), "Score");
+    EXPECT_TRUE(reader.readNextStartElement());
+    EXPECT_EQ(reader.readInt(), 480);
+    EXPECT_FALSE(reader.isError());
+
+    //! CHECK The error is reported at the mismatched end tag
+    EXPECT_EQ(reader.readNext(), XmlStreamReader::Invalid);
+    EXPECT_EQ(reader.error(), XmlStreamReader::NotWellFormedError);
+    EXPECT_EQ(reader.lineNumber(), 4);
+    EXPECT_EQ(reader.readNext(), XmlStreamReader::Invalid);
+}
+
+TEST_F(Global_Ser_XmlStreamReader, ReadsPassedDataInPlace)
+{
+    //! GIVEN Xml passed over to the reader
+    ByteArray data = xml("<a><b>text</b></a>");
+    const char* begin = data.constChar();
+    const char* end = begin + data.size();
+    XmlStreamReader reader(std::move(data));
+
+    //! CHECK The names and values are read from it, not from a copy
+    EXPECT_TRUE(reader.readNextStartElement());
+    EXPECT_TRUE(reader.readNextStartElement());
+    EXPECT_GE(reader.name().ascii(), begin);
+    EXPECT_LT(reader.name().ascii(), end);
+
+    AsciiStringView text = reader.readAsciiText();
+    EXPECT_EQ(text, "text");
+    EXPECT_GE(text.ascii(), begin);
+    EXPECT_LT(text.ascii(), end);
+}
+
+TEST_F(Global_Ser_XmlStreamReader, EmptyElementFollowedByComment)
+{
+    //! GIVEN Elements without child nodes followed by a comment, as in instruments.xml
+    ByteArray data = xml("<p><a/><!--c--><b></b><!--d--><c/>x<!--e--></p>");
+
+    //! CHECK Like in the tinyxml2 based reader, an element followed by a comment has no end
+    auto check = [](XmlStreamReader& reader) {
+        EXPECT_TRUE(reader.readNextStartElement());
+        EXPECT_EQ(reader.name(), "p");
+        EXPECT_TRUE(reader.readNextStartElement());
+        EXPECT_EQ(reader.name(), "a");
+        EXPECT_EQ(reader.readNext(), XmlStreamReader::Comment);
+        EXPECT_EQ(reader.readNext(), XmlStreamReader::StartElement);
+        EXPECT_EQ(reader.name(), "b");
+        EXPECT_EQ(reader.readNext(), XmlStreamReader::Comment);
+
+        // an element followed by text has its end
+        EXPECT_EQ(reader.readNext(), XmlStreamReader::StartElement);
+        EXPECT_EQ(reader.name(), "c");
+        EXPECT_EQ(reader.readNext(), XmlStreamReader::EndElement);
+        EXPECT_EQ(reader.name(), "c");
+        EXPECT_EQ(reader.readNext(), XmlStreamReader::Characters);
+        EXPECT_EQ(reader.readNext(), XmlStreamReader::Comment);
+
+        EXPECT_EQ(reader.readNext(), XmlStreamReader::EndElement);
+        EXPECT_EQ(reader.name(), "p");
+        EXPECT_EQ(reader.readNext(), XmlStreamReader::EndDocument);
+        EXPECT_FALSE(reader.isError());
+    };
+
+    XmlStreamReader reader(data);
+    check(reader);
+
+    //! CHECK The same from the binary form
+    XmlStreamReader binaryReader(XmlStreamReader::toBinary(data));
+    check(binaryReader);
+}
+
+TEST_F(Global_Ser_XmlStreamReader, ProcessingInstructionInContent)
+{
+    //! GIVEN Processing instructions after the root element started, as written by some MusicXML exporters
+    XmlStreamReader reader(xml("<?xml version=\"1.0\"?>\n"
+                               "<score-partwise><?dolet x?>\n"
+                               "<part><?pi?></part>\n"
+                               "</score-partwise>\n"
+                               "<?pi end?>\n"));
+
+    //! CHECK They are skipped
+    EXPECT_EQ(reader.readNext(), XmlStreamReader::StartDocument);
+    EXPECT_TRUE(reader.readNextStartElement());
+    EXPECT_EQ(reader.name(), "score-partwise");
+    EXPECT_TRUE(reader.readNextStartElement());
+    EXPECT_EQ(reader.name(), "part");
+    EXPECT_EQ(reader.readNext(), XmlStreamReader::EndElement);
+    EXPECT_EQ(reader.name(), "part");
+    EXPECT_EQ(reader.readNext(), XmlStreamReader::EndElement);
+    EXPECT_EQ(reader.name(), "score-partwise");
+    EXPECT_EQ(reader.readNext(), XmlStreamReader::EndDocument);
+    EXPECT_FALSE(reader.isError());
+}
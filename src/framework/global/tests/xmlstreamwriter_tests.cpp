@@ -0,0 +1,80 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2023 MuseScore BVBA and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include <gtest/gtest.h>
+
+#include "io/buffer.h"
+#include "serialization/xmlstreamwriter.h"
+
+using namespace mu;
+using namespace mu::io;
+
+class Global_Ser_XmlStreamWriter : public ::testing::Test
+{
+public:
+};
+
+static std::string toStdString(const ByteArray& data)
+{
+    return std::string(reinterpret_cast<const char*>(data.constData()), data.size());
+}
+
+TEST_F(Global_Ser_XmlStreamWriter, Elements)
+{
+    Buffer buf;
+    buf.open(IODevice::WriteOnly);
+
+    XmlStreamWriter writer(&buf);
+    writer.startDocument();
+    writer.startElement("museScore", { { "version", "4.20" } });
+    writer.comment(u"comment");
+    writer.element("Division", 480);
+    writer.element("Spatium", 1.76389);
+    writer.element("empty", { { "id", 2u } });
+    writer.startElement(String(u"Staff"), { { "id", 1 } });
+    writer.element("name", { { "type", AsciiStringView("a") } }, String(u"stdNormal"));
+    writer.endElement();
+    writer.endElement();
+
+    EXPECT_EQ(toStdString(buf.data()),
+              "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+              "<museScore version=\"4.20\">\n"
+              "  <!-- comment -->\n"
+              "  <Division>480</Division>\n"
+              "  <Spatium>1.76389</Spatium>\n"
+              "  <empty id=\"2\"/>\n"
+              "  <Staff id=\"1\">\n"
+              "    <name type=\"a\">stdNormal</name>\n"
+              "    </Staff>\n"
+              "  </museScore>\n");
+}
+
+TEST_F(Global_Ser_XmlStreamWriter, EscapedUtf8)
+{
+    Buffer buf;
+    buf.open(IODevice::WriteOnly);
+
+    XmlStreamWriter writer(&buf);
+    writer.element("text", { { "attr", "\"a\" & b" } }, String(u"<é \U0001D11E>"));
+
+    EXPECT_EQ(toStdString(buf.data()),
+              "<text attr=\"&quot;a&quot; &amp; b\">&lt;\xC3\xA9 \xF0\x9D\x84\x9E&gt;</text>\n");
+}
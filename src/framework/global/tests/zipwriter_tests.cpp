@@ -0,0 +1,162 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2023 MuseScore BVBA and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+#include <gtest/gtest.h>
+
+#include <string>
+#include <zlib.h>
+
+#include "io/buffer.h"
+#include "serialization/zipreader.h"
+#include "serialization/zipwriter.h"
+
+using namespace mu;
+using namespace mu::io;
+
+class Global_Ser_ZipWriterTests : public ::testing::Test
+{
+public:
+};
+
+static ByteArray makeContent(const std::string& line, size_t count)
+{
+    std::string content;
+    for (size_t i = 0; i < count; ++i) {
+        content += line + std::to_string(i) + "\n";
+    }
+
+    return ByteArray(content.c_str(), content.size());
+}
+
+static ByteArray inflateRaw(const ByteArray& data, size_t size)
+{
+    ByteArray result;
+    result.resize(size);
+
+    z_stream stream = {};
+    if (inflateInit2(&stream, -MAX_WBITS) != Z_OK) {
+        return ByteArray();
+    }
+
+    stream.next_in = const_cast<Bytef*>(data.constData());
+    stream.avail_in = static_cast<uInt>(data.size());
+    stream.next_out = result.data();
+    stream.avail_out = static_cast<uInt>(result.size());
+
+    int err = inflate(&stream, Z_FINISH);
+    const bool ok = err == Z_STREAM_END && stream.total_out == size && stream.avail_in == 0;
+    inflateEnd(&stream);
+
+    return ok ? result : ByteArray();
+}
+
+TEST_F(Global_Ser_ZipWriterTests, Zip_ReusePrevious)
+{
+    //! GIVEN A zip with two files
+    const ByteArray sameContent = makeContent("<Measure>unchanged</Measure>", 100);
+    const ByteArray oldContent = makeContent("<Measure>changed</Measure>", 100);
+
+    ByteArray previousZip;
+    {
+        Buffer buf(&previousZip);
+        ZipWriter writer(&buf);
+        writer.addFile("same.xml", sameContent);
+        writer.addFile("changed.xml", oldContent);
+    }
+
+    //! GIVEN New content of the second file, with the same size and CRC32:
+    //! xoring the CRC32 polynomial (0x1DB710641 in reflected bit order) into a message keeps its CRC32
+    ByteArray newContent = oldContent;
+    const uint8_t polynomial[] = { 0x41, 0x06, 0x71, 0xDB, 0x01 };
+    for (size_t i = 0; i < sizeof(polynomial); ++i) {
+        newContent.data()[10 + i] ^= polynomial[i];
+    }
+    ASSERT_NE(newContent, oldContent);
+
+    //! DO Write the files again, with the previous ones
+    ByteArray newZip;
+    {
+        Buffer previousBuf(&previousZip);
+        ZipReader previousReader(&previousBuf);
+
+        ZipReader::RawFileData previousSame = previousReader.rawFileData("same.xml");
+        ZipReader::RawFileData previousChanged = previousReader.rawFileData("changed.xml");
+        ASSERT_TRUE(previousSame.isValid());
+        ASSERT_TRUE(previousChanged.isValid());
+
+        Buffer buf(&newZip);
+        ZipWriter writer(&buf);
+        writer.addFile("same.xml", sameContent, previousSame);
+        writer.addFile("changed.xml", newContent, previousChanged);
+    }
+
+    //! CHECK The unchanged file is the previous one, the changed one is written anew
+    Buffer previousBuf(&previousZip);
+    ZipReader previousReader(&previousBuf);
+
+    Buffer newBuf(&newZip);
+    ZipReader newReader(&newBuf);
+
+    EXPECT_EQ(newReader.rawFileData("same.xml").data, previousReader.rawFileData("same.xml").data);
+    EXPECT_EQ(newReader.rawFileData("changed.xml").crc, previousReader.rawFileData("changed.xml").crc);
+
+    EXPECT_EQ(newReader.fileData("same.xml"), sameContent);
+    EXPECT_EQ(newReader.fileData("changed.xml"), newContent);
+}
+
+TEST_F(Global_Ser_ZipWriterTests, Zip_ParallelCompression)
+{
+    //! GIVEN Files compressed in one chunk, in several, and in an exact number of chunks (1 MB each)
+    const ByteArray small = makeContent("<Note><pitch>60</pitch></Note>", 1000);
+    const ByteArray large = makeContent("<Chord><durationType>quarter</durationType></Chord>", 100000);
+    ByteArray exact = large;
+    exact.resize(2 * 1024 * 1024);
+    ASSERT_GT(large.size(), exact.size());
+
+    for (int level : { -1, 1, 9 }) {
+        //! DO Compress them on the worker pool
+        ByteArray zip;
+        {
+            Buffer buf(&zip);
+            ZipWriter writer(&buf);
+            writer.setCompressionLevel(level);
+            writer.setParallelCompression(true);
+            writer.addFile("small.xml", small);
+            writer.addFile("large.xml", large);
+            writer.addFile("exact.xml", exact);
+            writer.addFile("empty.xml", ByteArray());
+        }
+
+        //! CHECK The joined chunks are one deflate stream of the same bytes
+        Buffer buf(&zip);
+        ZipReader reader(&buf);
+        for (const auto& file : { std::make_pair("small.xml", small), std::make_pair("large.xml", large),
+                                  std::make_pair("exact.xml", exact), std::make_pair("empty.xml", ByteArray()) }) {
+            ZipReader::RawFileData raw = reader.rawFileData(file.first);
+            ASSERT_TRUE(raw.isValid());
+            EXPECT_EQ(raw.size, file.second.size());
+            if (!file.second.empty()) {
+                EXPECT_EQ(inflateRaw(raw.data, file.second.size()), file.second) << file.first << ", level " << level;
+            }
+            EXPECT_EQ(reader.fileData(file.first), file.second) << file.first << ", level " << level;
+        }
+    }
+}
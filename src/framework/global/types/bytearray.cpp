@@ -70,6 +70,13 @@ ByteArray ByteArray::fromRawData(const char* data, size_t size)
     return fromRawData(reinterpret_cast<const uint8_t*>(data), size);
 }
 
+ByteArray ByteArray::fromRawData(const uint8_t* data, size_t size, std::shared_ptr<const void> owner)
+{
+    ByteArray ba = fromRawData(data, size);
+    ba.m_raw.owner = std::move(owner);
+    return ba;
+}
+
 uint8_t* ByteArray::data()
 {
     detach();
@@ -110,6 +117,7 @@ void ByteArray::detach()
         m_data->operator [](m_raw.size) = 0;
         std::memcpy(m_data->data(), m_raw.data, m_raw.size);
         m_raw.data = nullptr;
+        m_raw.owner = nullptr;
         return;
     }
 
@@ -22,6 +22,8 @@
 #ifndef MU_NOTATION_IMASTERNOTATION_H
 #define MU_NOTATION_IMASTERNOTATION_H
 
+#include <map>
+
 #include "types/retval.h"
 
 #include "inotation.h"
@@ -50,6 +52,10 @@ public:
     virtual async::Notification excerptsChanged() const = 0;
     virtual const ExcerptNotationList& potentialExcerpts() const = 0;
 
+    //! NOTE The view settings of the excerpts that are not read yet, by excerpt name.
+    //! They are applied when the excerpts are read, see MasterScore::hasDeferredExcerpts
+    virtual void setDeferredExcerptsViewSettings(const std::map<String, ByteArray>& viewSettings) = 0;
+
     virtual void initExcerpts(const ExcerptNotationList& excerpts) = 0;
     virtual void setExcerpts(const ExcerptNotationList& excerpts) = 0;
     virtual void resetExcerpt(IExcerptNotationPtr excerpt) = 0;
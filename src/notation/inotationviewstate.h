@@ -42,6 +42,7 @@ public:
     virtual ~INotationViewState() = default;
 
     virtual Ret read(const engraving::MscReader& reader, const io::path_t& pathPrefix = "") = 0;
+    virtual Ret readJson(const ByteArray& json) = 0;
     virtual Ret write(engraving::MscWriter& writer, const io::path_t& pathPrefix = "") = 0;
 
     virtual bool isMatrixInited() const = 0;
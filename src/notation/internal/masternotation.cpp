@@ -129,6 +129,8 @@ void MasterNotation::setMasterScore(mu::engraving::MasterScore* score)
 
     m_notationPlayback->init(m_undoStack);
     initExcerptNotations(masterScore()->excerpts());
+
+    m_hasDeferredExcerpts = score->hasDeferredExcerpts();
 }
 
 mu::engraving::MasterScore* MasterNotation::masterScore() const
@@ -617,6 +619,8 @@ void MasterNotation::doSetExcerpts(const ExcerptNotationList& excerpts)
 
 void MasterNotation::updateExcerpts()
 {
+    initDeferredExcerpts();
+
     if (!masterScore()->excerptsChanged()) {
         return;
     }
@@ -724,6 +728,8 @@ IExcerptNotationPtr MasterNotation::createEmptyExcerpt(const QString& name) cons
 
 const ExcerptNotationList& MasterNotation::excerpts() const
 {
+    initDeferredExcerpts();
+
     return m_excerpts;
 }
 
@@ -754,11 +760,17 @@ INotationPlaybackPtr MasterNotation::playback() const
 
 const ExcerptNotationList& MasterNotation::potentialExcerpts() const
 {
+    initDeferredExcerpts();
     updatePotentialExcerpts();
 
     return m_potentialExcerpts;
 }
 
+void MasterNotation::setDeferredExcerptsViewSettings(const std::map<String, ByteArray>& viewSettings)
+{
+    m_deferredExcerptsViewSettings = viewSettings;
+}
+
 void MasterNotation::initExcerptNotations(const std::vector<mu::engraving::Excerpt*>& excerpts)
 {
     TRACEFUNC;
@@ -779,6 +791,32 @@ void MasterNotation::initExcerptNotations(const std::vector<mu::engraving::Excer
     doSetExcerpts(notationExcerpts);
 }
 
+//! NOTE The excerpts of a loaded score may be deferred (see MscLoader),
+//! they are read and get their notations on the first access
+void MasterNotation::initDeferredExcerpts() const
+{
+    if (!m_hasDeferredExcerpts) {
+        return;
+    }
+
+    TRACEFUNC;
+
+    m_hasDeferredExcerpts = false;
+
+    MasterNotation* self = const_cast<MasterNotation*>(this);
+    self->masterScore()->loadDeferredExcerpts();
+    self->initExcerptNotations(masterScore()->excerpts());
+
+    for (const IExcerptNotationPtr& excerptNotation : m_excerpts) {
+        auto it = m_deferredExcerptsViewSettings.find(get_impl(excerptNotation)->excerpt()->name());
+        if (it != m_deferredExcerptsViewSettings.end()) {
+            excerptNotation->notation()->viewState()->readJson(it->second);
+        }
+    }
+
+    self->m_deferredExcerptsViewSettings.clear();
+}
+
 void MasterNotation::addExcerptsToMasterScore(const std::vector<mu::engraving::Excerpt*>& excerpts)
 {
     TRACEFUNC;
@@ -59,6 +59,8 @@ public:
     async::Notification excerptsChanged() const override;
     const ExcerptNotationList& potentialExcerpts() const override;
 
+    void setDeferredExcerptsViewSettings(const std::map<String, ByteArray>& viewSettings) override;
+
     void initExcerpts(const ExcerptNotationList& excerpts) override;
     void setExcerpts(const ExcerptNotationList& excerpts) override;
     void resetExcerpt(IExcerptNotationPtr excerptNotation) override;
@@ -78,6 +80,7 @@ private:
     explicit MasterNotation();
 
     void initExcerptNotations(const std::vector<engraving::Excerpt*>& excerpts);
+    void initDeferredExcerpts() const;
     void addExcerptsToMasterScore(const std::vector<engraving::Excerpt*>& excerpts);
     void doSetExcerpts(const ExcerptNotationList& excerpts);
     void updateExcerpts();
@@ -94,6 +97,8 @@ private:
 
     ExcerptNotationList m_excerpts;
     async::Notification m_excerptsChanged;
+    mutable bool m_hasDeferredExcerpts = false;
+    std::map<String, ByteArray> m_deferredExcerptsViewSettings;
     INotationPlaybackPtr m_notationPlayback = nullptr;
     async::Notification m_hasPartsChanged;
 
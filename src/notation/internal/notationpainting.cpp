@@ -21,9 +21,13 @@
  */
 #include "notationpainting.h"
 
+#include <algorithm>
+
 #include <QScreen>
 
+#include "engraving/dom/page.h"
 #include "engraving/dom/score.h"
+#include "engraving/dom/system.h"
 
 #include "notation.h"
 #include "notationinteraction.h"
@@ -120,10 +124,67 @@ void NotationPainting::doPaint(draw::Painter* painter, const Options& opt)
     scoreRenderer()->paintScore(painter, score(), myopt);
 
     if (!myopt.isPrinting) {
+        paintPagePlaceholders(painter, myopt.frameRect);
         static_cast<NotationInteraction*>(m_notation->interaction().get())->paint(painter);
     }
 }
 
+//---------------------------------------------------------
+//   paintPagePlaceholders
+//    Empty sheets in place of the pages that are not laid
+//    out yet (see Score::layoutNextPages). Their number is
+//    estimated from the part of the score laid out so far.
+//---------------------------------------------------------
+
+void NotationPainting::paintPagePlaceholders(Painter* painter, const RectF& frameRect) const
+{
+    static constexpr int MAX_PLACEHOLDERS = 1000;
+
+    const std::vector<engraving::Page*>& pages = score()->pages();
+    if (pages.empty() || !isPaintPageBorder() || score()->isLayoutComplete()) {
+        return;
+    }
+
+    const engraving::Page* lastPage = pages.back();
+    if (lastPage->systems().empty()) {
+        return;
+    }
+
+    int laidOutTicks = lastPage->systems().back()->endTick().ticks();
+    int totalTicks = score()->endTick().ticks();
+    if (laidOutTicks <= 0 || totalTicks <= laidOutTicks) {
+        return;
+    }
+
+    int pageCount = static_cast<int>(pages.size());
+    int placeholders = std::clamp(pageCount * (totalTicks - laidOutTicks) / laidOutTicks, 1, MAX_PLACEHOLDERS);
+
+    RectF pageRect = lastPage->layoutData()->bbox();
+    PointF pos = lastPage->pos();
+
+    painter->setPen(Pen(configuration()->borderColor(), configuration()->borderWidth()));
+    painter->setBrush(BrushStyle::NoBrush);
+
+    for (int i = 0; i < placeholders; ++i) {
+        int pageIdx = pageCount + i;
+        if (engraving::MScore::verticalOrientation()) {
+            pos.setY(pos.y() + pageRect.height() + engraving::MScore::verticalPageGap);
+        } else {
+            double gap = (pageIdx + score()->pageNumberOffset()) & 1
+                         ? engraving::MScore::horizontalPageGapOdd : engraving::MScore::horizontalPageGapEven;
+            pos.setX(pos.x() + pageRect.width() + gap);
+        }
+
+        RectF rect = pageRect.translated(pos);
+        if (frameRect.isValid() && !frameRect.intersects(rect)) {
+            continue;
+        }
+
+        painter->fillRect(rect, Color::WHITE);
+        painter->drawRect(rect);
+    }
+}
+
 void NotationPainting::paintPageSheet(Painter* painter, const Page* page, const RectF& pageRect, bool printPageBackground) const
 {
     TRACEFUNC;
@@ -66,6 +66,7 @@ private:
     void doPaint(draw::Painter* painter, const Options& opt);
     void paintPageBorder(draw::Painter* painter, const mu::engraving::Page* page) const;
     void paintPageSheet(mu::draw::Painter* painter, const engraving::Page* page, const RectF& pageRect, bool printPageBackground) const;
+    void paintPagePlaceholders(mu::draw::Painter* painter, const RectF& frameRect) const;
 
     Notation* m_notation = nullptr;
 };
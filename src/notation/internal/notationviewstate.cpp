@@ -79,7 +79,11 @@ NotationViewState::NotationViewState(Notation* notation)
 
 Ret NotationViewState::read(const engraving::MscReader& reader, const io::path_t& pathPrefix)
 {
-    ByteArray json = reader.readViewSettingsJsonFile(pathPrefix);
+    return readJson(reader.readViewSettingsJsonFile(pathPrefix));
+}
+
+Ret NotationViewState::readJson(const ByteArray& json)
+{
     QJsonObject rootObj = QJsonDocument::fromJson(json.toQByteArrayNoCopy()).object();
     QJsonObject notationObj = rootObj.value("notation").toObject();
 
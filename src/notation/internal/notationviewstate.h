@@ -38,6 +38,7 @@ public:
     explicit NotationViewState(Notation* notation);
 
     Ret read(const engraving::MscReader& reader, const io::path_t& pathPrefix = "") override;
+    Ret readJson(const ByteArray& json) override;
     Ret write(engraving::MscWriter& writer, const io::path_t& pathPrefix = "") override;
 
     bool isMatrixInited() const override;
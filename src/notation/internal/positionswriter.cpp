@@ -106,6 +106,9 @@ mu::Ret PositionsWriter::write(INotationPtr notation, QIODevice& destinationDevi
         return make_ret(Ret::Code::UnknownError);
     }
 
+    // the last pages of a just opened score may not be laid out yet
+    score->layoutNextPages(0);
+
     mu::framework::XmlWriter writer(&destinationDevice);
 
     writer.writeStartDocument();
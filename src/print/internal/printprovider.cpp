@@ -24,6 +24,8 @@
 #include <QPrinter>
 #include <QPrintDialog>
 
+#include "engraving/dom/score.h"
+
 #include "log.h"
 
 using namespace mu;
@@ -37,6 +39,9 @@ Ret PrintProvider::printNotation(INotationPtr notation)
         return make_ret(Ret::Code::InternalError);
     }
 
+    // the last pages of a just opened score may not be laid out yet
+    notation->elements()->msScore()->layoutNextPages(0);
+
     auto painting = notation->painting();
 
     SizeF pageSizeInch = painting->pageSizeInch();
@@ -24,6 +24,7 @@
 
 #include <memory>
 
+#include "async/promise.h"
 #include "io/path.h"
 #include "types/ret.h"
 
@@ -66,6 +67,9 @@ public:
     virtual void setNeedAutoSave(bool val) = 0;
 
     virtual Ret save(const io::path_t& path = io::path_t(), SaveMode saveMode = SaveMode::Save) = 0;
+
+    //! NOTE Serializes the project on the calling thread, compresses and writes it to the path on a background thread
+    virtual async::Promise<Ret> autoSaveInBackground(const io::path_t& path) = 0;
     virtual Ret writeToDevice(QIODevice* device) = 0;
 
     virtual ProjectMeta metaInfo() const = 0;
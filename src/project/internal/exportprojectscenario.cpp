@@ -133,6 +133,9 @@ bool ExportProjectScenario::exportScores(const notation::INotationPtrList& notat
         mu::engraving::Score* score = notation->elements()->msScore();
         if (!score->autoLayoutEnabled()) {
             score->doLayout();
+        } else {
+            // the last pages of a just opened score may not be laid out yet
+            score->layoutNextPages(0);
         }
     }
 
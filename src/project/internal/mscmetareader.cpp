@@ -21,9 +21,18 @@
  */
 #include "mscmetareader.h"
 
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <mutex>
+#include <optional>
 #include <sstream>
 
+#include <QFileInfo>
+#include <QUuid>
+
 #include "io/buffer.h"
+#include "serialization/json.h"
 
 #include "stringutils.h"
 #include "global/deprecated/xmlreader.h"
@@ -31,11 +40,35 @@
 
 #include "log.h"
 
+using namespace mu;
 using namespace mu::io;
 using namespace mu::project;
 using namespace mu::framework;
 using namespace mu::engraving;
 
+//! NOTE Keeps the cache bounded, the least recently written entries are removed first
+static constexpr size_t MAX_CACHE_ENTRIES = 4096;
+
+//! NOTE Over the limit, the oldest entries are removed at once down to this count
+static constexpr size_t TRIMMED_CACHE_ENTRIES = MAX_CACHE_ENTRIES * 3 / 4;
+
+//! NOTE The entries of the cache directory, counted when the first entry of the session is written.
+//! Then the written entries are added, so the directory is listed again only to trim it
+static std::mutex s_cacheEntriesCountMutex;
+static std::optional<size_t> s_cacheEntriesCount;
+static const char* CACHE_ENTRY_SUFFIX = ".json";
+
+// FNV-1a
+static uint64_t pathHash(const std::string& path)
+{
+    uint64_t hash = 14695981039346656037ull;
+    for (char c : path) {
+        hash ^= static_cast<uint8_t>(c);
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
 mu::RetVal<ProjectMeta> MscMetaReader::readMeta(const io::path_t& filePath) const
 {
     RetVal<ProjectMeta> meta;
@@ -46,6 +79,28 @@ mu::RetVal<ProjectMeta> MscMetaReader::readMeta(const io::path_t& filePath) cons
         return meta;
     }
 
+    const std::string key = cacheKey(filePath);
+    if (!key.empty() && readCachedMeta(filePath, key, meta.val)) {
+        meta.val.filePath = filePath;
+        return meta;
+    }
+
+    ByteArray thumbnailData;
+    meta = doReadMetaFromFile(filePath, thumbnailData);
+    if (meta.ret && !key.empty()) {
+        writeCachedMeta(filePath, key, meta.val, thumbnailData);
+    }
+
+    return meta;
+}
+
+mu::RetVal<ProjectMeta> MscMetaReader::doReadMetaFromFile(const io::path_t& filePath, ByteArray& thumbnailData) const
+{
+    TRACEFUNC;
+
+    RetVal<ProjectMeta> meta;
+    meta.ret = make_ok();
+
     MscReader::Params params;
     params.filePath = filePath.toQString();
     params.mode = mscIoModeBySuffix(io::suffix(filePath));
@@ -64,7 +119,7 @@ mu::RetVal<ProjectMeta> MscMetaReader::readMeta(const io::path_t& filePath) cons
     doReadMeta(xmlReader, meta.val);
 
     // Read thumbnail
-    ByteArray thumbnailData = msczReader.readThumbnailFile();
+    thumbnailData = msczReader.readThumbnailFile();
     if (thumbnailData.empty()) {
         LOGD() << "Can't find thumbnail";
     } else {
@@ -76,6 +131,156 @@ mu::RetVal<ProjectMeta> MscMetaReader::readMeta(const io::path_t& filePath) cons
     return meta;
 }
 
+std::string MscMetaReader::cacheKey(const io::path_t& filePath) const
+{
+    // MSCX folders are not cached, the time of the folder doesn't follow the files in it
+    if (fileSystem()->entryType(filePath) != io::EntryType::File) {
+        return std::string();
+    }
+
+    RetVal<uint64_t> size = fileSystem()->fileSize(filePath);
+    if (!size.ret) {
+        return std::string();
+    }
+
+    //! NOTE IFileSystem::lastModified() has a resolution of a second,
+    //! a file saved twice within the same second and keeping its size would hit the stale entry
+    const qint64 lastModified = QFileInfo(filePath.toQString()).lastModified().toMSecsSinceEpoch();
+
+    return std::to_string(size.val) + "_" + std::to_string(lastModified);
+}
+
+io::path_t MscMetaReader::cacheEntryPath(const io::path_t& filePath) const
+{
+    const io::path_t cachePath = configuration()->projectMetaCachePath();
+    if (cachePath.empty()) {
+        return io::path_t();
+    }
+
+    char name[32];
+    std::snprintf(name, sizeof(name), "/%016" PRIx64, pathHash(filePath.toStdString()));
+    return cachePath + name + CACHE_ENTRY_SUFFIX;
+}
+
+bool MscMetaReader::readCachedMeta(const io::path_t& filePath, const std::string& key, ProjectMeta& meta) const
+{
+    const io::path_t entryPath = cacheEntryPath(filePath);
+    if (entryPath.empty() || !fileSystem()->exists(entryPath)) {
+        return false;
+    }
+
+    RetVal<ByteArray> data = fileSystem()->readFile(entryPath);
+    if (!data.ret) {
+        return false;
+    }
+
+    JsonObject obj = JsonDocument::fromJson(data.val).rootObject();
+    if (obj.value("path").toStdString() != filePath.toStdString() || obj.value("key").toStdString() != key) {
+        return false;
+    }
+
+    auto qstring = [&obj](const std::string& name) {
+        return obj.value(name).toString().toQString();
+    };
+
+    meta.title = qstring("title");
+    meta.subtitle = qstring("subtitle");
+    meta.composer = qstring("composer");
+    meta.lyricist = qstring("lyricist");
+    meta.copyright = qstring("copyright");
+    meta.translator = qstring("translator");
+    meta.arranger = qstring("arranger");
+    meta.partsCount = static_cast<size_t>(obj.value("partsCount").toInt());
+    meta.creationDate = QDate::fromString(qstring("creationDate"), Qt::ISODate);
+
+    const std::string thumbnail = obj.value("thumbnail").toStdString();
+    if (!thumbnail.empty()) {
+        meta.thumbnail.loadFromData(QByteArray::fromBase64(QByteArray::fromStdString(thumbnail)), "PNG");
+    }
+
+    return true;
+}
+
+void MscMetaReader::writeCachedMeta(const io::path_t& filePath, const std::string& key, const ProjectMeta& meta,
+                                    const ByteArray& thumbnailData) const
+{
+    const io::path_t entryPath = cacheEntryPath(filePath);
+    if (entryPath.empty()) {
+        return;
+    }
+
+    const io::path_t cachePath = io::absoluteDirpath(entryPath);
+    Ret ret = fileSystem()->makePath(cachePath);
+    if (!ret) {
+        LOGW() << "failed make path: " << cachePath << ", err: " << ret.toString();
+        return;
+    }
+
+    JsonObject obj;
+    obj["path"] = filePath.toStdString();
+    obj["key"] = key;
+    obj["title"] = meta.title.toStdString();
+    obj["subtitle"] = meta.subtitle.toStdString();
+    obj["composer"] = meta.composer.toStdString();
+    obj["lyricist"] = meta.lyricist.toStdString();
+    obj["copyright"] = meta.copyright.toStdString();
+    obj["translator"] = meta.translator.toStdString();
+    obj["arranger"] = meta.arranger.toStdString();
+    obj["partsCount"] = static_cast<int>(meta.partsCount);
+    obj["creationDate"] = meta.creationDate.toString(Qt::ISODate).toStdString();
+    obj["thumbnail"] = thumbnailData.toQByteArrayNoCopy().toBase64().toStdString();
+
+    //! NOTE Written aside and moved, so that the entry is never read half written.
+    //! The temporary name is unique, another instance may be writing the same entry
+    const io::path_t tempPath = entryPath + "." + QUuid::createUuid().toString(QUuid::Id128) + ".tmp";
+    ret = fileSystem()->writeFile(tempPath, JsonDocument(obj).toJson(JsonDocument::Format::Compact));
+    if (ret) {
+        ret = fileSystem()->move(tempPath, entryPath, true);
+    }
+
+    if (!ret) {
+        LOGW() << "failed write cache entry: " << entryPath << ", err: " << ret.toString();
+        fileSystem()->remove(tempPath);
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(s_cacheEntriesCountMutex);
+
+    //! NOTE An overwritten entry is counted as a new one, the listing corrects the count
+    if (s_cacheEntriesCount && ++(*s_cacheEntriesCount) <= MAX_CACHE_ENTRIES) {
+        return;
+    }
+
+    RetVal<io::paths_t> entries = fileSystem()->scanFiles(cachePath, { std::string("*") + CACHE_ENTRY_SUFFIX },
+                                                          io::ScanMode::FilesInCurrentDir);
+    if (!entries.ret) {
+        s_cacheEntriesCount.reset();
+        return;
+    }
+
+    if (entries.val.size() <= MAX_CACHE_ENTRIES) {
+        s_cacheEntriesCount = entries.val.size();
+        return;
+    }
+
+    //! NOTE The ISO date strings are sorted as the times are
+    std::vector<std::pair<String, io::path_t> > byTime;
+    byTime.reserve(entries.val.size());
+    for (const io::path_t& entry : entries.val) {
+        byTime.push_back({ fileSystem()->lastModified(entry).toString(), entry });
+    }
+
+    std::sort(byTime.begin(), byTime.end(), [](const auto& a, const auto& b) {
+        return a.first < b.first;
+    });
+
+    for (size_t i = 0; i < byTime.size() - TRIMMED_CACHE_ENTRIES; ++i) {
+        fileSystem()->remove(byTime.at(i).second);
+    }
+
+    s_cacheEntriesCount = TRIMMED_CACHE_ENTRIES;
+}
+
 MscMetaReader::RawMeta MscMetaReader::doReadBox(framework::XmlReader& xmlReader) const
 {
     RawMeta meta;
@@ -169,31 +374,35 @@ MscMetaReader::RawMeta MscMetaReader::doReadRawMeta(framework::XmlReader& xmlRea
                 xmlReader.skipCurrentElement();
             }
         } else if (tag == "Staff") {
-            if (meta.titleStyle.isEmpty()) {
-                while (xmlReader.readNextStartElement()) {
-                    std::string boxTag(xmlReader.tagName());
-
-                    if (boxTag == "HBox"
-                        || boxTag == "VBox"
-                        || boxTag == "TBox"
-                        || boxTag == "FBox") {
-                        RawMeta boxMeta = doReadBox(xmlReader);
-
-                        meta.titleStyle = boxMeta.titleStyle;
-                        meta.titleStyleHtml = boxMeta.titleStyleHtml;
-                        meta.subtitleStyle = boxMeta.subtitleStyle;
-                        meta.subtitleStyleHtml = boxMeta.subtitleStyleHtml;
-                        meta.composerStyle = boxMeta.composerStyle;
-                        meta.composerStyleHtml = boxMeta.composerStyleHtml;
-                        meta.lyricistStyle = boxMeta.lyricistStyle;
-                        meta.lyricistStyleHtml = boxMeta.lyricistStyleHtml;
-                    } else {
-                        xmlReader.skipCurrentElement();
-                    }
+            //! NOTE The meta tags and the parts are written before the staves, and the title frame
+            //! is at the beginning of the first staff, so the rest of the score is not needed
+            bool boxRead = false;
+            while (xmlReader.readNextStartElement()) {
+                std::string boxTag(xmlReader.tagName());
+
+                if (boxTag == "HBox"
+                    || boxTag == "VBox"
+                    || boxTag == "TBox"
+                    || boxTag == "FBox") {
+                    RawMeta boxMeta = doReadBox(xmlReader);
+
+                    meta.titleStyle = boxMeta.titleStyle;
+                    meta.titleStyleHtml = boxMeta.titleStyleHtml;
+                    meta.subtitleStyle = boxMeta.subtitleStyle;
+                    meta.subtitleStyleHtml = boxMeta.subtitleStyleHtml;
+                    meta.composerStyle = boxMeta.composerStyle;
+                    meta.composerStyleHtml = boxMeta.composerStyleHtml;
+                    meta.lyricistStyle = boxMeta.lyricistStyle;
+                    meta.lyricistStyleHtml = boxMeta.lyricistStyleHtml;
+                    boxRead = true;
+                } else if (boxTag == "Measure" && boxRead) {
+                    break;
+                } else {
+                    xmlReader.skipCurrentElement();
                 }
-            } else {
-                xmlReader.skipCurrentElement();
             }
+
+            break;
         } else if (tag == "Part") {
             meta.partsCount++;
             xmlReader.skipCurrentElement();
@@ -220,11 +429,15 @@ void MscMetaReader::doReadMeta(framework::XmlReader& xmlReader, ProjectMeta& met
                 while (xmlReader.readNextStartElement()) {
                     if (xmlReader.tagName() == "Score") {
                         rawMeta = doReadRawMeta(xmlReader);
+                        break;
                     } else {
                         xmlReader.skipCurrentElement();
                     }
                 }
             }
+
+            //! NOTE The reader may be left in the middle of the score, nothing else is needed
+            break;
         } else {
             xmlReader.skipCurrentElement();
         }
@@ -26,6 +26,7 @@
 
 #include "io/ifilesystem.h"
 #include "modularity/ioc.h"
+#include "iprojectconfiguration.h"
 
 namespace mu::framework {
 class XmlReader;
@@ -35,6 +36,7 @@ namespace mu::project {
 class MscMetaReader : public IMscMetaReader
 {
     INJECT(io::IFileSystem, fileSystem)
+    INJECT(IProjectConfiguration, configuration)
 
 public:
     RetVal<ProjectMeta> readMeta(const io::path_t& filePath) const;
@@ -67,6 +69,16 @@ private:
         size_t partsCount = 0;
     };
 
+    RetVal<ProjectMeta> doReadMetaFromFile(const io::path_t& filePath, ByteArray& thumbnailData) const;
+
+    //! NOTE The metadata of project files is cached on disk,
+    //! an entry is valid as long as the modification time and the size of its file are unchanged
+    std::string cacheKey(const io::path_t& filePath) const;
+    io::path_t cacheEntryPath(const io::path_t& filePath) const;
+    bool readCachedMeta(const io::path_t& filePath, const std::string& key, ProjectMeta& meta) const;
+    void writeCachedMeta(const io::path_t& filePath, const std::string& key, const ProjectMeta& meta,
+                         const ByteArray& thumbnailData) const;
+
     void doReadMeta(framework::XmlReader& xmlReader, ProjectMeta& meta) const;
     RawMeta doReadBox(framework::XmlReader& xmlReader) const;
     RawMeta doReadRawMeta(framework::XmlReader& xmlReader) const;
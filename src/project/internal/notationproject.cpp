@@ -24,7 +24,9 @@
 #include <QBuffer>
 #include <QDir>
 #include <QFile>
+#include <QtConcurrent>
 
+#include "async/async.h"
 #include "io/buffer.h"
 
 #include "engraving/dom/undo.h"
@@ -189,7 +191,8 @@ mu::Ret NotationProject::doLoad(const io::path_t& path, const io::path_t& styleP
     m_engravingProject->setFileInfoProvider(std::make_shared<ProjectFileInfoProvider>(this));
 
     SettingsCompat settingsCompat;
-    ret = m_engravingProject->loadMscz(reader, settingsCompat, forceMode);
+    //! NOTE The parts are read when they are first needed, see MasterNotation::excerpts
+    ret = m_engravingProject->loadMscz(reader, settingsCompat, forceMode, true);
     if (!ret) {
         return ret;
     }
@@ -225,9 +228,15 @@ mu::Ret NotationProject::doLoad(const io::path_t& path, const io::path_t& styleP
         m_engravingProject->masterScore()->loadStyle(stylePath.toQString());
     }
 
+    //! NOTE Only the first pages are laid out here, so the score can be shown sooner.
+    //! The setting is not registered outside of the GUI (0), so e.g. the converter lays out everything
+    const int progressiveLayoutPages = configuration()->progressiveLayoutPages();
+
     masterScore->lockUpdates(false);
     masterScore->setLayoutAll();
+    masterScore->setMaxLayoutPages(std::max(progressiveLayoutPages, 0));
     masterScore->update();
+    masterScore->setMaxLayoutPages(0);
 
     // Load audio settings
     ret = m_projectAudioSettings->read(reader);
@@ -258,13 +267,45 @@ mu::Ret NotationProject::doLoad(const io::path_t& path, const io::path_t& styleP
 
     // Load view settings (needs to be done after notations are created)
     m_masterNotation->notation()->viewState()->read(reader);
-    for (IExcerptNotationPtr excerpt : m_masterNotation->excerpts()) {
-        excerpt->notation()->viewState()->read(reader, u"Excerpts/" + excerpt->name() + u"/");
+    if (masterScore->hasDeferredExcerpts()) {
+        //! NOTE The reader is closed before the parts are read, so their view settings are kept until then
+        std::map<String, ByteArray> excerptsViewSettings;
+        for (const String& name : masterScore->deferredExcerptNames()) {
+            excerptsViewSettings[name] = reader.readViewSettingsJsonFile(u"Excerpts/" + name + u"/");
+        }
+        m_masterNotation->setDeferredExcerptsViewSettings(excerptsViewSettings);
+    } else {
+        for (IExcerptNotationPtr excerpt : m_masterNotation->excerpts()) {
+            excerpt->notation()->viewState()->read(reader, u"Excerpts/" + excerpt->name() + u"/");
+        }
+    }
+
+    if (!masterScore->isLayoutComplete()) {
+        layoutRemainingPages();
     }
 
     return make_ret(Ret::Code::Ok);
 }
 
+void NotationProject::layoutRemainingPages()
+{
+    //! NOTE A few pages per event loop iteration, so the score stays responsive meanwhile.
+    //! Edits in between are fine: the layout they trigger continues up to the end of the score
+    async::Async::call(this, [this]() {
+        mu::engraving::MasterScore* masterScore = m_masterNotation ? m_masterNotation->masterScore() : nullptr;
+        if (!masterScore) {
+            return;
+        }
+
+        bool hasMorePages = masterScore->layoutNextPages(std::max(configuration()->progressiveLayoutPages(), 0));
+        m_masterNotation->notation()->notationChanged().notify();
+
+        if (hasMorePages) {
+            layoutRemainingPages();
+        }
+    });
+}
+
 mu::Ret NotationProject::doImport(const io::path_t& path, const io::path_t& stylePath, bool forceMode)
 {
     TRACEFUNC;
@@ -497,20 +538,71 @@ mu::Ret NotationProject::save(const io::path_t& path, SaveMode saveMode)
         return ret;
     }
     case SaveMode::AutoSave:
-        std::string suffix = io::suffix(path);
-        if (suffix == IProjectAutoSaver::AUTOSAVE_SUFFIX) {
-            suffix = io::suffix(io::completeBasename(path));
-        }
+        return saveScore(path, autoSaveSuffix(path), false /*generateBackup*/, false /*createThumbnail*/);
+    }
 
-        if (suffix.empty()) {
-            // Then it must be a MSCX folder
-            suffix = engraving::MSCX;
-        }
+    return make_ret(notation::Err::UnknownError);
+}
 
-        return saveScore(path, suffix, false /*generateBackup*/, false /*createThumbnail*/);
+async::Promise<Ret> NotationProject::autoSaveInBackground(const io::path_t& path)
+{
+    TRACEFUNC;
+
+    std::string suffix = autoSaveSuffix(path);
+    MscIoMode ioMode = mscIoModeBySuffix(suffix);
+
+    if (!isMuseScoreFile(suffix) || ioMode == MscIoMode::Unknown) {
+        Ret ret = saveScore(path, suffix, false /*generateBackup*/, false /*createThumbnail*/);
+        return async::Promise<Ret>([ret](auto resolve, auto) {
+            return resolve(ret);
+        });
     }
 
-    return make_ret(notation::Err::UnknownError);
+    QString targetContainerPath = engraving::containerPath(path).toQString();
+    io::path_t targetMainFilePath = engraving::mainFilePath(path);
+    QString savePath = targetContainerPath + "_saving";
+
+    // Serialize the score on this thread, the files are only collected in memory
+    MscWriter::Params params;
+    params.filePath = savePath;
+    params.mainFileName = engraving::mainFileName(path).toQString();
+    params.mode = ioMode;
+    params.deferred = true;
+    params.previousFilePath = targetContainerPath;
+    params.compressionLevel = configuration()->saveCompressionLevel();
+
+    std::shared_ptr<MscWriter> msczWriter = std::make_shared<MscWriter>(params);
+
+    Ret ret = prepareSave(savePath, targetContainerPath, ioMode);
+    if (ret) {
+        ret = writeProject(*msczWriter, false /*onlySelection*/, false /*createThumbnail*/);
+        msczWriter->close();
+    }
+
+    if (!ret) {
+        LOGE() << "failed write project: " << ret.toString();
+        return async::Promise<Ret>([ret](auto resolve, auto) {
+            return resolve(ret);
+        });
+    }
+
+    // Compress and write the files on a background thread
+    std::shared_ptr<io::IFileSystem> fileSystem = this->fileSystem();
+
+    return async::Promise<Ret>([msczWriter, fileSystem, savePath, targetContainerPath, targetMainFilePath, ioMode](auto resolve, auto) {
+        QtConcurrent::run([msczWriter, fileSystem, savePath, targetContainerPath, targetMainFilePath, ioMode, resolve]() {
+            Ret ret = msczWriter->writeDeferred();
+            if (ret) {
+                ret = replaceContainer(fileSystem.get(), savePath, targetContainerPath, targetMainFilePath, ioMode);
+            } else {
+                LOGE() << "failed write project: " << ret.toString();
+            }
+
+            (void)resolve(ret);
+        });
+
+        return async::Promise<Ret>::Result::unchecked();
+    }, async::Promise<Ret>::AsynchronyType::ProvidedByBody);
 }
 
 mu::Ret NotationProject::writeToDevice(QIODevice* device)
@@ -553,6 +645,21 @@ mu::Ret NotationProject::writeToDevice(QIODevice* device)
     return ret;
 }
 
+std::string NotationProject::autoSaveSuffix(const io::path_t& path)
+{
+    std::string suffix = io::suffix(path);
+    if (suffix == IProjectAutoSaver::AUTOSAVE_SUFFIX) {
+        suffix = io::suffix(io::completeBasename(path));
+    }
+
+    if (suffix.empty()) {
+        // Then it must be a MSCX folder
+        suffix = engraving::MSCX;
+    }
+
+    return suffix;
+}
+
 mu::Ret NotationProject::saveScore(const io::path_t& path, const std::string& fileSuffix, bool generateBackup, bool createThumbnail)
 {
     if (!isMuseScoreFile(fileSuffix) && !fileSuffix.empty()) {
@@ -575,17 +682,9 @@ mu::Ret NotationProject::doSave(const io::path_t& path, engraving::MscIoMode ioM
 
     // Step 1: check writable
     {
-        if (fileSystem()->exists(savePath) && !fileSystem()->isWritable(savePath)) {
-            LOGE() << "failed save, not writable path: " << savePath;
-            return make_ret(notation::Err::UnknownError);
-        }
-
-        if (ioMode == engraving::MscIoMode::Dir) {
-            // Dir needs to be created, otherwise we can't move to it
-            if (!QDir(targetContainerPath).mkpath(".")) {
-                LOGE() << "Couldn't create container directory";
-                return make_ret(notation::Err::UnknownError);
-            }
+        Ret ret = prepareSave(savePath, targetContainerPath, ioMode);
+        if (!ret) {
+            return ret;
         }
     }
 
@@ -595,6 +694,8 @@ mu::Ret NotationProject::doSave(const io::path_t& path, engraving::MscIoMode ioM
         params.filePath = savePath;
         params.mainFileName = targetMainFileName.toQString();
         params.mode = ioMode;
+        params.previousFilePath = targetContainerPath;
+        params.compressionLevel = configuration()->saveCompressionLevel();
         IF_ASSERT_FAILED(params.mode != MscIoMode::Unknown) {
             return make_ret(Ret::Code::InternalError);
         }
@@ -622,36 +723,58 @@ mu::Ret NotationProject::doSave(const io::path_t& path, engraving::MscIoMode ioM
     }
 
     // Step 4: replace to saved file
-    {
-        if (ioMode == MscIoMode::Dir) {
-            RetVal<io::paths_t> filesToBeMoved = fileSystem()->scanFiles(savePath, { "*" }, io::ScanMode::FilesAndFoldersInCurrentDir);
-            if (!filesToBeMoved.ret) {
-                return filesToBeMoved.ret;
-            }
+    return replaceContainer(fileSystem().get(), savePath, targetContainerPath, targetMainFilePath, ioMode);
+}
 
-            Ret ret = make_ok();
+mu::Ret NotationProject::prepareSave(const QString& savePath, const QString& targetContainerPath, engraving::MscIoMode ioMode) const
+{
+    if (fileSystem()->exists(savePath) && !fileSystem()->isWritable(savePath)) {
+        LOGE() << "failed save, not writable path: " << savePath;
+        return make_ret(notation::Err::UnknownError);
+    }
 
-            for (const io::path_t& fileToBeMoved : filesToBeMoved.val) {
-                io::path_t destinationFile
-                    = io::path_t(targetContainerPath).appendingComponent(io::filename(fileToBeMoved));
-                LOGD() << fileToBeMoved << " to " << destinationFile;
-                ret = fileSystem()->move(fileToBeMoved, destinationFile, true);
-                if (!ret) {
-                    return ret;
-                }
-            }
+    if (ioMode == engraving::MscIoMode::Dir) {
+        // Dir needs to be created, otherwise we can't move to it
+        if (!QDir(targetContainerPath).mkpath(".")) {
+            LOGE() << "Couldn't create container directory";
+            return make_ret(notation::Err::UnknownError);
+        }
+    }
 
-            // Try to remove the temp save folder (not problematic if fails)
-            ret = fileSystem()->remove(savePath, true);
-            if (!ret) {
-                LOGW() << ret.toString();
-            }
-        } else {
-            Ret ret = fileSystem()->move(savePath, targetContainerPath, true);
+    return make_ok();
+}
+
+mu::Ret NotationProject::replaceContainer(io::IFileSystem* fileSystem, const QString& savePath, const QString& targetContainerPath,
+                                          const io::path_t& targetMainFilePath, engraving::MscIoMode ioMode)
+{
+    if (ioMode == MscIoMode::Dir) {
+        RetVal<io::paths_t> filesToBeMoved = fileSystem->scanFiles(savePath, { "*" }, io::ScanMode::FilesAndFoldersInCurrentDir);
+        if (!filesToBeMoved.ret) {
+            return filesToBeMoved.ret;
+        }
+
+        Ret ret = make_ok();
+
+        for (const io::path_t& fileToBeMoved : filesToBeMoved.val) {
+            io::path_t destinationFile
+                = io::path_t(targetContainerPath).appendingComponent(io::filename(fileToBeMoved));
+            LOGD() << fileToBeMoved << " to " << destinationFile;
+            ret = fileSystem->move(fileToBeMoved, destinationFile, true);
             if (!ret) {
                 return ret;
             }
         }
+
+        // Try to remove the temp save folder (not problematic if fails)
+        ret = fileSystem->remove(savePath, true);
+        if (!ret) {
+            LOGW() << ret.toString();
+        }
+    } else {
+        Ret ret = fileSystem->move(savePath, targetContainerPath, true);
+        if (!ret) {
+            return ret;
+        }
     }
 
     // make file readable by all
@@ -763,6 +886,7 @@ mu::Ret NotationProject::saveSelectionOnScore(const mu::io::path_t& path)
     MscWriter::Params params;
     params.filePath = path.toQString();
     params.mode = mscIoModeBySuffix(suffix);
+    params.compressionLevel = configuration()->saveCompressionLevel();
     IF_ASSERT_FAILED(params.mode != MscIoMode::Unknown) {
         return make_ret(Ret::Code::InternalError);
     }
@@ -857,8 +981,11 @@ void NotationProject::listenIfNeedSaveChanges()
 
     listenNonUndoStackChanges(m_masterNotation->notation());
 
-    for (const IExcerptNotationPtr& excerpt : m_masterNotation->excerpts()) {
-        listenNonUndoStackChanges(excerpt->notation());
+    //! NOTE Deferred excerpts are listened to when they are read, that notifies excerptsChanged
+    if (!m_masterNotation->masterScore()->hasDeferredExcerpts()) {
+        for (const IExcerptNotationPtr& excerpt : m_masterNotation->excerpts()) {
+            listenNonUndoStackChanges(excerpt->notation());
+        }
     }
 
     m_masterNotation->excerptsChanged().onNotify(this, [this, listenNonUndoStackChanges]() {
@@ -979,7 +1106,8 @@ ProjectMeta NotationProject::metaInfo() const
 
     meta.filePath = m_path;
 
-    meta.partsCount = score->excerpts().size();
+    //! NOTE Counted on the master score, so that the deferred excerpts are not read for it
+    meta.partsCount = score->excerpts().size() + score->deferredExcerptNames().size();
 
     return meta;
 }
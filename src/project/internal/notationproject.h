@@ -87,6 +87,7 @@ public:
     void setNeedAutoSave(bool val) override;
 
     Ret save(const io::path_t& path = io::path_t(), SaveMode saveMode = SaveMode::Save) override;
+    async::Promise<Ret> autoSaveInBackground(const io::path_t& path) override;
     Ret writeToDevice(QIODevice* device) override;
 
     ProjectMeta metaInfo() const override;
@@ -102,11 +103,16 @@ private:
 
     Ret doLoad(const io::path_t& path, const io::path_t& stylePath, bool forceMode, const std::string& format);
     Ret doImport(const io::path_t& path, const io::path_t& stylePath, bool forceMode);
+    void layoutRemainingPages();
 
     Ret saveScore(const io::path_t& path, const std::string& fileSuffix, bool generateBackup = true, bool createThumbnail = true);
     Ret saveSelectionOnScore(const io::path_t& path = io::path_t());
     Ret exportProject(const io::path_t& path, const std::string& suffix);
     Ret doSave(const io::path_t& path, engraving::MscIoMode ioMode, bool generateBackup = true, bool createThumbnail = true);
+    Ret prepareSave(const QString& savePath, const QString& targetContainerPath, engraving::MscIoMode ioMode) const;
+    static Ret replaceContainer(io::IFileSystem* fileSystem, const QString& savePath, const QString& targetContainerPath,
+                                const io::path_t& targetMainFilePath, engraving::MscIoMode ioMode);
+    static std::string autoSaveSuffix(const io::path_t& path);
     Ret makeCurrentFileAsBackup();
     Ret writeProject(engraving::MscWriter& msczWriter, bool onlySelection, bool createThumbnail = true);
 
@@ -150,6 +150,11 @@ void ProjectAutoSaver::onTrySave()
         }
     };
 
+    if (m_isSaving) {
+        LOGD() << "[autosave] previous autosave is still in progress";
+        return;
+    }
+
     INotationProjectPtr project = globalContext()->currentProject();
     if (!project) {
         LOGD() << "[autosave] no project";
@@ -169,15 +174,35 @@ void ProjectAutoSaver::onTrySave()
     io::path_t projectPath = this->projectPath(project);
     io::path_t savePath = project->isNewlyCreated() ? projectPath : projectAutoSavePath(projectPath);
 
-    Ret ret = project->save(savePath, SaveMode::AutoSave);
-    if (!ret) {
-        LOGE() << "[autosave] failed to save project, err: " << ret.toString();
-        return;
-    }
-
+    //! NOTE The score is serialized right away, so the changes made from now on need the next autosave
+    m_isSaving = true;
     project->setNeedAutoSave(false);
 
-    LOGD() << "[autosave] successfully saved project";
+    std::weak_ptr<INotationProject> weakProject = project;
+
+    project->autoSaveInBackground(savePath).onResolve(this, [this, weakProject, projectPath](const Ret& ret) {
+        m_isSaving = false;
+
+        INotationProjectPtr savedProject = weakProject.lock();
+
+        if (!ret) {
+            LOGE() << "[autosave] failed to save project, err: " << ret.toString();
+            if (savedProject) {
+                savedProject->setNeedAutoSave(true);
+            }
+            return;
+        }
+
+        //! NOTE The project could be saved or closed while the autosave was being written
+        if (!savedProject || savedProject != currentProject() || this->projectPath(savedProject) != projectPath
+            || !savedProject->needSave().val) {
+            LOGD() << "[autosave] project changed during autosave, removing it";
+            removeProjectUnsavedChanges(projectPath);
+            return;
+        }
+
+        LOGD() << "[autosave] successfully saved project";
+    });
 }
 
 mu::io::path_t ProjectAutoSaver::projectPath(INotationProjectPtr project) const
@@ -53,6 +53,8 @@ static const Settings::Key PREFERRED_SCORE_CREATION_MODE_KEY(module_name, "proje
 static const Settings::Key MIGRATION_OPTIONS(module_name, "project/migration");
 static const Settings::Key AUTOSAVE_ENABLED_KEY(module_name, "project/autoSaveEnabled");
 static const Settings::Key AUTOSAVE_INTERVAL_KEY(module_name, "project/autoSaveInterval");
+static const Settings::Key PROGRESSIVE_LAYOUT_PAGES_KEY(module_name, "project/progressiveLayoutPages");
+static const Settings::Key SAVE_COMPRESSION_LEVEL_KEY(module_name, "project/saveCompressionLevel");
 static const Settings::Key ALWAYS_PROMPT_SHARE_AUDIO_COM_AFTER_PUBLISH(module_name, "project/promptShareAudioCom");
 static const Settings::Key SHOULD_DESTINATION_FOLDER_BE_OPENED_ON_EXPORT(module_name, "project/shouldDestinationFolderBeOpenedOnExport");
 static const Settings::Key OPEN_DETAILED_PROJECT_UPLOADED_DIALOG(module_name, "project/openDetailedProjectUploadedDialog");
@@ -98,6 +100,9 @@ void ProjectConfiguration::init()
         m_autoSaveIntervalChanged.send(val.toInt());
     });
 
+    settings()->setDefaultValue(PROGRESSIVE_LAYOUT_PAGES_KEY, Val(4));
+    settings()->setDefaultValue(SAVE_COMPRESSION_LEVEL_KEY, Val(-1));
+
     settings()->setDefaultValue(ALWAYS_PROMPT_SHARE_AUDIO_COM_AFTER_PUBLISH, Val(false));
     settings()->valueChanged(ALWAYS_PROMPT_SHARE_AUDIO_COM_AFTER_PUBLISH).onReceive(nullptr, [this](const Val& val) {
         m_promptShareAudioComChanged.send(val.toBool());
@@ -531,6 +536,16 @@ async::Channel<int> ProjectConfiguration::autoSaveIntervalChanged() const
     return m_autoSaveIntervalChanged;
 }
 
+int ProjectConfiguration::progressiveLayoutPages() const
+{
+    return settings()->value(PROGRESSIVE_LAYOUT_PAGES_KEY).toInt();
+}
+
+int ProjectConfiguration::saveCompressionLevel() const
+{
+    return settings()->value(SAVE_COMPRESSION_LEVEL_KEY).toInt();
+}
+
 bool ProjectConfiguration::promptShareAudioCom() const
 {
     return settings()->value(ALWAYS_PROMPT_SHARE_AUDIO_COM_AFTER_PUBLISH).toBool();
@@ -631,6 +646,11 @@ io::path_t ProjectConfiguration::projectBackupPath(const io::path_t& projectPath
     return projectDir + "/.mscbackup/." + projectName + "~";
 }
 
+io::path_t ProjectConfiguration::projectMetaCachePath() const
+{
+    return globalConfiguration()->userAppDataPath() + "/project_meta_cache";
+}
+
 bool ProjectConfiguration::showCloudIsNotAvailableWarning() const
 {
     return settings()->value(SHOW_CLOUD_IS_NOT_AVAILABLE_WARNING).toBool();
@@ -115,6 +115,9 @@ public:
     void setAutoSaveInterval(int minutes) override;
     async::Channel<int> autoSaveIntervalChanged() const override;
 
+    int progressiveLayoutPages() const override;
+    int saveCompressionLevel() const override;
+
     bool promptShareAudioCom() const override;
     void setPromptShareAudioCom(bool prompt) override;
     async::Channel<bool> promptShareAudioComChanged() const override;
@@ -143,6 +146,8 @@ public:
 
     io::path_t projectBackupPath(const io::path_t& projectPath) const override;
 
+    io::path_t projectMetaCachePath() const override;
+
     bool showCloudIsNotAvailableWarning() const override;
     void setShowCloudIsNotAvailableWarning(bool show) override;
 
@@ -119,6 +119,12 @@ public:
     virtual void setAutoSaveInterval(int minutes) = 0;
     virtual async::Channel<int> autoSaveIntervalChanged() const = 0;
 
+    //! NOTE Number of pages laid out before a loaded score is shown, the rest are laid out afterwards; 0 - all
+    virtual int progressiveLayoutPages() const = 0;
+
+    //! NOTE zlib compression level (0-9) of saved score files; -1 - the default level
+    virtual int saveCompressionLevel() const = 0;
+
     virtual bool promptShareAudioCom() const = 0;
     virtual void setPromptShareAudioCom(bool prompt) = 0;
     virtual async::Channel<bool> promptShareAudioComChanged() const = 0;
@@ -148,6 +154,9 @@ public:
 
     virtual io::path_t projectBackupPath(const io::path_t& projectPath) const = 0;
 
+    //! NOTE Directory of the cached metadata of project files, see MscMetaReader
+    virtual io::path_t projectMetaCachePath() const = 0;
+
     virtual bool showCloudIsNotAvailableWarning() const = 0;
     virtual void setShowCloudIsNotAvailableWarning(bool show) = 0;
 };
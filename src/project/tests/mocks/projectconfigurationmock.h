@@ -97,6 +97,9 @@ public:
     MOCK_METHOD(void, setAutoSaveInterval, (int), (override));
     MOCK_METHOD(async::Channel<int>, autoSaveIntervalChanged, (), (const, override));
 
+    MOCK_METHOD(int, progressiveLayoutPages, (), (const, override));
+    MOCK_METHOD(int, saveCompressionLevel, (), (const, override));
+
     MOCK_METHOD(bool, promptShareAudioCom, (), (const, override));
     MOCK_METHOD(void, setPromptShareAudioCom, (bool), (override));
     MOCK_METHOD(async::Channel<bool>, promptShareAudioComChanged, (), (const, override));
@@ -126,6 +129,8 @@ public:
 
     MOCK_METHOD(io::path_t, projectBackupPath, (const io::path_t&), (const, override));
 
+    MOCK_METHOD(io::path_t, projectMetaCachePath, (), (const, override));
+
     MOCK_METHOD(bool, showCloudIsNotAvailableWarning, (), (const, override));
     MOCK_METHOD(void, setShowCloudIsNotAvailableWarning, (bool), (override));
 };
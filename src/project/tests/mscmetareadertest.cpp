@@ -0,0 +1,141 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2023 MuseScore BVBA and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QTemporaryDir>
+
+#include "project/internal/mscmetareader.h"
+
+#include "mocks/projectconfigurationmock.h"
+
+using ::testing::Return;
+
+using namespace mu;
+using namespace mu::project;
+
+class Project_MscMetaReaderTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        ASSERT_TRUE(m_dir.isValid());
+
+        m_reader = std::make_shared<MscMetaReader>();
+        m_configuration = std::make_shared<ProjectConfigurationMock>();
+
+        ON_CALL(*m_configuration, projectMetaCachePath())
+        .WillByDefault(Return(io::path_t(m_dir.filePath("cache"))));
+
+        m_reader->setconfiguration(m_configuration);
+
+        m_scorePath = m_dir.filePath("score.mscx");
+    }
+
+    void writeScore(const QString& title, const QDateTime& lastModified)
+    {
+        QFile file(m_scorePath);
+        ASSERT_TRUE(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+
+        file.write("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+                   "<museScore version=\"4.10\">\n"
+                   "  <Score>\n"
+                   "    <metaTag name=\"workTitle\">" + title.toUtf8() + "</metaTag>\n"
+                   "    <Part/>\n"
+                   "  </Score>\n"
+                   "</museScore>\n");
+
+        file.flush();
+        ASSERT_TRUE(file.setFileTime(lastModified, QFileDevice::FileModificationTime));
+    }
+
+    QString readTitle() const
+    {
+        RetVal<ProjectMeta> meta = m_reader->readMeta(io::path_t(m_scorePath));
+        EXPECT_TRUE(meta.ret);
+        return meta.val.title;
+    }
+
+    QStringList cacheEntries() const
+    {
+        return QDir(m_dir.filePath("cache")).entryList(QDir::Files);
+    }
+
+    QTemporaryDir m_dir;
+    QString m_scorePath;
+
+    //! NOTE A whole second, the changes in the tests stay within it
+    const QDateTime m_lastModified = QDateTime::fromMSecsSinceEpoch(1672531200000);
+
+    std::shared_ptr<MscMetaReader> m_reader;
+    std::shared_ptr<ProjectConfigurationMock> m_configuration;
+};
+
+/**
+ * @brief Project_MscMetaReaderTest_CacheHit
+ * @details The second read of an unchanged file comes from the cache:
+ *          the contents are replaced keeping the size and the modification time, the old title is returned
+ */
+TEST_F(Project_MscMetaReaderTest, CacheHit)
+{
+    writeScore("Title A", m_lastModified);
+    EXPECT_EQ(readTitle(), "Title A");
+
+    //! CHECK One entry is written, no temporary file is left
+    QStringList entries = cacheEntries();
+    ASSERT_EQ(entries.size(), 1);
+    EXPECT_TRUE(entries.first().endsWith(".json"));
+
+    writeScore("Title B", m_lastModified);
+    EXPECT_EQ(readTitle(), "Title A");
+}
+
+/**
+ * @brief Project_MscMetaReaderTest_InvalidatedByModificationTime
+ * @details A file saved again within the same second, with the same size, is read again
+ */
+TEST_F(Project_MscMetaReaderTest, InvalidatedByModificationTime)
+{
+    writeScore("Title A", m_lastModified);
+    EXPECT_EQ(readTitle(), "Title A");
+
+    writeScore("Title B", m_lastModified.addMSecs(1));
+    EXPECT_EQ(readTitle(), "Title B");
+
+    EXPECT_EQ(cacheEntries().size(), 1);
+}
+
+/**
+ * @brief Project_MscMetaReaderTest_InvalidatedBySize
+ * @details A file of another size is read again, even if its modification time is unchanged
+ */
+TEST_F(Project_MscMetaReaderTest, InvalidatedBySize)
+{
+    writeScore("Title A", m_lastModified);
+    EXPECT_EQ(readTitle(), "Title A");
+
+    writeScore("Another title", m_lastModified);
+    EXPECT_EQ(readTitle(), "Another title");
+}
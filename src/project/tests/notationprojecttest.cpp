@@ -0,0 +1,88 @@
+/*
+ * SPDX-License-Identifier: GPL-3.0-only
+ * MuseScore-CLA-applies
+ *
+ * MuseScore
+ * Music Composition & Notation
+ *
+ * Copyright (C) 2023 MuseScore BVBA and others
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <gtest/gtest.h>
+
+#include "project/internal/notationproject.h"
+#include "notation/internal/notationcreator.h"
+#include "engraving/dom/masterscore.h"
+
+#include "mocks/projectconfigurationmock.h"
+
+using ::testing::NiceMock;
+
+using namespace mu;
+using namespace mu::project;
+using namespace mu::notation;
+
+//! NOTE A current version score with one part, Excerpts/Oboe, with its own view settings
+static const io::path_t DEFERRED_PARTS_PATH = io::path_t(project_test_DATA_ROOT) + "/data/deferred_parts/deferred_parts.mscx";
+
+class Project_NotationProjectTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        m_configuration = std::make_shared<NiceMock<ProjectConfigurationMock> >();
+
+        m_project = std::make_shared<NotationProject>();
+        m_project->setconfiguration(m_configuration);
+        m_project->setnotationCreator(std::make_shared<NotationCreator>());
+    }
+
+    std::shared_ptr<NotationProject> m_project;
+    std::shared_ptr<NiceMock<ProjectConfigurationMock> > m_configuration;
+};
+
+/**
+ * @brief Project_NotationProjectTest_LoadKeepsExcerptsDeferred
+ * @details Loading a project, with its view settings, and reading its meta info doesn't read the parts
+ */
+TEST_F(Project_NotationProjectTest, LoadKeepsExcerptsDeferred)
+{
+    ASSERT_TRUE(m_project->load(DEFERRED_PARTS_PATH));
+
+    engraving::MasterScore* masterScore = m_project->masterNotation()->masterScore();
+    EXPECT_TRUE(masterScore->hasDeferredExcerpts());
+    EXPECT_TRUE(masterScore->excerpts().empty());
+
+    EXPECT_EQ(m_project->metaInfo().partsCount, 1);
+    EXPECT_TRUE(masterScore->hasDeferredExcerpts());
+}
+
+/**
+ * @brief Project_NotationProjectTest_DeferredExcerptViewSettings
+ * @details The view settings of a part are applied when it is read on first access
+ */
+TEST_F(Project_NotationProjectTest, DeferredExcerptViewSettings)
+{
+    ASSERT_TRUE(m_project->load(DEFERRED_PARTS_PATH));
+
+    EXPECT_EQ(m_project->masterNotation()->notation()->viewState()->viewMode(), ViewMode::PAGE);
+
+    const ExcerptNotationList& excerpts = m_project->masterNotation()->excerpts();
+    ASSERT_EQ(excerpts.size(), 1);
+    EXPECT_FALSE(m_project->masterNotation()->masterScore()->hasDeferredExcerpts());
+
+    EXPECT_EQ(excerpts.front()->name(), "Oboe");
+    EXPECT_EQ(excerpts.front()->notation()->viewState()->viewMode(), ViewMode::LINE);
+}